@@ -0,0 +1,215 @@
+// tableau-replay.cpp - micro-benchmark of the compact Tableau layout
+//
+// This program replays a pivot log on two arithmetic Tableaus, one with
+// the linked entry layout and one with the compact layout of
+// --arith-compact-tableau, checks that they agree, and reports the time
+// each one took.  The log is in the format of Trace("arith::pivot-log"):
+// record one with a build that has tracing on,
+//
+//   cvc4 --trace arith::pivot-log bench.smt2 \
+//       | grep -E '^(row|pivot|substitute|add|remove) ' > bench.log
+//   tableau-replay bench.log
+//
+// Without a log, it replays a synthetic one: tableau-replay [ROWS VARS PIVOTS]
+//
+// The Tableau is private to libcvc4, so compile against a build tree:
+//
+//   g++ -std=gnu++11 -O2 -D__BUILDING_CVC4LIB_UNIT_TEST \
+//       -I$BUILD/src -I$SRC/src -I$SRC/src/include \
+//       -o tableau-replay contrib/tableau-replay.cpp \
+//       -L$BUILD/src/.libs -lcvc4 -lgmp
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "theory/arith/tableau.h"
+#include "util/rational.h"
+
+using namespace CVC4;
+using namespace CVC4::theory::arith;
+using namespace std;
+
+// Applies one line of a pivot log to t.
+static void replayLine(Tableau& t, const string& line) {
+  NoEffectCCCB noEffect;
+  istringstream in(line);
+  string op;
+  in >> op;
+  if(op == "row") {
+    ArithVar basic;
+    in >> basic;
+    t.increaseSizeTo(basic + 1);
+    vector<ArithVar> variables;
+    vector<Rational> coefficients;
+    ArithVar v;
+    string c;
+    while(in >> v >> c) {
+      t.increaseSizeTo(v + 1);
+      variables.push_back(v);
+      coefficients.push_back(Rational(c));
+    }
+    t.addRow(basic, coefficients, variables);
+  } else if(op == "pivot") {
+    ArithVar oldBasic, newBasic;
+    in >> oldBasic >> newBasic;
+    t.pivot(oldBasic, newBasic, noEffect);
+  } else if(op == "substitute") {
+    ArithVar to, from;
+    string mult;
+    in >> to >> from >> mult;
+    t.substitutePlusTimesConstant(to, from, Rational(mult), noEffect);
+  } else if(op == "add") {
+    ArithVar row, col;
+    string mult;
+    in >> row >> col >> mult;
+    t.increaseSizeTo(col + 1);
+    t.directlyAddToCoefficient(row, col, Rational(mult), noEffect);
+  } else if(op == "remove") {
+    ArithVar basic;
+    in >> basic;
+    t.removeBasicRow(basic);
+  }
+}
+
+// A deterministic generator, so that runs compare
+static uint32_t seed = 42;
+static uint32_t next(uint32_t bound) {
+  seed = seed * 1103515245u + 12345u;
+  return (seed >> 8) % bound;
+}
+
+// Adds a random row for basic over the variables below numVars.
+static void randomRow(Tableau& t, ArithVar basic, ArithVar numVars,
+                      vector<string>& log) {
+  ostringstream line;
+  line << "row " << basic;
+  vector<bool> used(numVars, false);
+  for(unsigned k = 0, K = 2 + next(5); k < K; ++k) {
+    ArithVar v = next(numVars);
+    if(v == basic || used[v] || t.isBasic(v)) {
+      continue;
+    }
+    used[v] = true;
+    int c = int(next(19)) - 9;
+    line << " " << v << " " << (c == 0 ? 1 : c);
+  }
+  log.push_back(line.str());
+  replayLine(t, log.back());
+}
+
+// Builds numRows rows over numVars variables and records numPivots random
+// pivots, with the occasional row removed and added back.
+static vector<string> randomLog(unsigned numRows, unsigned numVars,
+                                unsigned numPivots) {
+  Tableau t;
+  vector<string> log;
+  vector<ArithVar> basics;
+  for(unsigned r = 0; r < numRows; ++r) {
+    basics.push_back(numVars + r);
+    randomRow(t, numVars + r, numVars, log);
+  }
+  for(unsigned p = 0; p < numPivots; ++p) {
+    unsigned which = next(basics.size());
+    ArithVar b = basics[which];
+    if(next(20) == 0) {
+      ostringstream line;
+      line << "remove " << b;
+      log.push_back(line.str());
+      replayLine(t, log.back());
+      randomRow(t, b, numVars, log);
+      continue;
+    }
+    vector<ArithVar> candidates;
+    for(Tableau::RowIterator i = t.basicRowIterator(b); !i.atEnd(); ++i) {
+      if((*i).getColVar() != b) {
+        candidates.push_back((*i).getColVar());
+      }
+    }
+    if(candidates.empty()) {
+      continue;
+    }
+    ArithVar e = candidates[next(candidates.size())];
+    ostringstream line;
+    line << "pivot " << b << " " << e;
+    log.push_back(line.str());
+    replayLine(t, log.back());
+    basics[which] = e;
+  }
+  return log;
+}
+
+// Whether a and b have the same rows, in the same order.
+static bool sameRows(const Tableau& a, const Tableau& b) {
+  if(a.getNumColumns() != b.getNumColumns() || a.size() != b.size()) {
+    return false;
+  }
+  for(Tableau::BasicIterator i = a.beginBasic(); i != a.endBasic(); ++i) {
+    if(!b.isBasic(*i)) {
+      return false;
+    }
+    Tableau::RowIterator ai = a.basicRowIterator(*i);
+    Tableau::RowIterator bi = b.basicRowIterator(*i);
+    for(; !ai.atEnd() && !bi.atEnd(); ++ai, ++bi) {
+      if((*ai).getColVar() != (*bi).getColVar()
+         || (*ai).getCoefficient() != (*bi).getCoefficient()) {
+        return false;
+      }
+    }
+    if(!ai.atEnd() || !bi.atEnd()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  vector<string> log;
+  if(argc == 2) {
+    ifstream in(argv[1]);
+    if(!in) {
+      cerr << "cannot read " << argv[1] << endl;
+      return 1;
+    }
+    string line;
+    while(getline(in, line)) {
+      log.push_back(line);
+    }
+  } else if(argc == 1 || argc == 4) {
+    unsigned rows = argc == 4 ? atoi(argv[1]) : 100;
+    unsigned vars = argc == 4 ? atoi(argv[2]) : 150;
+    unsigned pivots = argc == 4 ? atoi(argv[3]) : 600;
+    log = randomLog(rows, vars, pivots);
+  } else {
+    cerr << "usage: " << argv[0] << " [LOG | ROWS VARS PIVOTS]" << endl;
+    return 1;
+  }
+
+  typedef chrono::steady_clock Clock;
+  Tableau linked, compact;
+  compact.setCompactLayout(true);
+  Clock::time_point start = Clock::now();
+  for(size_t i = 0; i < log.size(); ++i) {
+    replayLine(linked, log[i]);
+  }
+  Clock::time_point mid = Clock::now();
+  for(size_t i = 0; i < log.size(); ++i) {
+    replayLine(compact, log[i]);
+  }
+  Clock::time_point end = Clock::now();
+
+  cout << log.size() << " operations: linked "
+       << chrono::duration<double>(mid - start).count() << "s, compact "
+       << chrono::duration<double>(end - mid).count() << "s ("
+       << compact.getNumCompactions() << " compactions)" << endl;
+  if(!sameRows(linked, compact)) {
+    cerr << "the two layouts disagree" << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -39,6 +39,7 @@ JustificationHeuristic::JustificationHeuristic(CVC4::DecisionEngine* de,
   d_helfulness("decision::jh::helpfulness", 0),
   d_giveup("decision::jh::giveup", 0),
   d_timestat("decision::jh::time"),
+  d_skippedChildren("decision::jh::skippedChildren", 0),
   d_assertions(uc),
   d_iteAssertions(uc),
   d_iteCache(uc),
@@ -48,10 +49,12 @@ JustificationHeuristic::JustificationHeuristic(CVC4::DecisionEngine* de,
   d_curThreshold(0),
   d_childCache(uc),
   d_weightCache(uc),
-  d_startIndexCache(c) {
+  d_startIndexCache(c),
+  d_easyStartIndexCache(c) {
   smtStatisticsRegistry()->registerStat(&d_helfulness);
   smtStatisticsRegistry()->registerStat(&d_giveup);
   smtStatisticsRegistry()->registerStat(&d_timestat);
+  smtStatisticsRegistry()->registerStat(&d_skippedChildren);
   Trace("decision") << "Justification heuristic enabled" << std::endl;
 }
 
@@ -60,6 +63,7 @@ JustificationHeuristic::~JustificationHeuristic()
   smtStatisticsRegistry()->unregisterStat(&d_helfulness);
   smtStatisticsRegistry()->unregisterStat(&d_giveup);
   smtStatisticsRegistry()->unregisterStat(&d_timestat);
+  smtStatisticsRegistry()->unregisterStat(&d_skippedChildren);
 }
 
 CVC4::prop::SatLiteral JustificationHeuristic::getNext(bool &stopSearch)
@@ -562,24 +566,35 @@ JustificationHeuristic::handleAndOrEasy(TNode node, SatValue desiredVal)
 
   int numChildren = node.getNumChildren();
   SatValue desiredValInverted = invertValue(desiredVal);
-  for(int i = 0; i < numChildren; ++i) {
+  int i_st = getStartIndex(d_easyStartIndexCache, node);
+  d_skippedChildren += i_st;
+  // advance the start index past children that already have the wrong value
+  int next = i_st;
+  for(int i = i_st; i < numChildren; ++i) {
     TNode curNode = getChildByWeight(node, i, desiredVal);
     if ( tryGetSatValue(curNode) != desiredValInverted ) {
       SearchResult ret = findSplitterRec(curNode, desiredVal);
       if(ret != DONT_KNOW) {
+        if(next != i_st) saveStartIndex(d_easyStartIndexCache, node, next);
         return ret;
       }
+    } else if(next == i) {
+      next = i + 1;
     }
   }
+  if(next != i_st) saveStartIndex(d_easyStartIndexCache, node, next);
   Assert(d_curThreshold != 0, "handleAndOrEasy: No controlling input found");
   return DONT_KNOW;
 }
 
-int JustificationHeuristic::getStartIndex(TNode node) {
-  return d_startIndexCache[node];
+int JustificationHeuristic::getStartIndex(const StartIndexCache& cache,
+                                          TNode node) {
+  StartIndexCache::const_iterator it = cache.find(node);
+  return it == cache.end() ? 0 : (*it).second;
 }
-void JustificationHeuristic::saveStartIndex(TNode node, int val) {
-  d_startIndexCache[node] = val;
+void JustificationHeuristic::saveStartIndex(StartIndexCache& cache,
+                                            TNode node, int val) {
+  cache[node] = val;
 }
 
 JustificationHeuristic::SearchResult JustificationHeuristic::handleAndOrHard(TNode node,
@@ -589,16 +604,26 @@ JustificationHeuristic::SearchResult JustificationHeuristic::handleAndOrHard(TNo
 
   int numChildren = node.getNumChildren();
   bool noSplitter = true;
-  int i_st = getStartIndex(node);
+  int i_st = getStartIndex(d_startIndexCache, node);
+  d_skippedChildren += i_st;
+  // advance the start index past the justified prefix of the children
+  int next = i_st;
   for(int i = i_st; i < numChildren; ++i) {
     TNode curNode = getChildByWeight(node, i, desiredVal);
     SearchResult ret = findSplitterRec(curNode, desiredVal);
     if (ret == FOUND_SPLITTER) {
-      if(i != i_st) saveStartIndex(node, i);
+      if(next != i_st) saveStartIndex(d_startIndexCache, node, next);
       return FOUND_SPLITTER;
     }
+    if(ret == NO_SPLITTER && next == i) {
+      next = i + 1;
+    }
     noSplitter = noSplitter && (ret == NO_SPLITTER);
   }
+  // once every child is justified, so is the node: no need to keep its index
+  if(!noSplitter && next != i_st) {
+    saveStartIndex(d_startIndexCache, node, next);
+  }
   return noSplitter ? NO_SPLITTER : DONT_KNOW;
 }
 
@@ -59,6 +59,8 @@ class JustificationHeuristic : public ITEDecisionStrategy {
   IntStat d_helfulness;
   IntStat d_giveup;
   TimerStat d_timestat;
+  /** children of and/or nodes skipped thanks to the start indices */
+  IntStat d_skippedChildren;
 
   /**
    * A copy of the assertions that need to be justified
@@ -157,13 +159,24 @@ public:
 
 
   /**
-   * For big and/or nodes, a cache to save starting index into children
-   * for efficiently.
+   * Start indices into the children of and/or nodes (in getChildByWeight
+   * order), advanced when a search passes the node.  For the hard
+   * polarity (AND true, OR false) every child before the index is
+   * justified, for the easy polarity (AND false, OR true) every child
+   * before it has the wrong value.  Both facts only change on
+   * backtracking, so the indices live in the SAT context, and a search
+   * never rescans the settled prefix of a node.
+   *
+   * Nothing moves an index when a literal is assigned (a decision
+   * strategy is not told about individual assignments), so a request
+   * still walks down from the first unjustified assertion; it only skips
+   * the settled children along the way.
    */
   typedef context::CDHashMap<TNode, int, TNodeHashFunction> StartIndexCache;
   StartIndexCache d_startIndexCache;
-  int getStartIndex(TNode node);
-  void saveStartIndex(TNode node, int val);
+  StartIndexCache d_easyStartIndexCache;
+  int getStartIndex(const StartIndexCache& cache, TNode node);
+  void saveStartIndex(StartIndexCache& cache, TNode node, int val);
 
   /* Compute all term-ITEs in a node recursively */
   void computeITEs(TNode n, IteList &l);
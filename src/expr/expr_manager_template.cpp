@@ -95,9 +95,9 @@ ExprManager::ExprManager(const Options& options) :
 
 ExprManager::~ExprManager()
 {
-  NodeManagerScope nms(d_nodeManager);
-
   try {
+    {
+      NodeManagerScope nms(d_nodeManager);
 
 #ifdef CVC4_STATISTICS_ON
     for (unsigned i = 0; i < kind::LAST_KIND; ++ i) {
@@ -115,7 +115,10 @@ ExprManager::~ExprManager()
       }
     }
 #endif
+    }
 
+    // ~NodeManager enters a scope of its own; one entered here would
+    // outlive the NodeManager it restores on exit
     delete d_nodeManager;
     d_nodeManager = NULL;
 
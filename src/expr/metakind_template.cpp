@@ -128,6 +128,16 @@ ${metakind_constDeleters}
 // re-enable the strict-aliasing warning
 # pragma GCC diagnostic warning "-Wstrict-aliasing"
 
+size_t getNodeValueConstantSize(::CVC4::Kind k) {
+  Assert(kind::metaKindOf(k) == kind::metakind::CONSTANT);
+
+  switch(k) {
+${metakind_constSizes}
+  default:
+    Unhandled(k);
+  }
+}
+
 unsigned getLowerBoundForKind(::CVC4::Kind k) {
   static const unsigned lbs[] = {
     0, /* NULL_EXPR */
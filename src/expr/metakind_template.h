@@ -202,6 +202,13 @@ struct NodeValueConstPrinter {
  */
 void deleteNodeValueConstant(::CVC4::expr::NodeValue* nv);
 
+/**
+ * The number of bytes allocated for an (inlined) NodeValue of the
+ * given CONSTANT kind, header included.  The NodeManager needs this to
+ * return the NodeValue's memory to the right allocator size class.
+ */
+size_t getNodeValueConstantSize(::CVC4::Kind k);
+
 unsigned getLowerBoundForKind(::CVC4::Kind k);
 unsigned getUpperBoundForKind(::CVC4::Kind k);
 
@@ -77,7 +77,7 @@
  **         decrement them again on destruction.  The existing
  **         NodeManager pool entry is returned.
  **
- **   1(b). A new heap-allocated NodeValue must be constructed and all
+ **   1(b). A new NodeValue must be allocated by the NodeManager and all
  **         settings and children from d_inlineNv copied into it.
  **         This new NodeValue is put into the NodeManager's pool.
  **         The NodeBuilder is marked as "used" and the number of
@@ -94,11 +94,12 @@
  **         cause any problems.  The existing NodeManager pool entry
  **         is returned.
  **
- **   2(b). The heap-allocated d_nv is "cropped" to the correct size
- **         (based on the number of children it _actually_ has).  d_nv
- **         is repointed to d_inlineNv so that destruction of the
- **         NodeBuilder doesn't cause any problems, and the (old)
- **         value it had is placed into the NodeManager's pool and
+ **   2(b). The heap-allocated d_nv is copied into a NodeValue of the
+ **         correct size (based on the number of children it
+ **         _actually_ has) from the NodeManager's allocator, and
+ **         freed.  d_nv is repointed to d_inlineNv so that
+ **         destruction of the NodeBuilder doesn't cause any problems,
+ **         and the copy is placed into the NodeManager's pool and
  **         returned in a Node wrapper.
  **
  ** NOTE IN 1(b) AND 2(b) THAT we can NOT create Node wrapper
@@ -317,34 +318,6 @@ class NodeBuilder {
    */
   void decrRefCounts();
 
-  /**
-   * Trim d_nv down to the size it needs to be for the number of
-   * children it has.  Used when a Node is extracted from a
-   * NodeBuilder and we want the returned memory not to suffer from
-   * internal fragmentation.  If d_nv was not heap-allocated by this
-   * class, or is already the right size, this function does nothing.
-   *
-   * @throws bad_alloc if the reallocation fails
-   */
-  void crop() {
-    if(__builtin_expect( ( nvIsAllocated() ), false ) &&
-       __builtin_expect( ( d_nvMaxChildren > d_nv->d_nchildren ), true )) {
-      // Ensure d_nv is not modified on allocation failure
-      expr::NodeValue* newBlock = (expr::NodeValue*)
-        std::realloc(d_nv,
-                     sizeof(expr::NodeValue) +
-                     ( sizeof(expr::NodeValue*) * d_nv->d_nchildren ));
-      if(newBlock == NULL) {
-        // In this case, d_nv was NOT freed.  If we throw, the
-        // deallocation should occur on destruction of the
-        // NodeBuilder.
-        throw std::bad_alloc();
-      }
-      d_nv = newBlock;
-      d_nvMaxChildren = d_nv->d_nchildren;
-    }
-  }
-
   // used by convenience node builders
   NodeBuilder<nchild_thresh>& collapseTo(Kind k) {
     AssertArgument(k != kind::UNDEFINED_KIND &&
@@ -937,16 +910,12 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() {
             "no children permitted" );
 
     // we have to copy the inline NodeValue out
-    expr::NodeValue* nv = (expr::NodeValue*)
-      std::malloc(sizeof(expr::NodeValue));
-    if(nv == NULL) {
-      throw std::bad_alloc();
-    }
+    expr::NodeValue* nv = d_nm->allocateNodeValue(0);
     // there are no children, so we don't have to worry about
     // reference counts in this case.
     nv->d_nchildren = 0;
     nv->d_kind = d_nv->d_kind;
-    nv->d_id = d_nm->next_id++;// FIXME multithreading
+    nv->d_id = d_nm->next_id++;
     nv->d_rc = 0;
     setUsed();
     if(Debug.isOn("gc")) {
@@ -1025,15 +994,10 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() {
        * reference count. */
 
       // create the canonical expression value for this node
-      expr::NodeValue* nv = (expr::NodeValue*)
-        std::malloc(sizeof(expr::NodeValue) +
-                    ( sizeof(expr::NodeValue*) * d_inlineNv.d_nchildren ));
-      if(nv == NULL) {
-        throw std::bad_alloc();
-      }
+      expr::NodeValue* nv = d_nm->allocateNodeValue(d_inlineNv.d_nchildren);
       nv->d_nchildren = d_inlineNv.d_nchildren;
       nv->d_kind = d_inlineNv.d_kind;
-      nv->d_id = d_nm->next_id++;// FIXME multithreading
+      nv->d_id = d_nm->next_id++;
       nv->d_rc = 0;
 
       std::copy(d_inlineNv.d_children,
@@ -1043,8 +1007,10 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() {
       d_inlineNv.d_nchildren = 0;
       setUsed();
 
-      //poolNv = nv;
-      d_nm->poolInsert(nv);
+      poolNv = d_nm->poolInsert(nv);
+      if(poolNv != nv) {
+        return poolNv;
+      }
       if(Debug.isOn("gc")) {
         Debug("gc") << "creating node value " << nv
                     << " [" << nv->d_id << "]: ";
@@ -1078,22 +1044,34 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() {
       /* Subcase (b) The Node under construction is NOT already in the
        * NodeManager's pool. */
 
-      /* 2(b). The heap-allocated d_nv is "cropped" to the correct
-       * size (based on the number of children it _actually_ has).
-       * d_nv is repointed to d_inlineNv so that destruction of the
-       * NodeBuilder doesn't cause any problems, and the (old) value
-       * it had is placed into the NodeManager's pool and returned in
-       * a Node wrapper. */
+      /* 2(b). The heap-allocated d_nv is copied into a NodeValue of
+       * the correct size (based on the number of children it
+       * _actually_ has) obtained from the NodeManager's allocator,
+       * which takes over the child reference counts.  d_nv is freed
+       * and repointed to d_inlineNv so that destruction of the
+       * NodeBuilder doesn't cause any problems, and the copy is
+       * placed into the NodeManager's pool and returned in a Node
+       * wrapper. */
+
+      expr::NodeValue* nv = d_nm->allocateNodeValue(d_nv->d_nchildren);
+      nv->d_nchildren = d_nv->d_nchildren;
+      nv->d_kind = d_nv->d_kind;
+      nv->d_id = d_nm->next_id++;
+      nv->d_rc = 0;
+
+      std::copy(d_nv->d_children,
+                d_nv->d_children + d_nv->d_nchildren,
+                nv->d_children);
 
-      crop();
-      expr::NodeValue* nv = d_nv;
-      nv->d_id = d_nm->next_id++;// FIXME multithreading
+      free(d_nv);
       d_nv = &d_inlineNv;
       d_nvMaxChildren = nchild_thresh;
       setUsed();
 
-      //poolNv = nv;
-      d_nm->poolInsert(nv);
+      poolNv = d_nm->poolInsert(nv);
+      if(poolNv != nv) {
+        return poolNv;
+      }
       Debug("gc") << "creating node value " << nv
                   << " [" << nv->d_id << "]: " << *nv << "\n";
       return nv;
@@ -1127,16 +1105,12 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() const {
             "no children permitted" );
 
     // we have to copy the inline NodeValue out
-    expr::NodeValue* nv = (expr::NodeValue*)
-      std::malloc(sizeof(expr::NodeValue));
-    if(nv == NULL) {
-      throw std::bad_alloc();
-    }
+    expr::NodeValue* nv = d_nm->allocateNodeValue(0);
     // there are no children, so we don't have to worry about
     // reference counts in this case.
     nv->d_nchildren = 0;
     nv->d_kind = d_nv->d_kind;
-    nv->d_id = d_nm->next_id++;// FIXME multithreading
+    nv->d_id = d_nm->next_id++;
     nv->d_rc = 0;
     Debug("gc") << "creating node value " << nv
                 << " [" << nv->d_id << "]: " << *nv << "\n";
@@ -1204,15 +1178,10 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() const {
        * count. */
 
       // create the canonical expression value for this node
-      expr::NodeValue* nv = (expr::NodeValue*)
-        std::malloc(sizeof(expr::NodeValue) +
-                    ( sizeof(expr::NodeValue*) * d_inlineNv.d_nchildren ));
-      if(nv == NULL) {
-        throw std::bad_alloc();
-      }
+      expr::NodeValue* nv = d_nm->allocateNodeValue(d_inlineNv.d_nchildren);
       nv->d_nchildren = d_inlineNv.d_nchildren;
       nv->d_kind = d_inlineNv.d_kind;
-      nv->d_id = d_nm->next_id++;// FIXME multithreading
+      nv->d_id = d_nm->next_id++;
       nv->d_rc = 0;
 
       std::copy(d_inlineNv.d_children,
@@ -1225,8 +1194,10 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() const {
         (*i)->inc();
       }
 
-      //poolNv = nv;
-      d_nm->poolInsert(nv);
+      poolNv = d_nm->poolInsert(nv);
+      if(poolNv != nv) {
+        return poolNv;
+      }
       Debug("gc") << "creating node value " << nv
                   << " [" << nv->d_id << "]: " << *nv << "\n";
       return nv;
@@ -1258,15 +1229,10 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() const {
        * decremented to match at NodeBuilder destruction time. */
 
       // create the canonical expression value for this node
-      expr::NodeValue* nv = (expr::NodeValue*)
-        std::malloc(sizeof(expr::NodeValue) +
-                    ( sizeof(expr::NodeValue*) * d_nv->d_nchildren ));
-      if(nv == NULL) {
-        throw std::bad_alloc();
-      }
+      expr::NodeValue* nv = d_nm->allocateNodeValue(d_nv->d_nchildren);
       nv->d_nchildren = d_nv->d_nchildren;
       nv->d_kind = d_nv->d_kind;
-      nv->d_id = d_nm->next_id++;// FIXME multithreading
+      nv->d_id = d_nm->next_id++;
       nv->d_rc = 0;
 
       std::copy(d_nv->d_children,
@@ -1279,8 +1245,10 @@ expr::NodeValue* NodeBuilder<nchild_thresh>::constructNV() const {
         (*i)->inc();
       }
 
-      //poolNv = nv;
-      d_nm->poolInsert(nv);
+      poolNv = d_nm->poolInsert(nv);
+      if(poolNv != nv) {
+        return poolNv;
+      }
       Debug("gc") << "creating node value " << nv
                   << " [" << nv->d_id << "]: " << *nv << "\n";
       return nv;
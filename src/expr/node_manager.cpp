@@ -27,6 +27,7 @@
 #include "expr/node_manager_attributes.h"
 #include "expr/node_manager_listeners.h"
 #include "expr/type_checker.h"
+#include "options/expr_options.h"
 #include "options/options.h"
 #include "options/smt_options.h"
 #include "util/statistics_registry.h"
@@ -38,6 +39,9 @@ using namespace CVC4::expr;
 namespace CVC4 {
 
 CVC4_THREAD_LOCAL NodeManager* NodeManager::s_current = NULL;
+#if defined(CVC4_ASSERTIONS) && defined(CVC4_PORTFOLIO)
+CVC4_THREAD_LOCAL bool NodeManager::s_readOnly = false;
+#endif /* CVC4_ASSERTIONS && CVC4_PORTFOLIO */
 
 namespace {
 
@@ -83,6 +87,43 @@ struct NVReclaim {
 
 } // namespace
 
+/** Statistics on zombie reclamation pauses. */
+class NodeManager::GCStatistics {
+ public:
+  /** Total time spent in reclaimZombies() */
+  TimerStat d_pauseTime;
+  /** Number of calls to reclaimZombies() */
+  IntStat d_pauses;
+  /** Number of NodeValues freed */
+  IntStat d_reclaimed;
+  /** The most NodeValues freed in a single pause */
+  IntStat d_maxReclaimedPerPause;
+
+  GCStatistics(StatisticsRegistry* registry)
+      : d_pauseTime("expr::NodeManager::gcPauseTime"),
+        d_pauses("expr::NodeManager::gcPauses", 0),
+        d_reclaimed("expr::NodeManager::gcReclaimed", 0),
+        d_maxReclaimedPerPause("expr::NodeManager::gcMaxReclaimedPerPause", 0),
+        d_registry(registry)
+  {
+    d_registry->registerStat(&d_pauseTime);
+    d_registry->registerStat(&d_pauses);
+    d_registry->registerStat(&d_reclaimed);
+    d_registry->registerStat(&d_maxReclaimedPerPause);
+  }
+
+  ~GCStatistics()
+  {
+    d_registry->unregisterStat(&d_pauseTime);
+    d_registry->unregisterStat(&d_pauses);
+    d_registry->unregisterStat(&d_reclaimed);
+    d_registry->unregisterStat(&d_maxReclaimedPerPause);
+  }
+
+ private:
+  StatisticsRegistry* d_registry;
+};/* class NodeManager::GCStatistics */
+
 namespace attr {
   struct LambdaBoundVarListTag { };
 }/* CVC4::attr namespace */
@@ -95,11 +136,14 @@ NodeManager::NodeManager(ExprManager* exprManager) :
   d_statisticsRegistry(new StatisticsRegistry()),
   d_resourceManager(new ResourceManager()),
   d_registrations(new ListenerRegistrationList()),
+  d_nvAllocator(NULL),
   next_id(0),
   d_attrManager(new expr::attr::AttributeManager()),
   d_exprManager(exprManager),
   d_nodeUnderDeletion(NULL),
   d_inReclaimZombies(false),
+  d_gcIncrementalBudget(0),
+  d_gcStatistics(NULL),
   d_abstractValueCount(0),
   d_skolemCounter(0) {
   init();
@@ -111,11 +155,14 @@ NodeManager::NodeManager(ExprManager* exprManager,
   d_statisticsRegistry(new StatisticsRegistry()),
   d_resourceManager(new ResourceManager()),
   d_registrations(new ListenerRegistrationList()),
+  d_nvAllocator(NULL),
   next_id(0),
   d_attrManager(new expr::attr::AttributeManager()),
   d_exprManager(exprManager),
   d_nodeUnderDeletion(NULL),
   d_inReclaimZombies(false),
+  d_gcIncrementalBudget(0),
+  d_gcStatistics(NULL),
   d_abstractValueCount(0),
   d_skolemCounter(0)
 {
@@ -124,8 +171,15 @@ NodeManager::NodeManager(ExprManager* exprManager,
 }
 
 void NodeManager::init() {
+#if defined(CVC4_ASSERTIONS) && defined(CVC4_PORTFOLIO)
+  d_owner = std::thread::id();
+#endif /* CVC4_ASSERTIONS && CVC4_PORTFOLIO */
+  d_nvAllocator = new expr::NodeValueAllocator(d_statisticsRegistry);
   poolInsert( &expr::NodeValue::null() );
 
+  d_gcStatistics = new GCStatistics(d_statisticsRegistry);
+  d_gcIncrementalBudget = (*d_options)[options::gcIncrementalBudget];
+
   for(unsigned i = 0; i < unsigned(kind::LAST_KIND); ++i) {
     Kind k = Kind(i);
 
@@ -159,6 +213,11 @@ void NodeManager::init() {
       new RlimitListener(d_resourceManager), false));
   d_registrations->add(d_options->registerRlimitPerListener(
       new RlimitPerListener(d_resourceManager), false));
+
+  if(d_gcIncrementalBudget > 0) {
+    d_registrations->add(d_resourceManager->registerSafePointListener(
+        new ZombieReclaimListener(this)));
+  }
 }
 
 NodeManager::~NodeManager() {
@@ -221,8 +280,10 @@ NodeManager::~NodeManager() {
 
   if(Debug.isOn("gc:leaks")) {
     Debug("gc:leaks") << "still in pool:" << endl;
-    for(NodeValuePool::const_iterator i = d_nodeValuePool.begin(),
-          iend = d_nodeValuePool.end();
+    vector<NodeValue*> inPool;
+    d_nodeValuePool.getAll(inPool);
+    for(vector<NodeValue*>::const_iterator i = inPool.begin(),
+          iend = inPool.end();
         i != iend;
         ++i) {
       Debug("gc:leaks") << "  " << *i
@@ -234,6 +295,10 @@ NodeManager::~NodeManager() {
   }
 
   // defensive coding, in case destruction-order issues pop up (they often do)
+  delete d_gcStatistics;
+  d_gcStatistics = NULL;
+  delete d_nvAllocator;
+  d_nvAllocator = NULL;
   delete d_statisticsRegistry;
   d_statisticsRegistry = NULL;
   delete d_registrations;
@@ -257,11 +322,11 @@ const Datatype & NodeManager::getDatatypeForIndex( unsigned index ) const{
   return *d_ownedDatatypes[index];
 }
 
-void NodeManager::reclaimZombies() {
-  // FIXME multithreading
+void NodeManager::reclaimZombies(size_t budget) {
   Assert(!d_attrManager->inGarbageCollection());
 
-  Debug("gc") << "reclaiming " << d_zombies.size() << " zombie(s)!\n";
+  Debug("gc") << "reclaiming " << d_zombies.size() << " zombie(s)"
+              << (budget == 0 ? "" : " incrementally") << "!\n";
 
   // during reclamation, reclaimZombies() is never supposed to be called
   Assert(! d_inReclaimZombies, "NodeManager::reclaimZombies() not re-entrant!");
@@ -282,14 +347,36 @@ void NodeManager::reclaimZombies() {
   // concurrently process d_zombies in the loop below, such addition
   // may be invisible to us (B is leaked) or even invalidate our
   // iterator, causing a crash.  So we need to copy the set away.
+  //
+  // With a nonzero budget, only that many zombies are taken out of
+  // d_zombies; the rest wait for a later (incremental) pass.
+
+  TimerStat::CodeTimer pauseTimer(d_gcStatistics->d_pauseTime);
+  ++d_gcStatistics->d_pauses;
 
   vector<NodeValue*> zombies;
-  zombies.reserve(d_zombies.size());
-  remove_copy_if(d_zombies.begin(),
-                 d_zombies.end(),
-                 back_inserter(zombies),
-                 NodeValueReferenceCountNonZero());
-  d_zombies.clear();
+  {
+    expr::NodeValuePoolLock guard(d_zombiesLock);
+    if(budget == 0 || budget >= d_zombies.size()) {
+      zombies.reserve(d_zombies.size());
+      remove_copy_if(d_zombies.begin(),
+                     d_zombies.end(),
+                     back_inserter(zombies),
+                     NodeValueReferenceCountNonZero());
+      d_zombies.clear();
+    } else {
+      zombies.reserve(budget);
+      NodeValueIDSet::iterator i = d_zombies.begin();
+      while(i != d_zombies.end() && zombies.size() < budget) {
+        if(!NodeValueReferenceCountNonZero()(*i)) {
+          zombies.push_back(*i);
+        }
+        i = d_zombies.erase(i);
+      }
+    }
+  }
+  d_gcStatistics->d_reclaimed += zombies.size();
+  d_gcStatistics->d_maxReclaimedPerPause.maxAssign(zombies.size());
 
 #ifdef _LIBCPP_VERSION
   NodeValue* last = NULL;
@@ -355,11 +442,29 @@ void NodeManager::reclaimZombies() {
         // type for a constant payload.)
         kind::metakind::deleteNodeValueConstant(nv);
       }
-      free(nv);
+      deallocateNodeValue(nv);
     }
   }
 }/* NodeManager::reclaimZombies() */
 
+void NodeManager::deallocateNodeValue(NodeValue* nv) {
+  // Constants are always inlined in pooled NodeValues, so their size
+  // depends on the payload type rather than on d_nchildren.
+  size_t size = nv->getMetaKind() == kind::metakind::CONSTANT
+      ? kind::metakind::getNodeValueConstantSize(nv->getKind())
+      : sizeof(NodeValue) + sizeof(NodeValue*) * nv->d_nchildren;
+  d_nvAllocator->deallocate(nv, size);
+}
+
+void NodeManager::discardNodeValue(NodeValue* nv) {
+  Assert(nv->d_rc == 0);
+  nv->decrRefCounts();
+  if(nv->getMetaKind() == kind::metakind::CONSTANT) {
+    kind::metakind::deleteNodeValueConstant(nv);
+  }
+  deallocateNodeValue(nv);
+}
+
 std::vector<NodeValue*> NodeManager::TopologicalSort(
     const std::vector<NodeValue*>& roots) {
   std::vector<NodeValue*> order;
@@ -583,6 +688,20 @@ void NodeManager::reclaimAllZombies(){
   reclaimZombiesUntil(0u);
 }
 
+void NodeManager::reclaimZombiesIncrementally() {
+  if(d_gcIncrementalBudget == 0 || !safeToReclaimZombies()) {
+    return;
+  }
+  bool empty;
+  {
+    expr::NodeValuePoolLock guard(d_zombiesLock);
+    empty = d_zombies.empty();
+  }
+  if(!empty) {
+    reclaimZombies(d_gcIncrementalBudget);
+  }
+}
+
 /** Reclaim zombies while there are more than k nodes in the pool (if possible).*/
 void NodeManager::reclaimZombiesUntil(uint32_t k){
   if(safeToReclaimZombies()){
@@ -32,10 +32,17 @@
 #include <string>
 #include <unordered_set>
 
+#if defined(CVC4_ASSERTIONS) && defined(CVC4_PORTFOLIO)
+#  include <atomic>
+#  include <thread>
+#endif /* CVC4_ASSERTIONS && CVC4_PORTFOLIO */
+
 #include "base/tls.h"
 #include "expr/kind.h"
 #include "expr/metakind.h"
 #include "expr/node_value.h"
+#include "expr/node_value_allocator.h"
+#include "expr/node_value_pool.h"
 #include "options/options.h"
 
 namespace CVC4 {
@@ -94,15 +101,26 @@ class NodeManager {
     bool operator()(expr::NodeValue* nv) { return nv->d_rc > 0; }
   };
 
-  typedef std::unordered_set<expr::NodeValue*,
-                             expr::NodeValuePoolHashFunction,
-                             expr::NodeValuePoolEq> NodeValuePool;
+  typedef expr::ShardedNodeValuePool<expr::NodeValuePoolHashFunction,
+                                     expr::NodeValuePoolEq> NodeValuePool;
   typedef std::unordered_set<expr::NodeValue*,
                              expr::NodeValueIDHashFunction,
                              expr::NodeValueIDEquality> NodeValueIDSet;
 
   static CVC4_THREAD_LOCAL NodeManager* s_current;
 
+#if defined(CVC4_ASSERTIONS) && defined(CVC4_PORTFOLIO)
+  /**
+   * The thread of the innermost NodeManagerScope on this NodeManager.
+   * Reference counts are not atomic, so only that thread may change the
+   * counts of this NodeManager's nodes (see assertRefCountOwner()).
+   */
+  std::atomic<std::thread::id> d_owner;
+
+  /** Whether the calling thread may only read nodes, see ReadOnlyScope */
+  static CVC4_THREAD_LOCAL bool s_readOnly;
+#endif /* CVC4_ASSERTIONS && CVC4_PORTFOLIO */
+
   Options* d_options;
   StatisticsRegistry* d_statisticsRegistry;
 
@@ -116,7 +134,10 @@ class NodeManager {
 
   NodeValuePool d_nodeValuePool;
 
-  size_t next_id;
+  /** The allocator backing every NodeValue in d_nodeValuePool. */
+  expr::NodeValueAllocator* d_nvAllocator;
+
+  expr::NodeValueIdCounter next_id;
 
   expr::attr::AttributeManager* d_attrManager;
 
@@ -151,6 +172,19 @@ class NodeManager {
    */
   NodeValueIDSet d_zombies;
 
+  /** Guards d_zombies (a no-op in single-threaded builds). */
+  expr::NodeValuePoolMutex d_zombiesLock;
+
+  /**
+   * The maximum number of zombies freed by one reclamation pass, or 0
+   * to free all of them at once.  See --gc-incremental-budget.
+   */
+  unsigned d_gcIncrementalBudget;
+
+  /** Statistics on zombie reclamation pauses. */
+  class GCStatistics;
+  GCStatistics* d_gcStatistics;
+
   /**
    * NodeValues with maxed out reference counts. These live as long as the
    * NodeManager. They have a custom deallocation procedure at the very end.
@@ -240,12 +274,15 @@ class NodeManager {
   inline expr::NodeValue* poolLookup(expr::NodeValue* nv) const;
 
   /**
-   * Insert a NodeValue into the NodeManager's pool.
+   * Insert a fully-constructed NodeValue into the NodeManager's pool,
+   * unless an equal one is already there, and return the pooled one.
    *
-   * It is an error to insert a NodeValue already in the pool.
-   * Enquire first with poolLookup().
+   * Enquire first with poolLookup().  Between that lookup and this
+   * insertion another thread may have pooled the same term; then nv
+   * is discarded (see discardNodeValue()) and the NodeValue already in
+   * the pool is returned in its place, so callers must use the result.
    */
-  inline void poolInsert(expr::NodeValue* nv);
+  inline expr::NodeValue* poolInsert(expr::NodeValue* nv);
 
   /**
    * Remove a NodeValue from the NodeManager's pool.
@@ -255,6 +292,31 @@ class NodeManager {
    */
   inline void poolRemove(expr::NodeValue* nv);
 
+  /**
+   * Allocate an uninitialized NodeValue with room for nchildren
+   * children from this NodeManager's allocator.
+   *
+   * @throws bad_alloc if the memory cannot be obtained
+   */
+  inline expr::NodeValue* allocateNodeValue(size_t nchildren) {
+    return static_cast<expr::NodeValue*>(d_nvAllocator->allocate(
+        sizeof(expr::NodeValue) + sizeof(expr::NodeValue*) * nchildren));
+  }
+
+  /**
+   * Return a NodeValue (that is not in the pool anymore, and whose
+   * children and constant payload have been released) to this
+   * NodeManager's allocator.
+   */
+  void deallocateNodeValue(expr::NodeValue* nv);
+
+  /**
+   * Release a fully-constructed NodeValue that never made it into the
+   * pool: drop the references it holds on its children, destroy its
+   * constant payload and return it to the allocator.
+   */
+  void discardNodeValue(expr::NodeValue* nv);
+
   /**
    * Determine if nv is currently being deleted by the NodeManager.
    */
@@ -277,11 +339,16 @@ class NodeManager {
       Debug("gc") << (d_inReclaimZombies ? " [CURRENTLY-RECLAIMING]" : "")
                   << std::endl;
     }
-    d_zombies.insert(nv);  // FIXME multithreading
+    size_t numZombies;
+    {
+      expr::NodeValuePoolLock guard(d_zombiesLock);
+      d_zombies.insert(nv);
+      numZombies = d_zombies.size();
+    }
 
     if(safeToReclaimZombies()) {
-      if(d_zombies.size() > 5000) {
-        reclaimZombies();
+      if(numZombies > 5000) {
+        reclaimZombies(d_gcIncrementalBudget);
       }
     }
   }
@@ -300,9 +367,11 @@ class NodeManager {
   }
 
   /**
-   * Reclaim all zombies.
+   * Reclaim zombies.  At most budget zombies are freed, unless budget
+   * is 0, in which case all of them are.  Zombies created by freeing
+   * others are left for a later pass.
    */
-  void reclaimZombies();
+  void reclaimZombies(size_t budget = 0);
 
   /**
    * It is safe to collect zombies.
@@ -377,6 +446,34 @@ public:
 
   /** The node manager in the current public-facing CVC4 library context */
   static NodeManager* currentNM() { return s_current; }
+
+  /**
+   * In debug builds with thread support, asserts that the calling thread
+   * may change reference counts: it is not inside a ReadOnlyScope, and
+   * no other thread has entered a NodeManagerScope on the current node
+   * manager since this one did.  Nodes cannot be shared across threads.
+   */
+  static inline void assertRefCountOwner();
+
+  /**
+   * Marks the calling thread, for the lifetime of this object, as one
+   * that only reads nodes through TNodes, such as the workers of
+   * AssertionPipeline::scanAssertions().  Changing a reference count on
+   * it fails assertRefCountOwner().
+   */
+  class ReadOnlyScope {
+  public:
+    ReadOnlyScope() {
+#if defined(CVC4_ASSERTIONS) && defined(CVC4_PORTFOLIO)
+      s_readOnly = true;
+#endif /* CVC4_ASSERTIONS && CVC4_PORTFOLIO */
+    }
+    ~ReadOnlyScope() {
+#if defined(CVC4_ASSERTIONS) && defined(CVC4_PORTFOLIO)
+      s_readOnly = false;
+#endif /* CVC4_ASSERTIONS && CVC4_PORTFOLIO */
+    }
+  };/* class NodeManager::ReadOnlyScope */
   /** The resource manager associated with the current node manager */
   static ResourceManager* currentResourceManager() { return s_current->d_resourceManager; }
 
@@ -941,9 +1038,20 @@ public:
   /** Reclaims all zombies (if possible).*/
   void reclaimAllZombies();
 
+  /**
+   * Frees a bounded number of zombies (if possible) when incremental
+   * reclamation is enabled with --gc-incremental-budget.  This is
+   * called at resource-spending safe points so that the cost of
+   * reclamation is spread over the run rather than paid in bursts.
+   */
+  void reclaimZombiesIncrementally();
+
   /** Size of the node pool. */
   size_t poolSize() const;
 
+  /** An upper bound on the ids of all nodes built so far. */
+  size_t maxNodeId() const { return next_id; }
+
   /** Deletes a list of attributes from the NM's AttributeManager.*/
   void deleteAttributes(const std::vector< const expr::attr::AttributeUniqueId* >& ids);
 
@@ -982,6 +1090,11 @@ class NodeManagerScope {
   /** The old NodeManager, to be restored on destruction. */
   NodeManager* d_oldNodeManager;
   Options::OptionsScope d_optionsScope;
+#if defined(CVC4_ASSERTIONS) && defined(CVC4_PORTFOLIO)
+  /** The NodeManager of this scope and its owner before it */
+  NodeManager* d_nodeManager;
+  std::thread::id d_oldOwner;
+#endif /* CVC4_ASSERTIONS && CVC4_PORTFOLIO */
 public:
 
   NodeManagerScope(NodeManager* nm)
@@ -992,12 +1105,24 @@ public:
     // Expr is destructed, there's no active node manager.
     //Assert(nm != NULL);
     NodeManager::s_current = nm;
+#if defined(CVC4_ASSERTIONS) && defined(CVC4_PORTFOLIO)
+    // The calling thread takes the NodeManager over until the scope ends
+    d_nodeManager = nm;
+    if(nm != NULL) {
+      d_oldOwner = nm->d_owner.exchange(std::this_thread::get_id());
+    }
+#endif /* CVC4_ASSERTIONS && CVC4_PORTFOLIO */
     //Options::s_current = nm ? nm->d_options : NULL;
     Debug("current") << "node manager scope: "
                      << NodeManager::s_current << "\n";
   }
 
   ~NodeManagerScope() {
+#if defined(CVC4_ASSERTIONS) && defined(CVC4_PORTFOLIO)
+    if(d_nodeManager != NULL) {
+      d_nodeManager->d_owner = d_oldOwner;
+    }
+#endif /* CVC4_ASSERTIONS && CVC4_PORTFOLIO */
     NodeManager::s_current = d_oldNodeManager;
     //Options::s_current = d_oldNodeManager ? d_oldNodeManager->d_options : NULL;
     Debug("current") << "node manager scope: "
@@ -1005,6 +1130,17 @@ public:
   }
 };/* class NodeManagerScope */
 
+inline void NodeManager::assertRefCountOwner() {
+#if defined(CVC4_ASSERTIONS) && defined(CVC4_PORTFOLIO)
+  Assert(!s_readOnly,
+         "Reference count changed on a thread that may only read nodes");
+  Assert(s_current == NULL
+             || s_current->d_owner.load() == std::this_thread::get_id(),
+         "Reference count changed on a thread that does not own the "
+         "current NodeManager: nodes cannot be shared across threads");
+#endif /* CVC4_ASSERTIONS && CVC4_PORTFOLIO */
+}
+
 /** Get the (singleton) type for booleans. */
 inline TypeNode NodeManager::booleanType() {
   return TypeNode(mkTypeConst<TypeConstant>(BOOLEAN_TYPE));
@@ -1156,25 +1292,21 @@ inline TypeNode NodeManager::mkTesterType(TypeNode domain) {
 }
 
 inline expr::NodeValue* NodeManager::poolLookup(expr::NodeValue* nv) const {
-  NodeValuePool::const_iterator find = d_nodeValuePool.find(nv);
-  if(find == d_nodeValuePool.end()) {
-    return NULL;
-  } else {
-    return *find;
-  }
+  return d_nodeValuePool.find(nv);
 }
 
-inline void NodeManager::poolInsert(expr::NodeValue* nv) {
-  Assert(d_nodeValuePool.find(nv) == d_nodeValuePool.end(),
-         "NodeValue already in the pool!");
-  d_nodeValuePool.insert(nv);// FIXME multithreading
+inline expr::NodeValue* NodeManager::poolInsert(expr::NodeValue* nv) {
+  expr::NodeValue* inPool = d_nodeValuePool.insert(nv);
+  if(inPool != nv) {
+    // lost a race with another thread constructing the same term
+    discardNodeValue(nv);
+  }
+  return inPool;
 }
 
 inline void NodeManager::poolRemove(expr::NodeValue* nv) {
-  Assert(d_nodeValuePool.find(nv) != d_nodeValuePool.end(),
-         "NodeValue is not in the pool!");
-
-  d_nodeValuePool.erase(nv);// FIXME multithreading
+  bool removed CVC4_UNUSED = d_nodeValuePool.erase(nv);
+  Assert(removed, "NodeValue is not in the pool!");
 }
 
 inline Expr NodeManager::toExpr(TNode n) {
@@ -1520,21 +1652,23 @@ NodeClass NodeManager::mkConstInternal(const T& val) {
     return NodeClass(nv);
   }
 
-  nv = (expr::NodeValue*)
-    std::malloc(sizeof(expr::NodeValue) + sizeof(T));
-  if(nv == NULL) {
-    throw std::bad_alloc();
-  }
+  static_assert(alignof(T) <= expr::NodeValueAllocator::GRANULE,
+                "constant payload is over-aligned for the NodeValue allocator");
+  nv = static_cast<expr::NodeValue*>(
+      d_nvAllocator->allocate(sizeof(expr::NodeValue) + sizeof(T)));
 
   nv->d_nchildren = 0;
   nv->d_kind = kind::metakind::ConstantMap<T>::kind;
-  nv->d_id = next_id++;// FIXME multithreading
+  nv->d_id = next_id++;
   nv->d_rc = 0;
 
   //OwningTheory::mkConst(val);
   new (&nv->d_children) T(val);
 
-  poolInsert(nv);
+  expr::NodeValue* inPool = poolInsert(nv);
+  if(inPool != nv) {
+    return NodeClass(inPool);
+  }
   if(Debug.isOn("gc")) {
     Debug("gc") << "creating node value " << nv
                 << " [" << nv->d_id << "]: ";
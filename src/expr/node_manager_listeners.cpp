@@ -17,6 +17,7 @@
 #include "node_manager_listeners.h"
 
 #include "base/listener.h"
+#include "expr/node_manager.h"
 #include "options/smt_options.h"
 #include "util/resource_manager.h"
 
@@ -40,5 +41,9 @@ void RlimitPerListener::notify() {
   d_rm->setTimeLimit(options::perCallResourceLimit(), false);
 }
 
+void ZombieReclaimListener::notify() {
+  d_nm->reclaimZombiesIncrementally();
+}
+
 }/* CVC4::expr namespace */
 }/* CVC4 namespace */
@@ -23,6 +23,9 @@
 #include "util/resource_manager.h"
 
 namespace CVC4 {
+
+class NodeManager;
+
 namespace expr {
 
 class TlimitListener : public Listener {
@@ -61,6 +64,20 @@ class RlimitPerListener : public Listener {
   ResourceManager* d_rm;
 };
 
+/**
+ * Registered with the ResourceManager's safe points when incremental
+ * zombie reclamation is enabled; frees a bounded number of zombies at
+ * each of them.
+ */
+class ZombieReclaimListener : public Listener {
+ public:
+  ZombieReclaimListener(NodeManager* nm) : d_nm(nm) {}
+  void notify() override;
+
+ private:
+  NodeManager* d_nm;
+};
+
 }/* CVC4::expr namespace */
 }/* CVC4 namespace */
 
@@ -418,7 +418,8 @@ inline void NodeValue::inc() {
   Assert(!isBeingDeleted(),
          "NodeValue is currently being deleted "
          "and increment is being called on it. Don't Do That!");
-  // FIXME multithreading
+  // reference counts are not atomic, see NodeManager::assertRefCountOwner()
+  NodeManager::assertRefCountOwner();
   if (__builtin_expect((d_rc < MAX_RC - 1), true)) {
     ++d_rc;
   } else if (__builtin_expect((d_rc == MAX_RC - 1), false)) {
@@ -432,7 +433,7 @@ inline void NodeValue::inc() {
 }
 
 inline void NodeValue::dec() {
-  // FIXME multithreading
+  NodeManager::assertRefCountOwner();
   if(__builtin_expect( ( d_rc < MAX_RC ), true )) {
     --d_rc;
     if(__builtin_expect( ( d_rc == 0 ), false )) {
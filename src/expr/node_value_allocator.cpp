@@ -0,0 +1,111 @@
+/*********************                                                        */
+/*! \file node_value_allocator.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A size-class arena allocator for NodeValues
+ **
+ ** A size-class arena allocator for NodeValues.
+ **/
+
+#include "expr/node_value_allocator.h"
+
+#include <algorithm>
+
+namespace CVC4 {
+namespace expr {
+
+// std::min() below binds it to a reference, which needs a definition
+const size_t NodeValueAllocator::MAX_SMALL_SIZE;
+
+NodeValueAllocator::Statistics::Statistics(StatisticsRegistry* registry)
+    : d_smallAllocations("expr::NodeValueAllocator::smallAllocations", 0),
+      d_freeListHits("expr::NodeValueAllocator::freeListHits", 0),
+      d_largeAllocations("expr::NodeValueAllocator::largeAllocations", 0),
+      d_chunkBytes("expr::NodeValueAllocator::chunkBytes", 0),
+      d_registry(registry)
+{
+  d_registry->registerStat(&d_smallAllocations);
+  d_registry->registerStat(&d_freeListHits);
+  d_registry->registerStat(&d_largeAllocations);
+  d_registry->registerStat(&d_chunkBytes);
+}
+
+NodeValueAllocator::Statistics::~Statistics()
+{
+  d_registry->unregisterStat(&d_smallAllocations);
+  d_registry->unregisterStat(&d_freeListHits);
+  d_registry->unregisterStat(&d_largeAllocations);
+  d_registry->unregisterStat(&d_chunkBytes);
+}
+
+NodeValueAllocator::NodeValueAllocator(StatisticsRegistry* registry)
+    : d_chunkCur(NULL),
+      d_chunkEnd(NULL),
+      d_chunks(),
+      d_lock(),
+      d_statistics(registry)
+{
+  std::fill(d_freeLists, d_freeLists + NUM_CLASSES, (FreeBlock*)NULL);
+}
+
+NodeValueAllocator::~NodeValueAllocator()
+{
+  for (void* chunk : d_chunks)
+  {
+    std::free(chunk);
+  }
+}
+
+void* NodeValueAllocator::carve(size_t size)
+{
+  if (d_chunkCur == NULL || (size_t)(d_chunkEnd - d_chunkCur) < size)
+  {
+    // The tail of the old chunk is too small for this request; hand
+    // it out to the free lists rather than waste it.
+    while (d_chunkCur != NULL && d_chunkEnd - d_chunkCur >= (ptrdiff_t)GRANULE)
+    {
+      size_t rest = std::min((size_t)(d_chunkEnd - d_chunkCur), MAX_SMALL_SIZE);
+      rest &= ~(GRANULE - 1);
+      FreeBlock*& head = d_freeLists[sizeClass(rest)];
+      FreeBlock* block = reinterpret_cast<FreeBlock*>(d_chunkCur);
+      block->d_next = head;
+      head = block;
+      d_chunkCur += rest;
+    }
+
+    void* chunk = std::malloc(CHUNK_SIZE);
+    if (chunk == NULL)
+    {
+      throw std::bad_alloc();
+    }
+    d_chunks.push_back(chunk);
+    d_chunkCur = static_cast<char*>(chunk);
+    d_chunkEnd = d_chunkCur + CHUNK_SIZE;
+    d_statistics.d_chunkBytes += CHUNK_SIZE;
+  }
+
+  void* block = d_chunkCur;
+  d_chunkCur += size;
+  return block;
+}
+
+void* NodeValueAllocator::allocateLarge(size_t size)
+{
+  void* block = std::malloc(size);
+  if (block == NULL)
+  {
+    throw std::bad_alloc();
+  }
+  ++d_statistics.d_largeAllocations;
+  return block;
+}
+
+}/* CVC4::expr namespace */
+}/* CVC4 namespace */
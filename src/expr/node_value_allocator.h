@@ -0,0 +1,156 @@
+/*********************                                                        */
+/*! \file node_value_allocator.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A size-class arena allocator for NodeValues
+ **
+ ** Every NodeValue in a NodeManager's pool is allocated here.  Small
+ ** NodeValues (a header plus a handful of children, or an inlined
+ ** constant) are carved out of large chunks and recycled through one
+ ** free list per size class; anything bigger goes to malloc().  Nodes
+ ** built together end up next to each other in memory, and the
+ ** hottest allocation path in the system no longer calls malloc().
+ **
+ ** Each NodeManager owns its own allocator, so threads with their own
+ ** NodeManager (as in portfolio mode) never share free lists.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__EXPR__NODE_VALUE_ALLOCATOR_H
+#define __CVC4__EXPR__NODE_VALUE_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "base/cvc4_assert.h"
+#include "expr/node_value_pool.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace expr {
+
+class NodeValueAllocator {
+ public:
+  /** Allocation granularity (and alignment) of the small size classes. */
+  static const size_t GRANULE = sizeof(void*);
+
+  /** The largest request served from the size classes. */
+  static const size_t MAX_SMALL_SIZE = 256;
+
+  /** The number of size classes. */
+  static const size_t NUM_CLASSES = MAX_SMALL_SIZE / GRANULE;
+
+  /** The size of the chunks small blocks are carved from. */
+  static const size_t CHUNK_SIZE = 64 * 1024;
+
+  NodeValueAllocator(StatisticsRegistry* registry);
+  ~NodeValueAllocator();
+
+  /**
+   * Allocate size bytes, aligned to GRANULE.
+   * @throws bad_alloc if the memory cannot be obtained
+   */
+  void* allocate(size_t size) {
+    if(__builtin_expect((size > MAX_SMALL_SIZE), false)) {
+      return allocateLarge(size);
+    }
+    NodeValuePoolLock guard(d_lock);
+    ++d_statistics.d_smallAllocations;
+    FreeBlock*& head = d_freeLists[sizeClass(size)];
+    if(head != NULL) {
+      FreeBlock* block = head;
+      head = block->d_next;
+      ++d_statistics.d_freeListHits;
+      return block;
+    }
+    return carve(roundUp(size));
+  }
+
+  /**
+   * Return memory obtained from allocate().  The size must be the one
+   * that was passed to allocate().
+   */
+  void deallocate(void* p, size_t size) {
+    if(__builtin_expect((size > MAX_SMALL_SIZE), false)) {
+      std::free(p);
+      return;
+    }
+    NodeValuePoolLock guard(d_lock);
+    FreeBlock*& head = d_freeLists[sizeClass(size)];
+    FreeBlock* block = static_cast<FreeBlock*>(p);
+    block->d_next = head;
+    head = block;
+  }
+
+ private:
+  /** A free block of some size class, linked through its first word. */
+  struct FreeBlock {
+    FreeBlock* d_next;
+  };/* struct FreeBlock */
+
+  static size_t roundUp(size_t size) {
+    return (size + GRANULE - 1) & ~(GRANULE - 1);
+  }
+
+  static size_t sizeClass(size_t size) {
+    Assert(size > 0 && size <= MAX_SMALL_SIZE);
+    return roundUp(size) / GRANULE - 1;
+  }
+
+  /** Take size bytes from the current chunk, starting a new one if needed. */
+  void* carve(size_t size);
+
+  /** Allocate a block too large for the size classes. */
+  void* allocateLarge(size_t size);
+
+  class Statistics {
+   public:
+    /** Requests served from the size classes */
+    IntStat d_smallAllocations;
+    /** Of those, requests served by recycling a freed block */
+    IntStat d_freeListHits;
+    /** Requests passed on to malloc() */
+    IntStat d_largeAllocations;
+    /** Bytes obtained in chunks for the size classes */
+    IntStat d_chunkBytes;
+
+    Statistics(StatisticsRegistry* registry);
+    ~Statistics();
+
+   private:
+    StatisticsRegistry* d_registry;
+  };/* class NodeValueAllocator::Statistics */
+
+  /** The free list heads, one per size class */
+  FreeBlock* d_freeLists[NUM_CLASSES];
+
+  /** The unused remainder of the current chunk */
+  char* d_chunkCur;
+  char* d_chunkEnd;
+
+  /** All chunks obtained so far, released on destruction */
+  std::vector<void*> d_chunks;
+
+  /** Guards the above (a no-op in single-threaded builds) */
+  NodeValuePoolMutex d_lock;
+
+  Statistics d_statistics;
+
+  NodeValueAllocator(const NodeValueAllocator&) CVC4_UNDEFINED;
+  NodeValueAllocator& operator=(const NodeValueAllocator&) CVC4_UNDEFINED;
+};/* class NodeValueAllocator */
+
+}/* CVC4::expr namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__EXPR__NODE_VALUE_ALLOCATOR_H */
@@ -0,0 +1,152 @@
+/*********************                                                        */
+/*! \file node_value_pool.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A lock-striped hash-consing pool of NodeValues
+ **
+ ** The NodeManager's pool of NodeValues, split into a fixed number of
+ ** independently-locked shards.  A NodeValue lives in the shard
+ ** selected by its pool hash, so lookups and insertions of unrelated
+ ** NodeValues never contend on the same lock, and a growing pool
+ ** rehashes one shard at a time rather than the whole table.
+ **
+ ** Locking is only compiled in for multithreaded (portfolio) builds;
+ ** single-threaded builds pay for the sharding alone.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__EXPR__NODE_VALUE_POOL_H
+#define __CVC4__EXPR__NODE_VALUE_POOL_H
+
+#include <cstddef>
+#include <unordered_set>
+#include <vector>
+
+#ifdef CVC4_PORTFOLIO
+#  include <atomic>
+#  include <mutex>
+#endif /* CVC4_PORTFOLIO */
+
+namespace CVC4 {
+namespace expr {
+
+class NodeValue;
+
+#ifdef CVC4_PORTFOLIO
+typedef std::mutex NodeValuePoolMutex;
+typedef std::lock_guard<std::mutex> NodeValuePoolLock;
+/** The counter handing out NodeValue ids. */
+typedef std::atomic<size_t> NodeValueIdCounter;
+#else /* CVC4_PORTFOLIO */
+/** A no-op stand-in for std::mutex in single-threaded builds. */
+struct NodeValuePoolMutex {
+  void lock() {}
+  void unlock() {}
+};/* struct NodeValuePoolMutex */
+
+/** A no-op stand-in for std::lock_guard in single-threaded builds. */
+struct NodeValuePoolLock {
+  explicit NodeValuePoolLock(NodeValuePoolMutex&) {}
+};/* struct NodeValuePoolLock */
+
+/** The counter handing out NodeValue ids. */
+typedef size_t NodeValueIdCounter;
+#endif /* CVC4_PORTFOLIO */
+
+/**
+ * A set of NodeValues, hashed and compared with the given pool
+ * functors, striped over NSHARDS independently-locked shards.
+ * NSHARDS must be a power of two.
+ */
+template <class Hash, class Eq, unsigned NSHARDS = 64>
+class ShardedNodeValuePool {
+  static_assert((NSHARDS & (NSHARDS - 1)) == 0,
+                "number of pool shards must be a power of two");
+
+  typedef std::unordered_set<NodeValue*, Hash, Eq> Shard;
+
+  struct LockedShard {
+    mutable NodeValuePoolMutex d_lock;
+    Shard d_set;
+  };/* struct LockedShard */
+
+  LockedShard d_shards[NSHARDS];
+
+  /**
+   * Select the shard for a NodeValue.  The low bits of the pool hash
+   * are what the shard's own buckets use, so mix in the high bits to
+   * keep the shard choice independent of the bucket choice.
+   */
+  LockedShard& shardFor(const NodeValue* nv) {
+    size_t h = Hash()(nv);
+    return d_shards[(h ^ (h >> 13) ^ (h >> 23)) & (NSHARDS - 1)];
+  }
+
+  const LockedShard& shardFor(const NodeValue* nv) const {
+    return const_cast<ShardedNodeValuePool*>(this)->shardFor(nv);
+  }
+
+public:
+
+  /**
+   * Look up a NodeValue equal to nv (in the sense of the pool
+   * equality).  Returns NULL if there is none.
+   */
+  NodeValue* find(NodeValue* nv) const {
+    const LockedShard& s = shardFor(nv);
+    NodeValuePoolLock guard(s.d_lock);
+    typename Shard::const_iterator i = s.d_set.find(nv);
+    return i == s.d_set.end() ? NULL : *i;
+  }
+
+  /**
+   * Insert nv, unless an equal NodeValue is already present.  Returns
+   * the NodeValue that is in the pool afterward: nv itself if it was
+   * inserted, or the existing one otherwise.  The latter can only
+   * happen when two threads race to construct the same term.
+   */
+  NodeValue* insert(NodeValue* nv) {
+    LockedShard& s = shardFor(nv);
+    NodeValuePoolLock guard(s.d_lock);
+    return *s.d_set.insert(nv).first;
+  }
+
+  /** Remove nv.  Returns true iff it was present. */
+  bool erase(NodeValue* nv) {
+    LockedShard& s = shardFor(nv);
+    NodeValuePoolLock guard(s.d_lock);
+    return s.d_set.erase(nv) > 0;
+  }
+
+  /** The total number of NodeValues in all shards. */
+  size_t size() const {
+    size_t n = 0;
+    for(unsigned i = 0; i < NSHARDS; ++i) {
+      NodeValuePoolLock guard(d_shards[i].d_lock);
+      n += d_shards[i].d_set.size();
+    }
+    return n;
+  }
+
+  /** Append every NodeValue in the pool to out (for debugging). */
+  void getAll(std::vector<NodeValue*>& out) const {
+    for(unsigned i = 0; i < NSHARDS; ++i) {
+      NodeValuePoolLock guard(d_shards[i].d_lock);
+      out.insert(out.end(), d_shards[i].d_set.begin(), d_shards[i].d_set.end());
+    }
+  }
+
+};/* class ShardedNodeValuePool<Hash, Eq, NSHARDS> */
+
+}/* CVC4::expr namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__EXPR__NODE_VALUE_POOL_H */
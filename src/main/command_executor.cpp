@@ -19,6 +19,7 @@
 #endif /* ! __WIN32__ */
 
 #include <cassert>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -296,6 +297,21 @@ void CommandExecutor::flushOutputStreams() {
     }
   }
 
+  const std::string& exportFile = d_options.getStatsExport();
+  if(!exportFile.empty()) {
+    StatisticsExportFormat format = d_options.getStatsBinary()
+        ? STATS_EXPORT_BINARY : STATS_EXPORT_JSON;
+    StatisticsExporter exporter;
+    exportStatistics(exporter);
+    std::ofstream out(exportFile.c_str(), std::ios::out | std::ios::binary);
+    exporter.write(out, format);
+    out.close();
+    if(!out) {
+      *(d_options.getErr()) << "warning: cannot write statistics to "
+                            << exportFile << std::endl;
+    }
+  }
+
   // make sure out and err streams are flushed too
   d_options.flushOut();
   d_options.flushErr();
@@ -22,6 +22,7 @@
 #include "options/options.h"
 #include "smt/command.h"
 #include "smt/smt_engine.h"
+#include "util/statistics_export.h"
 #include "util/statistics_registry.h"
 
 namespace CVC4 {
@@ -69,6 +70,13 @@ public:
     d_stats.flushInformation(out);
   }
 
+  /** Adds all statistics to exporter, for --stats-export. */
+  virtual void exportStatistics(StatisticsExporter& exporter) const {
+    exporter.add(d_exprMgr.getStatistics());
+    exporter.add(d_smtEngine->getStatistics());
+    exporter.add(d_stats);
+  }
+
   /**
    * Flushes statistics to a file descriptor. Safe to use in a signal handler.
    */
@@ -29,12 +29,13 @@
 
 #include "cvc4autoconfig.h"
 #include "expr/pickler.h"
+#include "main/cube_and_conquer.h"
 #include "main/main.h"
 #include "main/portfolio.h"
 #include "options/options.h"
 #include "options/set_language.h"
 #include "smt/command.h"
-
+#include "util/lock_free_channel.h"
 
 using namespace std;
 
@@ -50,11 +51,13 @@ CommandExecutorPortfolio::CommandExecutorPortfolio(
       d_threadOptions(tOpts),
       d_vmaps(),
       d_lastWinner(0),
-      d_channelsOut(),
       d_channelsIn(),
       d_ostringstreams(),
       d_statLastWinner("portfolio::lastWinner"),
-      d_statWaitTime("portfolio::waitTime")
+      d_statWaitTime("portfolio::waitTime"),
+      d_statCubes("portfolio::cubes", 0),
+      d_statCubeSplits("portfolio::cubeSplits", 0),
+      d_statCubeSteals("portfolio::cubeSteals", 0)
 {
   assert(d_threadOptions.size() == d_numThreads);
 
@@ -62,6 +65,9 @@ CommandExecutorPortfolio::CommandExecutorPortfolio(
   d_stats.registerStat(&d_statLastWinner);
 
   d_stats.registerStat(&d_statWaitTime);
+  d_stats.registerStat(&d_statCubes);
+  d_stats.registerStat(&d_statCubeSplits);
+  d_stats.registerStat(&d_statCubeSteals);
 
   /* Duplication, individualization */
   d_exprMgrs.push_back(&d_exprMgr);
@@ -98,34 +104,40 @@ CommandExecutorPortfolio::~CommandExecutorPortfolio()
 
   d_stats.unregisterStat(&d_statLastWinner);
   d_stats.unregisterStat(&d_statWaitTime);
+  d_stats.unregisterStat(&d_statCubes);
+  d_stats.unregisterStat(&d_statCubeSplits);
+  d_stats.unregisterStat(&d_statCubeSteals);
 }
 
 void CommandExecutorPortfolio::lemmaSharingInit()
 {
   /* Sharing channels */
   assert(d_channelsIn.size() == 0);
-  assert(d_channelsOut.size() == 0);
 
   if(d_numThreads == 1) {
     // Disable sharing
     d_threadOptions[0].setSharingFilterByLength(0);
   } else {
-    // Setup sharing channels
-    const unsigned int sharingChannelSize = 1000000;
+    // Setup sharing channels, one inbox per thread
+    const unsigned int sharingChannelSize = 1 << 16;
 
     for(unsigned i = 0; i < d_numThreads; ++i){
-      d_channelsOut.push_back(
-          new SynchronizedSharedChannel<ChannelFormat>(sharingChannelSize));
       d_channelsIn.push_back(
-          new SynchronizedSharedChannel<ChannelFormat>(sharingChannelSize));
+          new LockFreeSharedChannel<ChannelFormat>(sharingChannelSize));
     }
 
     /* Lemma I/O channels */
     for(unsigned i = 0; i < d_numThreads; ++i) {
       int thread_id = d_threadOptions[i].getThreadId();
       string tag = "thread #" + boost::lexical_cast<string>(thread_id);
+      std::vector<SharedChannel<ChannelFormat>*> peers;
+      for(unsigned j = 0; j < d_numThreads; ++j) {
+        if(j != i) {
+          peers.push_back(d_channelsIn[j]);
+        }
+      }
       LemmaOutputChannel* outputChannel =
-          new PortfolioLemmaOutputChannel(tag, d_channelsOut[i], d_exprMgrs[i],
+          new PortfolioLemmaOutputChannel(tag, peers, d_exprMgrs[i],
                                           d_vmaps[i]->d_from, d_vmaps[i]->d_to);
       LemmaInputChannel* inputChannel =
           new PortfolioLemmaInputChannel(tag, d_channelsIn[i], d_exprMgrs[i],
@@ -156,17 +168,14 @@ void CommandExecutorPortfolio::lemmaSharingCleanup()
 
   // Channel cleanup
   assert(d_channelsIn.size() == d_numThreads);
-  assert(d_channelsOut.size() == d_numThreads);
   for(unsigned i = 0; i < d_numThreads; ++i) {
     delete d_channelsIn[i];
-    delete d_channelsOut[i];
     delete d_smts[i]->channels()->getLemmaInputChannel();
     d_smts[i]->channels()->setLemmaInputChannel(NULL);
     delete d_smts[i]->channels()->getLemmaOutputChannel();
     d_smts[i]->channels()->setLemmaOutputChannel(NULL);
   }
   d_channelsIn.clear();
-  d_channelsOut.clear();
 
   // sstreams cleanup (if used)
   if(d_ostringstreams.size() != 0) {
@@ -202,6 +211,16 @@ bool CommandExecutorPortfolio::doCommandSingleton(Command* cmd)
     return CommandExecutor::doCommandSingleton(cmd);
   }
 
+  if(d_options.getCubeAndConquer()) {
+    AssertCommand* ac = dynamic_cast<AssertCommand*>(cmd);
+    if(ac != NULL) {
+      d_cubeAssertions.push_back(ac->getExpr());
+    } else if(dynamic_cast<ResetCommand*>(cmd) != NULL ||
+              dynamic_cast<ResetAssertionsCommand*>(cmd) != NULL) {
+      d_cubeAssertions.clear();
+    }
+  }
+
   if(dynamic_cast<CheckSatCommand*>(cmd) != NULL ||
      dynamic_cast<QueryCommand*>(cmd) != NULL ) {
     mode = 1;
@@ -233,6 +252,12 @@ bool CommandExecutorPortfolio::doCommandSingleton(Command* cmd)
     if(d_lastWinner != 0) delete cmdExported;
     return ret;
   } else if(mode == 1) {               // portfolio
+    CheckSatCommand* cs = dynamic_cast<CheckSatCommand*>(cmd);
+    if(d_options.getCubeAndConquer() && d_numThreads > 1 &&
+       cs != NULL && cs->getExpr().isNull()) {
+      return cubeAndConquer(cmd);
+    }
+
     d_seq->addCommand(cmd->clone());
 
     // We currently don't support changing number of threads for each
@@ -274,21 +299,7 @@ bool CommandExecutorPortfolio::doCommandSingleton(Command* cmd)
       }
     }
 
-    /**
-     * Create identity variable map for the first thread, with only
-     * those variables which have a corresponding variable in
-     * another thread. (TODO: Also assert, all threads have the same
-     * set of variables mapped.)
-     */
-    if(d_numThreads >= 2) {
-      VarMap& thread_0_from = d_vmaps[0]->d_from;
-      VarMap& thread_1_to = d_vmaps[1]->d_to;
-      for(VarMap::iterator i=thread_1_to.begin();
-          i != thread_1_to.end(); ++i) {
-        thread_0_from[i->first] = i->first;
-      }
-      d_vmaps[0]->d_to = thread_0_from;
-    }
+    initThreadZeroVarMap();
 
     lemmaSharingInit();
 
@@ -304,17 +315,13 @@ bool CommandExecutorPortfolio::doCommandSingleton(Command* cmd)
 
     assert(d_channelsIn.size() == d_numThreads
            || d_numThreads == 1);
-    assert(d_channelsOut.size() == d_numThreads
-           || d_numThreads == 1);
     assert(d_smts.size() == d_numThreads);
     assert( !d_statWaitTime.running() );
 
     boost::function<void()>
       smFn = d_numThreads <= 1 ? boost::function<void()>() :
-             boost::bind(sharingManager<ChannelFormat>,
+             boost::bind(sharingManager,
                          d_numThreads,
-                         &d_channelsOut[0],
-                         &d_channelsIn[0],
                          &d_smts[0]);
 
     size_t threadStackSize = d_options.getThreadStackSize();
@@ -367,43 +374,7 @@ bool CommandExecutorPortfolio::doCommandSingleton(Command* cmd)
 
     delete[] fns;
 
-    bool status = portfolioReturn.second;
-
-    // dump the model/proof/unsat core if option is set
-    if(status) {
-      if( d_options.getProduceModels() &&
-          d_options.getDumpModels() &&
-          ( d_result.asSatisfiabilityResult() == Result::SAT ||
-            (d_result.isUnknown() &&
-             d_result.whyUnknown() == Result::INCOMPLETE) ) )
-      {
-        Command* gm = new GetModelCommand();
-        status = doCommandSingleton(gm);
-      } else if( d_options.getProof() &&
-                 d_options.getDumpProofs() &&
-                 d_result.asSatisfiabilityResult() == Result::UNSAT ) {
-        Command* gp = new GetProofCommand();
-        status = doCommandSingleton(gp);
-      } else if( d_options.getDumpInstantiations() &&
-                 ( ( d_options.getInstFormatMode() != INST_FORMAT_MODE_SZS &&
-                   ( d_result.asSatisfiabilityResult() == Result::SAT ||
-                     (d_result.isUnknown() &&
-                      d_result.whyUnknown() == Result::INCOMPLETE) ) ) ||
-                   d_result.asSatisfiabilityResult() == Result::UNSAT ) ) {
-        Command* gi = new GetInstantiationsCommand();
-        status = doCommandSingleton(gi);
-      } else if( d_options.getDumpSynth() &&
-                 d_result.asSatisfiabilityResult() == Result::UNSAT ){
-        Command* gi = new GetSynthSolutionCommand();
-        status = doCommandSingleton(gi);
-      } else if( d_options.getDumpUnsatCores() &&
-                 d_result.asSatisfiabilityResult() == Result::UNSAT ) {
-        Command* guc = new GetUnsatCoreCommand();
-        status = doCommandSingleton(guc);
-      }
-    }
-
-    return status;
+    return dumpAfterCheckSat(portfolioReturn.second);
   } else if(mode == 2) {
     Command* cmdExported = d_lastWinner == 0 ?
         cmd : cmd->exportTo(d_exprMgrs[d_lastWinner], *(d_vmaps[d_lastWinner]));
@@ -423,6 +394,155 @@ bool CommandExecutorPortfolio::doCommandSingleton(Command* cmd)
 
 }/* CommandExecutorPortfolio::doCommandSingleton() */
 
+void CommandExecutorPortfolio::initThreadZeroVarMap()
+{
+  /**
+   * Create identity variable map for the first thread, with only
+   * those variables which have a corresponding variable in
+   * another thread. (TODO: Also assert, all threads have the same
+   * set of variables mapped.)
+   */
+  if(d_numThreads >= 2) {
+    VarMap& thread_0_from = d_vmaps[0]->d_from;
+    VarMap& thread_1_to = d_vmaps[1]->d_to;
+    for(VarMap::iterator i=thread_1_to.begin();
+        i != thread_1_to.end(); ++i) {
+      thread_0_from[i->first] = i->first;
+    }
+    d_vmaps[0]->d_to = thread_0_from;
+  }
+}
+
+bool CommandExecutorPortfolio::cubeAndConquer(Command* cmd)
+{
+  /* Bring the threads up to date with the commands since the last
+     check-sat, which only the last winner has seen */
+  std::vector<Command*> seqs(d_numThreads, NULL);
+  for(unsigned i = 0; i < d_numThreads; ++i) {
+    if(int(i) == d_lastWinner) {
+      continue;
+    }
+    try {
+      seqs[i] = i == 0 ? d_seq : d_seq->exportTo(d_exprMgrs[i], *(d_vmaps[i]));
+    } catch(ExportUnsupportedException& e) {
+      for(unsigned j = 1; j < i; ++j) {
+        delete seqs[j];
+      }
+      if(d_options.getFallbackSequential()) {
+        Notice() << "Unsupported theory encountered."
+                 << "Switching to sequential mode.";
+        return CommandExecutor::doCommandSingleton(cmd);
+      }
+      else
+        throw Exception("Certain theories (e.g., datatypes) are (currently)"
+                        " unsupported in portfolio\n mode. Please see option"
+                        " --fallback-sequential to make this a soft error.");
+    }
+  }
+  for(unsigned i = 0; i < d_numThreads; ++i) {
+    if(seqs[i] != NULL) {
+      smtEngineInvoke(d_smts[i], seqs[i], NULL);
+      if(i != 0) {
+        delete seqs[i];
+      }
+    }
+  }
+  delete d_seq;
+  d_seq = new CommandSequence();
+
+  initThreadZeroVarMap();
+
+  /* The split atoms, in each thread's expression manager */
+  const size_t maxSplitAtoms = 64;
+  std::vector< std::vector<Expr> > atoms(d_numThreads);
+  atoms[0] = CubeAndConquer::selectAtoms(d_cubeAssertions, maxSplitAtoms);
+  for(unsigned i = 1; i < d_numThreads; ++i) {
+    for(size_t j = 0; j < atoms[0].size(); ++j) {
+      atoms[i].push_back(atoms[0][j].exportTo(d_exprMgrs[i], *(d_vmaps[i])));
+    }
+  }
+
+  unsigned depth = d_options.getCubeDepth();
+  if(depth == 0) {
+    while((1u << depth) < 4 * d_numThreads) {
+      ++depth;
+    }
+  }
+  depth = std::min(depth, 24u);
+
+  size_t threadStackSize = d_options.getThreadStackSize();
+  threadStackSize *= 1024 * 1024;
+
+  lemmaSharingInit();
+
+  std::vector<unsigned long> perCallLimits;
+  for(unsigned i = 0; i < d_numThreads; ++i) {
+    perCallLimits.push_back(d_threadOptions[i].getPerCallResourceLimit());
+  }
+
+  CubeAndConquer cubes(d_smts, atoms, depth, d_options.getCubeBudget(),
+                       perCallLimits, threadStackSize);
+  pair<int, Result> cubesReturn;
+  try {
+    cubesReturn = cubes.run();
+  } catch(...) {
+    lemmaSharingCleanup();
+    throw;
+  }
+  d_statCubes += cubes.numSolved();
+  d_statCubeSplits += cubes.numSplit();
+  d_statCubeSteals += cubes.numStolen();
+
+  lemmaSharingCleanup();
+
+  d_lastWinner = cubesReturn.first;
+  d_result = cubesReturn.second;
+  if(d_options.getVerbosity() >= -1) {
+    *d_options.getOut() << d_result << std::endl;
+  }
+
+  return dumpAfterCheckSat(true);
+}
+
+bool CommandExecutorPortfolio::dumpAfterCheckSat(bool status)
+{
+  // dump the model/proof/unsat core if option is set
+  if(status) {
+    if( d_options.getProduceModels() &&
+        d_options.getDumpModels() &&
+        ( d_result.asSatisfiabilityResult() == Result::SAT ||
+          (d_result.isUnknown() &&
+           d_result.whyUnknown() == Result::INCOMPLETE) ) )
+    {
+      Command* gm = new GetModelCommand();
+      status = doCommandSingleton(gm);
+    } else if( d_options.getProof() &&
+               d_options.getDumpProofs() &&
+               d_result.asSatisfiabilityResult() == Result::UNSAT ) {
+      Command* gp = new GetProofCommand();
+      status = doCommandSingleton(gp);
+    } else if( d_options.getDumpInstantiations() &&
+               ( ( d_options.getInstFormatMode() != INST_FORMAT_MODE_SZS &&
+                 ( d_result.asSatisfiabilityResult() == Result::SAT ||
+                   (d_result.isUnknown() &&
+                    d_result.whyUnknown() == Result::INCOMPLETE) ) ) ||
+                 d_result.asSatisfiabilityResult() == Result::UNSAT ) ) {
+      Command* gi = new GetInstantiationsCommand();
+      status = doCommandSingleton(gi);
+    } else if( d_options.getDumpSynth() &&
+               d_result.asSatisfiabilityResult() == Result::UNSAT ){
+      Command* gi = new GetSynthSolutionCommand();
+      status = doCommandSingleton(gi);
+    } else if( d_options.getDumpUnsatCores() &&
+               d_result.asSatisfiabilityResult() == Result::UNSAT ) {
+      Command* guc = new GetUnsatCoreCommand();
+      status = doCommandSingleton(guc);
+    }
+  }
+
+  return status;
+}
+
 void CommandExecutorPortfolio::flushStatistics(std::ostream& out) const {
   assert(d_numThreads == d_exprMgrs.size() &&
          d_exprMgrs.size() == d_smts.size());
@@ -442,5 +562,18 @@ void CommandExecutorPortfolio::flushStatistics(std::ostream& out) const {
   d_stats.flushInformation(out);
 }
 
+void CommandExecutorPortfolio::exportStatistics(
+    StatisticsExporter& exporter) const {
+  assert(d_numThreads == d_exprMgrs.size() &&
+         d_exprMgrs.size() == d_smts.size());
+  for(size_t i = 0; i < d_numThreads; ++i) {
+    string tag = "thread#"
+        + boost::lexical_cast<string>(d_threadOptions[i].getThreadId());
+    exporter.add(d_exprMgrs[i]->getStatistics(), tag);
+    exporter.add(d_smts[i]->getStatistics(), tag);
+  }
+  exporter.add(d_stats);
+}
+
 }/* CVC4::main namespace */
 }/* CVC4 namespace */
@@ -46,13 +46,18 @@ class CommandExecutorPortfolio : public CommandExecutor {
   int d_lastWinner;
 
   // These shall be reset for each check-sat
-  std::vector< SharedChannel<ChannelFormat>* > d_channelsOut;
   std::vector< SharedChannel<ChannelFormat>* > d_channelsIn;
   std::vector<std::ostringstream*> d_ostringstreams;
 
+  // Assertions (of thread #0) to pick --cube-and-conquer split atoms from
+  std::vector<Expr> d_cubeAssertions;
+
   // Stats
   ReferenceStat<int> d_statLastWinner;
   TimerStat d_statWaitTime;
+  IntStat d_statCubes;
+  IntStat d_statCubeSplits;
+  IntStat d_statCubeSteals;
 
 public:
   CommandExecutorPortfolio(ExprManager &exprMgr,
@@ -65,12 +70,19 @@ public:
 
   void flushStatistics(std::ostream& out) const;
 
+  void exportStatistics(StatisticsExporter& exporter) const;
+
 protected:
   bool doCommandSingleton(Command* cmd);
 private:
   CommandExecutorPortfolio();
   void lemmaSharingInit();
   void lemmaSharingCleanup();
+  void initThreadZeroVarMap();
+  /** Runs a plain check-sat by cube-and-conquer instead of a race. */
+  bool cubeAndConquer(Command* cmd);
+  /** Dumps models, proofs etc. as requested after a check-sat or query. */
+  bool dumpAfterCheckSat(bool status);
 };/* class CommandExecutorPortfolio */
 
 }/* CVC4::main namespace */
@@ -0,0 +1,382 @@
+/*********************                                                        */
+/*! \file cube_and_conquer.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Divide-and-conquer solving of one check-sat by several threads
+ **
+ ** Divide-and-conquer solving of one check-sat by several threads.
+ **/
+
+#include "main/cube_and_conquer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "base/output.h"
+#include "expr/kind.h"
+#include "options/option_exception.h"
+
+namespace CVC4 {
+namespace main {
+
+CubeAndConquer::CubeAndConquer(const std::vector<SmtEngine*>& smts,
+                               const std::vector<std::vector<Expr> >& atoms,
+                               unsigned initialDepth,
+                               unsigned long budget,
+                               const std::vector<unsigned long>& perCallLimits,
+                               size_t stackSize)
+    : d_smts(smts),
+      d_atoms(atoms),
+      d_initialDepth(initialDepth),
+      d_budget(budget),
+      d_perCallLimits(perCallLimits),
+      d_stackSize(stackSize),
+      d_queues(),
+      d_outstanding(0),
+      d_done(false),
+      d_workEpoch(0),
+      d_winner(0),
+      d_result(Result::UNSAT),
+      d_unknown(false),
+      d_unknownResult(),
+      d_error(),
+      d_solvedCounts(smts.size(), 0),
+      d_splitCounts(smts.size(), 0),
+      d_stealCounts(smts.size(), 0)
+{
+  assert(d_smts.size() == d_atoms.size());
+  assert(d_smts.size() == d_perCallLimits.size());
+  for(size_t i = 0; i < d_smts.size(); ++i) {
+    d_queues.push_back(new WorkQueue());
+  }
+}
+
+CubeAndConquer::~CubeAndConquer()
+{
+  for(size_t i = 0; i < d_queues.size(); ++i) {
+    delete d_queues[i];
+  }
+}
+
+std::pair<int, Result> CubeAndConquer::run()
+{
+  unsigned numThreads = d_smts.size();
+  unsigned depth = std::min<size_t>(d_initialDepth, d_atoms[0].size());
+
+  /* Deal out the initial cubes round-robin */
+  for(unsigned long k = 0; k < (1ul << depth); ++k) {
+    Cube cube(depth);
+    for(unsigned j = 0; j < depth; ++j) {
+      cube[j] = ((k >> j) & 1) != 0;
+    }
+    d_queues[k % numThreads]->d_cubes.push_back(cube);
+  }
+  d_outstanding = 1u << depth;
+
+  Trace("cube") << "cube-and-conquer: " << (1u << depth) << " cubes over "
+                << d_atoms[0].size() << " split atoms" << std::endl;
+
+  boost::thread* threads = new boost::thread[numThreads];
+  for(unsigned t = 0; t < numThreads; ++t) {
+#if BOOST_HAS_THREAD_ATTR
+    boost::thread::attributes attrs;
+    if(d_stackSize > 0) {
+      attrs.set_stack_size(d_stackSize);
+    }
+    threads[t] =
+      boost::thread(attrs, boost::bind(&CubeAndConquer::worker, this, t));
+#else /* BOOST_HAS_THREAD_ATTR */
+    if(d_stackSize > 0) {
+      throw OptionException("cannot specify a stack size for worker threads; requires CVC4 to be built with Boost thread library >= 1.50.0");
+    }
+    threads[t] = boost::thread(boost::bind(&CubeAndConquer::worker, this, t));
+#endif /* BOOST_HAS_THREAD_ATTR */
+  }
+  for(unsigned t = 0; t < numThreads; ++t) {
+    threads[t].join();
+  }
+  delete[] threads;
+
+  if(!d_error.empty()) {
+    throw Exception(d_error);
+  }
+  if(d_result.isSat() == Result::SAT || !d_unknown) {
+    return std::make_pair(d_winner, d_result);
+  }
+  return std::make_pair(d_winner, d_unknownResult);
+}
+
+void CubeAndConquer::worker(unsigned id)
+{
+  SmtEngine* smt = d_smts[id];
+  const std::vector<Expr>& atoms = d_atoms[id];
+  unsigned long userLimit = d_perCallLimits[id];
+  Cube cube;
+
+  try {
+    while(!d_done) {
+      uint64_t epoch;
+      {
+        boost::mutex::scoped_lock lock(d_workMutex);
+        epoch = d_workEpoch;
+      }
+      if(!takeCube(id, cube)) {
+        // sleep until another worker queues a cube or the run is over
+        boost::mutex::scoped_lock lock(d_workMutex);
+        while(!d_done && d_outstanding != 0 && d_workEpoch == epoch) {
+          d_workChanged.wait(lock);
+        }
+        if(d_outstanding == 0) {
+          break;
+        }
+        continue;
+      }
+
+      // split on running out of the cube budget, but not of the user's
+      // own per-query limit, which bounds every cube
+      bool canSplit = d_budget > 0 && cube.size() < atoms.size()
+                      && (userLimit == 0 || d_budget < userLimit);
+      smt->setResourceLimit(canSplit ? d_budget : userLimit, false);
+
+      std::vector<Expr> assumptions;
+      for(size_t j = 0; j < cube.size(); ++j) {
+        assumptions.push_back(cube[j] ? atoms[j] : atoms[j].notExpr());
+      }
+      Result r = smt->checkSat(assumptions);
+      Trace("cube") << "cube-and-conquer: thread #" << id << " cube of size "
+                    << cube.size() << ": " << r << std::endl;
+
+      if(r.isSat() == Result::SAT) {
+        ++d_solvedCounts[id];
+        finish(id, r);
+      } else if(r.isSat() == Result::UNSAT) {
+        ++d_solvedCounts[id];
+        cubeDone();
+      } else if(d_done) {
+        // interrupted because another worker found a model
+      } else if(canSplit && r.whyUnknown() == Result::RESOURCEOUT) {
+        ++d_splitCounts[id];
+        ++d_outstanding;
+        cube.push_back(false);
+        pushCube(id, cube);
+        cube.back() = true;
+        pushCube(id, cube);
+      } else {
+        ++d_solvedCounts[id];
+        {
+          boost::mutex::scoped_lock lock(d_resultMutex);
+          d_unknown = true;
+          d_unknownResult = r;
+        }
+        cubeDone();
+      }
+    }
+  } catch(Exception& e) {
+    {
+      boost::mutex::scoped_lock lock(d_resultMutex);
+      if(d_error.empty()) {
+        d_error = e.toString();
+      }
+    }
+    finish(id, Result(Result::SAT_UNKNOWN, Result::OTHER));
+  }
+
+  smt->setResourceLimit(userLimit, false);
+}
+
+bool CubeAndConquer::takeCube(unsigned id, Cube& cube)
+{
+  {
+    WorkQueue& own = *d_queues[id];
+    boost::mutex::scoped_lock lock(own.d_mutex);
+    if(!own.d_cubes.empty()) {
+      cube = own.d_cubes.back();
+      own.d_cubes.pop_back();
+      return true;
+    }
+  }
+  for(size_t k = 1; k < d_queues.size(); ++k) {
+    WorkQueue& victim = *d_queues[(id + k) % d_queues.size()];
+    boost::mutex::scoped_lock lock(victim.d_mutex);
+    if(!victim.d_cubes.empty()) {
+      cube = victim.d_cubes.front();
+      victim.d_cubes.pop_front();
+      ++d_stealCounts[id];
+      return true;
+    }
+  }
+  return false;
+}
+
+void CubeAndConquer::pushCube(unsigned id, const Cube& cube)
+{
+  {
+    WorkQueue& own = *d_queues[id];
+    boost::mutex::scoped_lock lock(own.d_mutex);
+    own.d_cubes.push_back(cube);
+  }
+  notifyWorkers();
+}
+
+void CubeAndConquer::cubeDone()
+{
+  if(--d_outstanding == 0) {
+    notifyWorkers();
+  }
+}
+
+void CubeAndConquer::notifyWorkers()
+{
+  boost::mutex::scoped_lock lock(d_workMutex);
+  ++d_workEpoch;
+  d_workChanged.notify_all();
+}
+
+void CubeAndConquer::finish(unsigned id, const Result& r)
+{
+  {
+    boost::mutex::scoped_lock lock(d_resultMutex);
+    if(d_done) {
+      return;
+    }
+    d_winner = id;
+    d_result = r;
+    d_done = true;
+  }
+  notifyWorkers();
+  for(unsigned t = 0; t < d_smts.size(); ++t) {
+    if(t == id) {
+      continue;
+    }
+    try {
+      d_smts[t]->interrupt();
+    } catch(ModalException& e) {
+      // It's fine, the thread is probably not solving.
+      Trace("interrupt") << "Could not interrupt thread #" << t << std::endl;
+    }
+  }
+}
+
+uint64_t CubeAndConquer::numSolved() const
+{
+  uint64_t n = 0;
+  for(size_t i = 0; i < d_solvedCounts.size(); ++i) {
+    n += d_solvedCounts[i];
+  }
+  return n;
+}
+
+uint64_t CubeAndConquer::numSplit() const
+{
+  uint64_t n = 0;
+  for(size_t i = 0; i < d_splitCounts.size(); ++i) {
+    n += d_splitCounts[i];
+  }
+  return n;
+}
+
+uint64_t CubeAndConquer::numStolen() const
+{
+  uint64_t n = 0;
+  for(size_t i = 0; i < d_stealCounts.size(); ++i) {
+    n += d_stealCounts[i];
+  }
+  return n;
+}
+
+namespace {
+
+/** Whether e is a Boolean connective we look through for atoms */
+bool isConnective(Expr e)
+{
+  switch(e.getKind()) {
+  case kind::NOT:
+  case kind::AND:
+  case kind::OR:
+  case kind::XOR:
+  case kind::IMPLIES:
+    return true;
+  case kind::ITE:
+  case kind::EQUAL:
+    return e[1].getType().isBoolean();
+  default:
+    return false;
+  }
+}
+
+/** Whether e binds variables in its body */
+bool isBinder(Expr e)
+{
+  switch(e.getKind()) {
+  case kind::FORALL:
+  case kind::EXISTS:
+  case kind::LAMBDA:
+    return true;
+  default:
+    return false;
+  }
+}
+
+struct AtomOrder {
+  const std::unordered_map<Expr, unsigned, ExprHashFunction>& d_counts;
+  bool operator()(const Expr& a, const Expr& b) const {
+    unsigned ca = d_counts.find(a)->second;
+    unsigned cb = d_counts.find(b)->second;
+    return ca != cb ? ca > cb : a.getId() < b.getId();
+  }
+};/* struct AtomOrder */
+
+}/* anonymous namespace */
+
+std::vector<Expr> CubeAndConquer::selectAtoms(
+    const std::vector<Expr>& assertions, size_t max)
+{
+  std::unordered_map<Expr, unsigned, ExprHashFunction> atomCounts;
+  std::unordered_map<Expr, bool, ExprHashFunction> visited;
+  std::vector<Expr> toVisit(assertions.begin(), assertions.end());
+  while(!toVisit.empty()) {
+    Expr cur = toVisit.back();
+    toVisit.pop_back();
+    if(cur.isConst() || isBinder(cur)) {
+      continue;
+    }
+    if(!isConnective(cur)) {
+      ++atomCounts[cur];
+      continue;
+    }
+    // count every occurrence of an atom, but expand shared formulas once
+    if(visited[cur]) {
+      continue;
+    }
+    visited[cur] = true;
+    for(unsigned i = 0; i < cur.getNumChildren(); ++i) {
+      toVisit.push_back(cur[i]);
+    }
+  }
+
+  std::vector<Expr> atoms;
+  for(std::unordered_map<Expr, unsigned, ExprHashFunction>::const_iterator
+          i = atomCounts.begin(); i != atomCounts.end(); ++i) {
+    atoms.push_back(i->first);
+  }
+  AtomOrder order = { atomCounts };
+  std::sort(atoms.begin(), atoms.end(), order);
+  if(atoms.size() > max) {
+    atoms.resize(max);
+  }
+  return atoms;
+}
+
+}/* CVC4::main namespace */
+}/* CVC4 namespace */
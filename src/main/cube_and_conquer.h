@@ -0,0 +1,143 @@
+/*********************                                                        */
+/*! \file cube_and_conquer.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Divide-and-conquer solving of one check-sat by several threads
+ **
+ ** Instead of racing differently-configured copies of the same problem,
+ ** the problem is split into cubes: conjunctions of literals over a list
+ ** of split atoms, cube k fixing the polarity of the first k atoms.  Each
+ ** worker thread owns an (incremental) SmtEngine and a deque of cubes; it
+ ** solves its cubes under assumptions, newest first, and steals the
+ ** oldest cube of another worker when its own deque is empty.  A cube
+ ** that runs out of its resource budget is split on the next atom and
+ ** both halves go back on the worker's deque.  The first satisfiable
+ ** cube answers sat; the problem is unsat once every cube is.
+ **/
+
+#ifndef __CVC4__MAIN__CUBE_AND_CONQUER_H
+#define __CVC4__MAIN__CUBE_AND_CONQUER_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "expr/expr.h"
+#include "smt/smt_engine.h"
+#include "util/result.h"
+
+namespace CVC4 {
+namespace main {
+
+class CubeAndConquer {
+ public:
+  /**
+   * Prepares a run over the given engines, one worker thread each.
+   * atoms[i] are the split atoms, in the expression manager of smts[i]
+   * and in the same order for every i.  Cubes are first split on
+   * initialDepth atoms, and split further when a cube uses up budget
+   * resource units (never, if budget is 0).  perCallLimits[i] is the
+   * per-query resource limit the user gave thread i (0 for none); a cube
+   * never gets more than that, and it is restored after the run.
+   */
+  CubeAndConquer(const std::vector<SmtEngine*>& smts,
+                 const std::vector<std::vector<Expr> >& atoms,
+                 unsigned initialDepth,
+                 unsigned long budget,
+                 const std::vector<unsigned long>& perCallLimits,
+                 size_t stackSize);
+  ~CubeAndConquer();
+
+  /**
+   * Solves all cubes.  Returns the index of the thread whose engine holds
+   * the answer (for a sat result, its model), and the result.
+   */
+  std::pair<int, Result> run();
+
+  /** The number of cubes solved (not split) in run() */
+  uint64_t numSolved() const;
+  /** The number of cubes split after using up their budget in run() */
+  uint64_t numSplit() const;
+  /** The number of cubes a worker took from another worker's deque */
+  uint64_t numStolen() const;
+
+  /**
+   * Picks up to max atoms to split on among the Boolean atoms of the
+   * assertions, those occurring most often first.  Atoms under binders
+   * are not considered.
+   */
+  static std::vector<Expr> selectAtoms(const std::vector<Expr>& assertions,
+                                       size_t max);
+
+ private:
+  /** The polarities of the first size() split atoms */
+  typedef std::vector<bool> Cube;
+
+  struct WorkQueue {
+    boost::mutex d_mutex;
+    std::deque<Cube> d_cubes;
+  };/* struct CubeAndConquer::WorkQueue */
+
+  void worker(unsigned id);
+  /** Takes the newest own cube, or else steals another worker's oldest. */
+  bool takeCube(unsigned id, Cube& cube);
+  void pushCube(unsigned id, const Cube& cube);
+  /** Ends the run: records the result and interrupts the other workers. */
+  void finish(unsigned id, const Result& r);
+  /** Marks a cube as solved, waking the idle workers if it was the last. */
+  void cubeDone();
+  /** Wakes the idle workers, after a cube was queued or the run ended. */
+  void notifyWorkers();
+
+  std::vector<SmtEngine*> d_smts;
+  std::vector<std::vector<Expr> > d_atoms;
+  unsigned d_initialDepth;
+  unsigned long d_budget;
+  std::vector<unsigned long> d_perCallLimits;
+  size_t d_stackSize;
+
+  std::vector<WorkQueue*> d_queues;
+  /** Cubes queued or being solved; the problem is unsat when this hits 0 */
+  std::atomic<unsigned> d_outstanding;
+  std::atomic<bool> d_done;
+
+  /**
+   * Idle workers wait on d_workChanged until d_workEpoch moves, which it
+   * does whenever a cube is queued, the last cube is solved, or the run
+   * ends.  Both are guarded by d_workMutex.
+   */
+  boost::mutex d_workMutex;
+  boost::condition_variable d_workChanged;
+  uint64_t d_workEpoch;
+
+  /** Guards the fields below */
+  boost::mutex d_resultMutex;
+  int d_winner;
+  Result d_result;
+  bool d_unknown;
+  Result d_unknownResult;
+  std::string d_error;
+
+  /** Per-worker counts, each only written by its worker */
+  std::vector<uint64_t> d_solvedCounts;
+  std::vector<uint64_t> d_splitCounts;
+  std::vector<uint64_t> d_stealCounts;
+};/* class CubeAndConquer */
+
+}/* CVC4::main namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__MAIN__CUBE_AND_CONQUER_H */
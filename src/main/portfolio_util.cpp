@@ -109,6 +109,17 @@ void parseThreadSpecificOptions(OptionsList& threadOptions, const Options& opts)
       delete [] targv;
       free(tbuf);
     }
+
+    // cube-and-conquer workers solve one cube after another
+    if(opts.getCubeAndConquer()) {
+      // an unsat answer is the union of many cubes, each refuted under
+      // its own assumptions; no single thread has a proof or a core of it
+      if(tOpts.getProof() || tOpts.getUnsatCores()) {
+        throw OptionException("--cube-and-conquer cannot be combined with "
+                              "proofs or unsat cores");
+      }
+      tOpts.setOption("incremental", "true");
+    }
   }
 
   assert(numThreads >= 1);      //do we need this?
@@ -123,7 +134,12 @@ void PortfolioLemmaOutputChannel::notifyNewLemma(Expr lemma) {
   expr::pickle::Pickle pkl;
   try {
     d_pickler.toPickle(lemma, pkl);
-    d_sharedChannel->push(pkl);
+    for(size_t i = 0; i < d_peers.size(); ++i) {
+      if(!d_peers[i]->push(pkl)) {
+        Trace("sharing::full") << d_tag << ": peer channel " << i
+                               << " full, dropping lemma" << std::endl;
+      }
+    }
     if(Trace.isOn("showSharing") && Options::currentGetThreadId() == 0) {
       (*(Options::currentGetOut()))
           << "thread #0: notifyNewLemma: " << lemma << std::endl;
@@ -158,4 +174,32 @@ Expr PortfolioLemmaInputChannel::getNewLemma() {
   return e;
 }
 
+void sharingManager(unsigned numThreads, SmtEngine* smts[])
+{
+  Trace("sharing") << "sharing: thread started " << std::endl;
+
+  /* Sleep until runPortfolio() interrupts us */
+  try {
+    for(;;) {
+      boost::this_thread::sleep(boost::posix_time::hours(1));
+    }
+  } catch(boost::thread_interrupted&) {
+  }
+
+  Trace("interrupt")
+    << "sharing thread interrupted, interrupting all smtEngines" << std::endl;
+
+  for(unsigned t = 0; t < numThreads; ++t) {
+    Trace("interrupt") << "Interrupting thread #" << t << std::endl;
+    try{
+      smts[t]->interrupt();
+    }catch(ModalException &e){
+      // It's fine, the thread is probably not there.
+      Trace("interrupt") << "Could not interrupt thread #" << t << std::endl;
+    }
+  }
+
+  Trace("sharing") << "sharing: Interrupted, exiting." << std::endl;
+}/* sharingManager() */
+
 }/*CVC4 namespace */
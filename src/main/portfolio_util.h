@@ -15,7 +15,7 @@
 #ifndef __CVC4__PORTFOLIO_UTIL_H
 #define __CVC4__PORTFOLIO_UTIL_H
 
-#include <queue>
+#include <vector>
 
 #include "base/output.h"
 #include "expr/pickler.h"
@@ -28,21 +28,27 @@ namespace CVC4 {
 
 typedef expr::pickle::Pickle ChannelFormat;
 
+/**
+ * Sends the lemmas of one thread straight to the input channels of all
+ * the other threads.  The lemma is pickled once and pushed into each
+ * peer's lock-free channel; a peer whose channel is full misses it.
+ */
 class PortfolioLemmaOutputChannel : public LemmaOutputChannel {
 private:
   std::string d_tag;
-  SharedChannel<ChannelFormat>* d_sharedChannel;
+  std::vector<SharedChannel<ChannelFormat>*> d_peers;
   expr::pickle::MapPickler d_pickler;
 
 public:
   int cnt;
   PortfolioLemmaOutputChannel(std::string tag,
-                              SharedChannel<ChannelFormat> *c,
+                              const std::vector<SharedChannel<ChannelFormat>*>&
+                                  peers,
                               ExprManager* em,
                               VarMap& to,
                               VarMap& from) :
     d_tag(tag),
-    d_sharedChannel(c),
+    d_peers(peers),
     d_pickler(em, to, from),
     cnt(0)
   {}
@@ -93,87 +99,12 @@ class OptionsList {
 
 void parseThreadSpecificOptions(OptionsList& list, const Options& opts);
 
-template<typename T>
-void sharingManager(unsigned numThreads,
-                    SharedChannel<T> *channelsOut[], // out and in with respect
-                    SharedChannel<T> *channelsIn[],
-                    SmtEngine *smts[])  // to smt engines
-{
-  Trace("sharing") << "sharing: thread started " << std::endl;
-  std::vector <int> cnt(numThreads); // Debug("sharing")
-
-  std::vector< std::queue<T> > queues;
-  for(unsigned i = 0; i < numThreads; ++i){
-    queues.push_back(std::queue<T>());
-  }
-
-  const unsigned int sharingBroadcastInterval = 1;
-
-  boost::mutex mutex_activity;
-
-  /* Disable interruption, so that we can check manually */
-  boost::this_thread::disable_interruption di;
-
-  while(not boost::this_thread::interruption_requested()) {
-
-    boost::this_thread::sleep
-      (boost::posix_time::milliseconds(sharingBroadcastInterval));
-
-    for(unsigned t = 0; t < numThreads; ++t) {
-
-      /* No activity on this channel */
-      if(channelsOut[t]->empty()) continue;
-
-      /* Alert if channel full, so that we increase sharingChannelSize
-         or decrease sharingBroadcastInterval */
-      assert(not channelsOut[t]->full());
-
-      T data = channelsOut[t]->pop();
-
-      if(Trace.isOn("sharing")) {
-        ++cnt[t];
-        Trace("sharing") << "sharing: Got data. Thread #" << t
-                         << ". Chunk " << cnt[t] << std::endl;
-      }
-
-      for(unsigned u = 0; u < numThreads; ++u) {
-        if(u != t){
-          Trace("sharing") << "sharing: adding to queue " << u << std::endl;
-          queues[u].push(data);
-        }
-      }/* end of inner for: broadcast activity */
-
-    } /* end of outer for: look for activity */
-
-    for(unsigned t = 0; t < numThreads; ++t){
-      /* Alert if channel full, so that we increase sharingChannelSize
-         or decrease sharingBroadcastInterval */
-      assert(not channelsIn[t]->full());
-
-      while(!queues[t].empty() && !channelsIn[t]->full()){
-        Trace("sharing") << "sharing: pushing on channel " << t << std::endl;
-        T data = queues[t].front();
-        channelsIn[t]->push(data);
-        queues[t].pop();
-      }
-    }
-  } /* end of infinite while */
-
-  Trace("interrupt")
-    << "sharing thread interrupted, interrupting all smtEngines" << std::endl;
-
-  for(unsigned t = 0; t < numThreads; ++t) {
-    Trace("interrupt") << "Interrupting thread #" << t << std::endl;
-    try{
-      smts[t]->interrupt();
-    }catch(ModalException &e){
-      // It's fine, the thread is probably not there.
-      Trace("interrupt") << "Could not interrupt thread #" << t << std::endl;
-    }
-  }
-
-  Trace("sharing") << "sharing: Interrupted, exiting." << std::endl;
-}/* sharingManager() */
+/**
+ * Body of the portfolio's driver thread.  Lemmas travel directly between
+ * the solver threads, so all that is left to do here is to wait until
+ * the portfolio is done and then interrupt the threads still running.
+ */
+void sharingManager(unsigned numThreads, SmtEngine* smts[]);
 
 }/* CVC4 namespace */
 
@@ -199,6 +199,7 @@ public:
   OutputLanguage getOutputLanguage() const;
   bool getCheckProofs() const;
   bool getContinuedExecution() const;
+  bool getCubeAndConquer() const;
   bool getDumpInstantiations() const;
   bool getDumpModels() const;
   bool getDumpProofs() const;
@@ -223,11 +224,14 @@ public:
   bool getStatistics() const;
   bool getStatsEveryQuery() const;
   bool getStatsHideZeros() const;
+  bool getStatsBinary() const;
   bool getStrictParsing() const;
   int getTearDownIncremental() const;
+  bool getUnsatCores() const;
   bool getVersion() const;
   bool getWaitToJoin() const;
   const std::string& getForceLogicString() const;
+  const std::string& getStatsExport() const;
   const std::vector<std::string>& getThreadArgv() const;
   int getSharingFilterByLength() const;
   int getThreadId() const;
@@ -238,6 +242,9 @@ public:
   std::ostream* getOutConst() const; // TODO: Remove this.
   std::string getBinaryName() const;
   std::string getReplayInputFilename() const;
+  unsigned getCubeDepth() const;
+  unsigned long getCubeBudget() const;
+  unsigned long getPerCallResourceLimit() const;
   unsigned getParseStep() const;
   unsigned getThreadStackSize() const;
   unsigned getThreads() const;
@@ -1067,6 +1067,19 @@ void OptionsHandler::satSolverEnabledBuild(std::string option,
 #endif
 }
 
+void OptionsHandler::cadicalEnabledBuild(std::string option, bool value)
+{
+#ifndef CVC4_USE_CADICAL
+  if (value)
+  {
+    std::stringstream ss;
+    ss << "option `" << option
+       << "' requires a CVC4 to be built with CaDiCaL";
+    throw OptionException(ss.str());
+  }
+#endif
+}
+
 const std::string OptionsHandler::s_bvSatSolverHelp = "\
 Sat solvers currently supported by the --bv-sat-solver option:\n\
 \n\
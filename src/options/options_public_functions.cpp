@@ -58,6 +58,10 @@ bool Options::getContinuedExecution() const{
   return (*this)[options::continuedExecution];
 }
 
+bool Options::getCubeAndConquer() const{
+  return (*this)[options::cubeAndConquer];
+}
+
 bool Options::getDumpInstantiations() const{
   return (*this)[options::dumpInstantiations];
 }
@@ -154,6 +158,10 @@ bool Options::getStatsHideZeros() const{
   return (*this)[options::statsHideZeros];
 }
 
+bool Options::getStatsBinary() const{
+  return (*this)[options::statsBinary];
+}
+
 bool Options::getStrictParsing() const{
   return (*this)[options::strictParsing];
 }
@@ -162,6 +170,10 @@ int Options::getTearDownIncremental() const{
   return (*this)[options::tearDownIncremental];
 }
 
+bool Options::getUnsatCores() const{
+  return (*this)[options::unsatCores];
+}
+
 bool Options::getVersion() const{
   return (*this)[options::version];
 }
@@ -174,6 +186,10 @@ const std::string& Options::getForceLogicString() const{
   return (*this)[options::forceLogicString];
 }
 
+const std::string& Options::getStatsExport() const{
+  return (*this)[options::statsExport];
+}
+
 const std::vector<std::string>& Options::getThreadArgv() const{
   return (*this)[options::threadArgv];
 }
@@ -215,6 +231,18 @@ std::string Options::getReplayInputFilename() const{
   return (*this)[options::replayInputFilename];
 }
 
+unsigned Options::getCubeDepth() const{
+  return (*this)[options::cubeDepth];
+}
+
+unsigned long Options::getCubeBudget() const{
+  return (*this)[options::cubeBudget];
+}
+
+unsigned long Options::getPerCallResourceLimit() const{
+  return (*this)[options::perCallResourceLimit];
+}
+
 unsigned Options::getParseStep() const{
   return (*this)[options::parseStep];
 }
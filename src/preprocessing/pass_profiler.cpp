@@ -0,0 +1,231 @@
+/*********************                                                        */
+/*! \file pass_profiler.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Per-pass profile of the preprocessing pipeline
+ **
+ ** Per-pass profile of the preprocessing pipeline.
+ **/
+
+#include "preprocessing/pass_profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+
+#ifdef CVC4_PORTFOLIO
+#  include <atomic>
+#endif /* CVC4_PORTFOLIO */
+
+#include "base/output.h"
+#include "expr/node_manager.h"
+#include "preprocessing/preprocessing_pass.h"
+
+namespace CVC4 {
+namespace preprocessing {
+
+PassProfiler::PassProfile::PassProfile(const std::string& name)
+    : d_name(name),
+      d_invocations(0),
+      d_time(0),
+      d_assertionsBefore(0),
+      d_assertionsAfter(0),
+      d_dagSizeBefore(0),
+      d_dagSizeAfter(0),
+      d_assertionsChanged(0)
+{
+}
+
+PassProfiler::Scope::Scope(PassProfiler* profiler,
+                           const std::string& name,
+                           const AssertionPipeline& assertions)
+    : d_profiler(profiler),
+      d_name(name),
+      d_assertions(assertions),
+      d_dagSizeBefore(0)
+{
+  if (d_profiler != nullptr)
+  {
+    d_before = assertions.ref();
+    d_dagSizeBefore = dagSize(assertions, d_profiler->d_numWorkers);
+    d_start = std::chrono::steady_clock::now();
+  }
+}
+
+PassProfiler::Scope::~Scope()
+{
+  if (d_profiler == nullptr)
+  {
+    return;
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - d_start;
+  const std::vector<Node>& after = d_assertions.ref();
+
+  uint64_t changed = 0;
+  size_t common = std::min(d_before.size(), after.size());
+  for (size_t i = 0; i < common; ++i)
+  {
+    if (d_before[i] != after[i])
+    {
+      ++changed;
+    }
+  }
+  changed += std::max(d_before.size(), after.size()) - common;
+
+  PassProfile& p = d_profiler->getProfile(d_name);
+  ++p.d_invocations;
+  p.d_time += elapsed.count();
+  p.d_assertionsBefore += d_before.size();
+  p.d_assertionsAfter += after.size();
+  p.d_dagSizeBefore += d_dagSizeBefore;
+  p.d_dagSizeAfter += dagSize(d_assertions, d_profiler->d_numWorkers);
+  p.d_assertionsChanged += changed;
+}
+
+PassProfiler::PassProfiler(const std::string& filename, unsigned numWorkers)
+    : d_filename(filename), d_numWorkers(numWorkers)
+{
+}
+
+PassProfiler::PassProfile& PassProfiler::getProfile(const std::string& name)
+{
+  std::unordered_map<std::string, size_t>::const_iterator it =
+      d_index.find(name);
+  if (it != d_index.end())
+  {
+    return d_profiles[it->second];
+  }
+  d_index[name] = d_profiles.size();
+  d_profiles.push_back(PassProfile(name));
+  return d_profiles.back();
+}
+
+namespace {
+
+/* One bit per node id, set by whoever visits the node first */
+#ifdef CVC4_PORTFOLIO
+typedef std::atomic<uint64_t> VisitedWord;
+
+bool claim(VisitedWord& word, uint64_t bit)
+{
+  return (word.fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+}
+#else  /* CVC4_PORTFOLIO */
+typedef uint64_t VisitedWord;
+
+bool claim(VisitedWord& word, uint64_t bit)
+{
+  bool unclaimed = (word & bit) == 0;
+  word |= bit;
+  return unclaimed;
+}
+#endif /* CVC4_PORTFOLIO */
+
+/*
+ * Claims the nodes reachable from root that are not claimed yet and
+ * returns how many there were. Following an operator takes a Node
+ * reference, which a worker thread must not do, so if ops is non-null the
+ * parameterized nodes are collected there instead.
+ */
+uint64_t claimDag(TNode root, VisitedWord* visited, std::vector<TNode>* ops)
+{
+  uint64_t count = 0;
+  std::vector<TNode> toVisit(1, root);
+  while (!toVisit.empty())
+  {
+    TNode cur = toVisit.back();
+    toVisit.pop_back();
+    uint64_t id = cur.getId();
+    if (!claim(visited[id / 64], uint64_t(1) << (id % 64)))
+    {
+      continue;
+    }
+    ++count;
+    if (cur.getMetaKind() == kind::metakind::PARAMETERIZED)
+    {
+      if (ops != nullptr)
+      {
+        ops->push_back(cur);
+      }
+      else
+      {
+        toVisit.push_back(cur.getOperator());
+      }
+    }
+    toVisit.insert(toVisit.end(), cur.begin(), cur.end());
+  }
+  return count;
+}
+
+}  // namespace
+
+uint64_t PassProfiler::dagSize(const AssertionPipeline& assertions,
+                               unsigned numWorkers)
+{
+  numWorkers = std::max(numWorkers, 1u);
+  std::unique_ptr<VisitedWord[]> visited(
+      new VisitedWord[NodeManager::currentNM()->maxNodeId() / 64 + 1]());
+  std::vector<uint64_t> counts(numWorkers, 0);
+  std::vector<std::vector<TNode> > ops(numWorkers);
+  assertions.scanAssertions(
+      [&](unsigned w, TNode a) {
+        counts[w] += claimDag(a, visited.get(), &ops[w]);
+      },
+      numWorkers);
+
+  // back on this thread, follow the operators the workers left behind
+  uint64_t count = 0;
+  for (unsigned w = 0; w < numWorkers; ++w)
+  {
+    count += counts[w];
+    for (TNode n : ops[w])
+    {
+      Node op = n.getOperator();
+      count += claimDag(op, visited.get(), nullptr);
+    }
+  }
+  return count;
+}
+
+void PassProfiler::writeReport(std::ostream& out) const
+{
+  out << "{" << std::endl << "  \"passes\": [";
+  for (size_t i = 0; i < d_profiles.size(); ++i)
+  {
+    const PassProfile& p = d_profiles[i];
+    out << (i == 0 ? "" : ",") << std::endl
+        << "    {\"name\": \"" << p.d_name << "\""
+        << ", \"invocations\": " << p.d_invocations << ", \"time\": "
+        << std::fixed << std::setprecision(6) << p.d_time
+        << ", \"assertions-before\": " << p.d_assertionsBefore
+        << ", \"assertions-after\": " << p.d_assertionsAfter
+        << ", \"dag-size-before\": " << p.d_dagSizeBefore
+        << ", \"dag-size-after\": " << p.d_dagSizeAfter
+        << ", \"assertions-changed\": " << p.d_assertionsChanged << "}";
+  }
+  out << std::endl << "  ]" << std::endl << "}" << std::endl;
+}
+
+void PassProfiler::writeReport() const
+{
+  std::ofstream out(d_filename.c_str());
+  writeReport(out);
+  if (!out)
+  {
+    Warning() << "cannot write preprocessing profile to " << d_filename
+              << std::endl;
+  }
+}
+
+}  // namespace preprocessing
+}  // namespace CVC4
@@ -0,0 +1,113 @@
+/*********************                                                        */
+/*! \file pass_profiler.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Per-pass profile of the preprocessing pipeline
+ **
+ ** The pass profiler records, for each preprocessing pass (registered or
+ ** inline in SmtEnginePrivate), how often it ran, the wall-clock time it
+ ** took, the DAG size of the assertions before and after, and the number
+ ** of assertions it changed. The totals are written as JSON to the file
+ ** given with --preprocess-profile.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__PREPROCESSING__PASS_PROFILER_H
+#define __CVC4__PREPROCESSING__PASS_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "expr/node.h"
+
+namespace CVC4 {
+namespace preprocessing {
+
+class AssertionPipeline;
+
+class PassProfiler
+{
+ public:
+  /* Totals for one pass over all its invocations */
+  struct PassProfile
+  {
+    PassProfile(const std::string& name);
+
+    std::string d_name;
+    uint64_t d_invocations;
+    /* Wall-clock time in seconds, including any nested passes */
+    double d_time;
+    uint64_t d_assertionsBefore;
+    uint64_t d_assertionsAfter;
+    uint64_t d_dagSizeBefore;
+    uint64_t d_dagSizeAfter;
+    uint64_t d_assertionsChanged;
+  };
+
+  /*
+   * Profiles one invocation of a pass over the given pipeline for as long
+   * as it is in scope. A null profiler makes this a no-op, so call sites
+   * need not check whether profiling is on.
+   */
+  class Scope
+  {
+   public:
+    Scope(PassProfiler* profiler,
+          const std::string& name,
+          const AssertionPipeline& assertions);
+    ~Scope();
+
+   private:
+    PassProfiler* d_profiler;
+    const std::string d_name;
+    const AssertionPipeline& d_assertions;
+    /* The assertions as they were before the pass */
+    std::vector<Node> d_before;
+    uint64_t d_dagSizeBefore;
+    std::chrono::steady_clock::time_point d_start;
+  };
+
+  /*
+   * Write the profile to the given file name, counting DAG sizes with up
+   * to numWorkers threads
+   */
+  PassProfiler(const std::string& filename, unsigned numWorkers);
+
+  /* Write the current totals, in the order the passes first ran */
+  void writeReport(std::ostream& out) const;
+
+  /* Write the current totals to the file this profiler was created with */
+  void writeReport() const;
+
+  /*
+   * The number of distinct nodes in the given assertions, counted by up to
+   * numWorkers threads
+   */
+  static uint64_t dagSize(const AssertionPipeline& assertions,
+                          unsigned numWorkers);
+
+ private:
+  PassProfile& getProfile(const std::string& name);
+
+  std::string d_filename;
+  unsigned d_numWorkers;
+  std::vector<PassProfile> d_profiles;
+  std::unordered_map<std::string, size_t> d_index;
+};  // class PassProfiler
+
+}  // namespace preprocessing
+}  // namespace CVC4
+
+#endif /* __CVC4__PREPROCESSING__PASS_PROFILER_H */
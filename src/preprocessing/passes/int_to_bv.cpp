@@ -326,11 +326,8 @@ PreprocessingPassResult IntToBV::applyInternal(
     AssertionPipeline* assertionsToPreprocess)
 {
   unordered_map<Node, Node, NodeHashFunction> cache;
-  for (unsigned i = 0; i < assertionsToPreprocess->size(); ++i)
-  {
-    assertionsToPreprocess->replace(
-        i, intToBV((*assertionsToPreprocess)[i], cache));
-  }
+  assertionsToPreprocess->mapAssertions(
+      [&cache](TNode a) { return intToBV(a, cache); });
   return PreprocessingPassResult::NO_CONFLICT;
 }
 
@@ -57,6 +57,8 @@ void AssertionPipeline::replace(size_t i, const std::vector<Node>& ns)
 PreprocessingPassResult PreprocessingPass::apply(
     AssertionPipeline* assertionsToPreprocess) {
   TimerStat::CodeTimer codeTimer(d_timer);
+  PassProfiler::Scope profile(
+      d_preprocContext->getPassProfiler(), d_name, *assertionsToPreprocess);
   Trace("preprocessing") << "PRE " << d_name << std::endl;
   Chat() << d_name << "..." << std::endl;
   dumpAssertions(("pre-" + d_name).c_str(), *assertionsToPreprocess);
@@ -31,9 +31,15 @@
 #ifndef __CVC4__PREPROCESSING__PREPROCESSING_PASS_H
 #define __CVC4__PREPROCESSING__PREPROCESSING_PASS_H
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
+#ifdef CVC4_PORTFOLIO
+#  include <exception>
+#  include <thread>
+#endif /* CVC4_PORTFOLIO */
+
 #include "expr/node.h"
 #include "preprocessing/preprocessing_pass_context.h"
 #include "smt/smt_engine_scope.h"
@@ -80,6 +86,88 @@ class AssertionPipeline {
    * dependencies.
    */
   void replace(size_t i, const std::vector<Node>& ns);
+
+  /*
+   * Replaces each assertion a by f(a), for steps that look at one assertion
+   * at a time (rewriting, definition expansion and the like). Assertions
+   * that f leaves unchanged are not replaced.
+   *
+   * This runs on the calling thread: f builds nodes, and reference counts
+   * and attribute tables are not synchronized, so no preprocessing pass
+   * runs in parallel.
+   */
+  template <class F>
+  void mapAssertions(F f)
+  {
+    for (size_t i = 0, n = d_nodes.size(); i < n; ++i)
+    {
+      Node a = f(d_nodes[i]);
+      if (a != d_nodes[i])
+      {
+        replace(i, a);
+      }
+    }
+  }
+
+  /*
+   * Calls f(w, a) for each assertion a, for steps that only inspect the
+   * assertions; the only one so far is the DAG count of the pass profiler
+   * (--preprocess-profile). In builds with thread support the assertions
+   * are split into up to numWorkers contiguous chunks, each scanned by its
+   * own thread, and w < numWorkers identifies the worker of a chunk.
+   *
+   * Calls to f with different w run concurrently, so f may only read
+   * nodes through TNodes: it must not build nodes, hold Node references
+   * (including those returned by getOperator()) or look up attributes.
+   * An exception thrown by f is rethrown here once all workers are done.
+   */
+  template <class F>
+  void scanAssertions(F f, unsigned numWorkers) const
+  {
+#ifdef CVC4_PORTFOLIO
+    size_t workers = std::min<size_t>(numWorkers, d_nodes.size());
+    if (workers > 1)
+    {
+      size_t chunk = (d_nodes.size() + workers - 1) / workers;
+      std::vector<std::exception_ptr> errors(workers);
+      std::vector<std::thread> threads;
+      for (unsigned w = 0; w < workers; ++w)
+      {
+        threads.push_back(std::thread([this, &f, &errors, chunk, w]() {
+          NodeManager::ReadOnlyScope readOnly;
+          try
+          {
+            size_t end = std::min(d_nodes.size(), (w + 1) * chunk);
+            for (size_t i = w * chunk; i < end; ++i)
+            {
+              f(w, TNode(d_nodes[i]));
+            }
+          }
+          catch (...)
+          {
+            errors[w] = std::current_exception();
+          }
+        }));
+      }
+      for (std::thread& t : threads)
+      {
+        t.join();
+      }
+      for (const std::exception_ptr& e : errors)
+      {
+        if (e)
+        {
+          std::rethrow_exception(e);
+        }
+      }
+      return;
+    }
+#endif /* CVC4_PORTFOLIO */
+    for (const Node& a : d_nodes)
+    {
+      f(0, TNode(a));
+    }
+  }
 }; /* class AssertionPipeline */
 
 /**
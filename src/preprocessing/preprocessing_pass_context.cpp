@@ -16,11 +16,20 @@
 
 #include "preprocessing_pass_context.h"
 
+#include "options/smt_options.h"
+
 namespace CVC4 {
 namespace preprocessing {
 
 PreprocessingPassContext::PreprocessingPassContext(SmtEngine* smt)
-    : d_smt(smt) {}
+    : d_smt(smt)
+{
+  if (!options::preprocessProfile().empty())
+  {
+    d_profiler.reset(new PassProfiler(options::preprocessProfile(),
+                                     options::preprocessThreads()));
+  }
+}
 
 void PreprocessingPassContext::widenLogic(theory::TheoryId id)
 {
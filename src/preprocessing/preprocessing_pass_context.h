@@ -21,8 +21,11 @@
 #ifndef __CVC4__PREPROCESSING__PREPROCESSING_PASS_CONTEXT_H
 #define __CVC4__PREPROCESSING__PREPROCESSING_PASS_CONTEXT_H
 
+#include <memory>
+
 #include "context/context.h"
 #include "decision/decision_engine.h"
+#include "preprocessing/pass_profiler.h"
 #include "smt/smt_engine.h"
 #include "theory/theory_engine.h"
 
@@ -38,12 +41,17 @@ class PreprocessingPassContext {
   prop::PropEngine* getPropEngine() { return d_smt->d_propEngine; }
   context::Context* getUserContext() { return d_smt->d_userContext; }
 
+  /* The pass profiler, or nullptr if --preprocess-profile is not given. */
+  PassProfiler* getPassProfiler() { return d_profiler.get(); }
+
   /* Widen the logic to include the given theory. */
   void widenLogic(theory::TheoryId id);
 
  private:
   /* Pointer to the SmtEngine that this context was created in. */
   SmtEngine* d_smt;
+  /* Profile of the passes run in this context (may be null). */
+  std::unique_ptr<PassProfiler> d_profiler;
 };  // class PreprocessingPassContext
 
 }  // namespace preprocessing
@@ -11,7 +11,8 @@
  **
  ** \brief Wrapper for CaDiCaL SAT Solver.
  **
- ** Implementation of the CaDiCaL SAT solver for CVC4 (bitvectors).
+ ** Implementation of the CaDiCaL SAT solver for CVC4 (bitvectors), and of
+ ** a DPLL(T) solver on top of it.
  **/
 
 #include "prop/cadical.h"
@@ -19,6 +20,8 @@
 #ifdef CVC4_USE_CADICAL
 
 #include "proof/sat_proof.h"
+#include "prop/theory_proxy.h"
+#include "theory/theory.h"
 
 namespace CVC4 {
 namespace prop {
@@ -159,6 +162,238 @@ CadicalSolver::Statistics::~Statistics() {
   d_registry->unregisterStat(&d_solveTime);
 }
 
+/* -------------------------------------------------------------------------- */
+
+CadicalDPLLSolver::CadicalDPLLSolver(StatisticsRegistry* registry)
+    : d_solver(new CaDiCaL::Solver()),
+      d_context(nullptr),
+      d_proxy(nullptr),
+      d_nextVarIdx(1),
+      d_okay(true),
+      d_inCheck(false),
+      d_interrupted(false),
+      d_statistics(registry)
+{
+  d_true = newVar(false, false, false);
+  d_false = newVar(false, false, false);
+
+  d_solver->set("quiet", 1);
+  d_solver->add(toCadicalVar(d_true));
+  d_solver->add(0);
+  d_solver->add(-toCadicalVar(d_false));
+  d_solver->add(0);
+}
+
+CadicalDPLLSolver::~CadicalDPLLSolver() {}
+
+void CadicalDPLLSolver::initialize(context::Context* context,
+                                   TheoryProxy* theoryProxy)
+{
+  d_context = context;
+  d_proxy = theoryProxy;
+}
+
+ClauseId CadicalDPLLSolver::addClause(SatClause& clause, bool removable)
+{
+  if (d_inCheck)
+  {
+    // CaDiCaL only takes clauses between two solve() calls
+    d_lemmas.push_back(clause);
+    ++d_statistics.d_numLemmas;
+    return ClauseIdError;
+  }
+  for (const SatLiteral& lit : clause)
+  {
+    d_solver->add(toCadicalLit(lit));
+  }
+  d_solver->add(0);
+  ++d_statistics.d_numClauses;
+  return ClauseIdError;
+}
+
+ClauseId CadicalDPLLSolver::addXorClause(SatClause& clause,
+                                         bool rhs,
+                                         bool removable)
+{
+  Unreachable("CaDiCaL does not support adding XOR clauses.");
+}
+
+SatVariable CadicalDPLLSolver::newVar(bool isTheoryAtom,
+                                      bool preRegister,
+                                      bool canErase)
+{
+  SatVariable v = d_nextVarIdx++;
+  if (isTheoryAtom)
+  {
+    d_theoryAtoms.push_back(v);
+  }
+  if (preRegister && d_inCheck)
+  {
+    // Preregistration is undone along with the check level
+    d_toRegister.push_back(v);
+  }
+  ++d_statistics.d_numVariables;
+  return v;
+}
+
+SatVariable CadicalDPLLSolver::trueVar() { return d_true; }
+
+SatVariable CadicalDPLLSolver::falseVar() { return d_false; }
+
+SatValue CadicalDPLLSolver::solve()
+{
+  TimerStat::CodeTimer codeTimer(d_statistics.d_solveTime);
+  popCheck();
+  d_interrupted = false;
+  for (;;)
+  {
+    ++d_statistics.d_numSatCalls;
+    SatValue res = toSatValue(d_solver->solve());
+    if (res == SAT_VALUE_FALSE)
+    {
+      d_okay = false;
+    }
+    if (res != SAT_VALUE_TRUE || checkModel())
+    {
+      return res;
+    }
+    popCheck();
+    for (SatClause& lemma : d_lemmas)
+    {
+      addClause(lemma, true);
+    }
+    d_lemmas.clear();
+    d_proxy->spendResource(1);
+    if (d_interrupted)
+    {
+      return SAT_VALUE_UNKNOWN;
+    }
+  }
+}
+
+bool CadicalDPLLSolver::checkModel()
+{
+  // Variables CaDiCaL has not seen in any clause are unconstrained
+  d_model.assign(d_nextVarIdx, SAT_VALUE_UNKNOWN);
+  for (SatVariable v = 1, n = d_solver->vars(); v <= n; ++v)
+  {
+    d_model[v] = toSatValueLit(d_solver->val(toCadicalVar(v)));
+  }
+
+  ++d_statistics.d_numTheoryChecks;
+  d_context->push();
+  d_inCheck = true;
+  for (SatVariable v : d_theoryAtoms)
+  {
+    if (d_model[v] != SAT_VALUE_UNKNOWN)
+    {
+      d_proxy->enqueueTheoryLiteral(
+          SatLiteral(v, d_model[v] == SAT_VALUE_FALSE));
+    }
+  }
+  do
+  {
+    d_proxy->theoryCheck(theory::Theory::EFFORT_FULL);
+  } while (d_lemmas.empty() && d_proxy->theoryNeedCheck());
+  return d_lemmas.empty();
+}
+
+void CadicalDPLLSolver::popCheck()
+{
+  if (!d_inCheck)
+  {
+    return;
+  }
+  d_context->pop();
+  d_inCheck = false;
+  for (SatVariable v : d_toRegister)
+  {
+    d_proxy->variableNotify(v);
+  }
+  d_toRegister.clear();
+}
+
+SatValue CadicalDPLLSolver::solve(long unsigned int&)
+{
+  Unimplemented("Setting limits for CaDiCaL not supported yet");
+}
+
+void CadicalDPLLSolver::interrupt()
+{
+  d_interrupted = true;
+  d_solver->terminate();
+}
+
+SatValue CadicalDPLLSolver::value(SatLiteral l)
+{
+  SatVariable v = l.getSatVariable();
+  if (!d_inCheck || v >= d_model.size() || d_model[v] == SAT_VALUE_UNKNOWN)
+  {
+    return SAT_VALUE_UNKNOWN;
+  }
+  return l.isNegated() ? invertValue(d_model[v]) : d_model[v];
+}
+
+SatValue CadicalDPLLSolver::modelValue(SatLiteral l) { return value(l); }
+
+unsigned CadicalDPLLSolver::getAssertionLevel() const { return 0; }
+
+bool CadicalDPLLSolver::ok() const { return d_okay; }
+
+void CadicalDPLLSolver::push()
+{
+  Unimplemented("CaDiCaL as the DPLL(T) solver does not support push/pop");
+}
+
+void CadicalDPLLSolver::pop()
+{
+  Unimplemented("CaDiCaL as the DPLL(T) solver does not support push/pop");
+}
+
+void CadicalDPLLSolver::resetTrail() { popCheck(); }
+
+bool CadicalDPLLSolver::properExplanation(SatLiteral lit,
+                                          SatLiteral expl) const
+{
+  return true;
+}
+
+void CadicalDPLLSolver::requirePhase(SatLiteral lit)
+{
+  // CaDiCaL picks its own phases
+}
+
+bool CadicalDPLLSolver::flipDecision() { return false; }
+
+bool CadicalDPLLSolver::isDecision(SatVariable decn) const { return false; }
+
+CadicalDPLLSolver::Statistics::Statistics(StatisticsRegistry* registry)
+    : d_registry(registry),
+      d_numSatCalls("prop::cadical::calls_to_solve", 0),
+      d_numTheoryChecks("prop::cadical::theory_checks", 0),
+      d_numLemmas("prop::cadical::lemmas", 0),
+      d_numVariables("prop::cadical::variables", 0),
+      d_numClauses("prop::cadical::clauses", 0),
+      d_solveTime("prop::cadical::solve_time")
+{
+  d_registry->registerStat(&d_numSatCalls);
+  d_registry->registerStat(&d_numTheoryChecks);
+  d_registry->registerStat(&d_numLemmas);
+  d_registry->registerStat(&d_numVariables);
+  d_registry->registerStat(&d_numClauses);
+  d_registry->registerStat(&d_solveTime);
+}
+
+CadicalDPLLSolver::Statistics::~Statistics()
+{
+  d_registry->unregisterStat(&d_numSatCalls);
+  d_registry->unregisterStat(&d_numTheoryChecks);
+  d_registry->unregisterStat(&d_numLemmas);
+  d_registry->unregisterStat(&d_numVariables);
+  d_registry->unregisterStat(&d_numClauses);
+  d_registry->unregisterStat(&d_solveTime);
+}
+
 }  // namespace prop
 }  // namespace CVC4
 
@@ -11,7 +11,8 @@
  **
  ** \brief Wrapper for CaDiCaL SAT Solver.
  **
- ** Implementation of the CaDiCaL SAT solver for CVC4 (bitvectors).
+ ** Implementation of the CaDiCaL SAT solver for CVC4 (bitvectors), and of
+ ** a DPLL(T) solver on top of it.
  **/
 
 #include "cvc4_private.h"
@@ -21,6 +22,9 @@
 
 #ifdef CVC4_USE_CADICAL
 
+#include <vector>
+
+#include "context/context.h"
 #include "prop/sat_solver.h"
 
 #include <cadical.hpp>
@@ -83,6 +87,113 @@ class CadicalSolver : public SatSolver
   Statistics d_statistics;
 };
 
+/**
+ * CaDiCaL as the DPLL(T) solver of the PropEngine.
+ *
+ * CaDiCaL offers no hooks into its search, so the theories are consulted
+ * offline: each solve() asks CaDiCaL for a propositional model, asserts
+ * its theory literals in a fresh SAT context level and runs a full theory
+ * check.  The lemmas and conflicts the theories produce are added to
+ * CaDiCaL, which then searches again, keeping its learnt clauses, phases
+ * and inprocessing state; a model that yields no lemma is a model of the
+ * whole problem.  There are no theory propagations or theory decisions,
+ * and all lemmas are kept.  Push/pop and resource limits are not
+ * supported: SmtEngine::setDefaults() rejects --incremental, --rlimit and
+ * --rlimit-per with this solver before any of it is built.
+ */
+class CadicalDPLLSolver : public DPLLSatSolverInterface
+{
+ public:
+  CadicalDPLLSolver(StatisticsRegistry* registry);
+
+  ~CadicalDPLLSolver() override;
+
+  void initialize(context::Context* context, TheoryProxy* theoryProxy) override;
+
+  ClauseId addClause(SatClause& clause, bool removable) override;
+
+  ClauseId addXorClause(SatClause& clause, bool rhs, bool removable) override;
+
+  SatVariable newVar(bool isTheoryAtom,
+                     bool preRegister,
+                     bool canErase) override;
+
+  SatVariable trueVar() override;
+
+  SatVariable falseVar() override;
+
+  SatValue solve() override;
+
+  SatValue solve(long unsigned int&) override;
+
+  void interrupt() override;
+
+  SatValue value(SatLiteral l) override;
+
+  SatValue modelValue(SatLiteral l) override;
+
+  unsigned getAssertionLevel() const override;
+
+  bool ok() const override;
+
+  void push() override;
+
+  void pop() override;
+
+  void resetTrail() override;
+
+  bool properExplanation(SatLiteral lit, SatLiteral expl) const override;
+
+  void requirePhase(SatLiteral lit) override;
+
+  bool flipDecision() override;
+
+  bool isDecision(SatVariable decn) const override;
+
+ private:
+  /** Runs the theories on the current model; returns whether it stands. */
+  bool checkModel();
+
+  /** Leaves the context level of the last theory check, if any. */
+  void popCheck();
+
+  std::unique_ptr<CaDiCaL::Solver> d_solver;
+  context::Context* d_context;
+  TheoryProxy* d_proxy;
+
+  unsigned d_nextVarIdx;
+  bool d_okay;
+  SatVariable d_true;
+  SatVariable d_false;
+
+  /** The variables standing for theory atoms */
+  std::vector<SatVariable> d_theoryAtoms;
+  /** Variables to preregister again once the check level is popped */
+  std::vector<SatVariable> d_toRegister;
+  /** The values of the last model, by variable */
+  std::vector<SatValue> d_model;
+  /** Clauses added by the theories during a check, for the next round */
+  std::vector<SatClause> d_lemmas;
+  /** Whether the context holds the level of a theory check */
+  bool d_inCheck;
+  bool d_interrupted;
+
+  struct Statistics
+  {
+    StatisticsRegistry* d_registry;
+    IntStat d_numSatCalls;
+    IntStat d_numTheoryChecks;
+    IntStat d_numLemmas;
+    IntStat d_numVariables;
+    IntStat d_numClauses;
+    TimerStat d_solveTime;
+    Statistics(StatisticsRegistry* registry);
+    ~Statistics();
+  };
+
+  Statistics d_statistics;
+};
+
 }  // namespace prop
 }  // namespace CVC4
 
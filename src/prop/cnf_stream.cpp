@@ -30,6 +30,7 @@
 #include "proof/sat_proof.h"
 #include "prop/minisat/minisat.h"
 #include "prop/prop_engine.h"
+#include "prop/sat_trace_recorder.h"
 #include "prop/theory_proxy.h"
 #include "smt/command.h"
 #include "smt/smt_engine_scope.h"
@@ -49,18 +50,27 @@ CnfStream::CnfStream(SatSolver* satSolver, Registrar* registrar,
       d_booleanVariables(context),
       d_nodeToLiteralMap(context),
       d_literalToNodeMap(context),
+      d_retained(),
       d_fullLitToNodeMap(fullLitToNodeMap),
       d_convertAndAssertCounter(0),
       d_registrar(registrar),
       d_name(name),
       d_cnfProof(NULL),
-      d_removable(false) {
+      d_traceRecorder(NULL),
+      d_removable(false),
+      d_retaining(false),
+      d_defining(0) {
 }
 
 TseitinCnfStream::TseitinCnfStream(SatSolver* satSolver, Registrar* registrar,
                                    context::Context* context,
-                                   bool fullLitToNodeMap, std::string name)
-  : CnfStream(satSolver, registrar, context, fullLitToNodeMap, name)
+                                   bool fullLitToNodeMap, std::string name,
+                                   bool polarityAware, bool reuse)
+    : CnfStream(satSolver, registrar, context, fullLitToNodeMap, name),
+      d_polarityAware(polarityAware),
+      d_reuse(reuse),
+      d_unrevivable(),
+      d_polarities(context)
 {}
 
 void CnfStream::assertClause(TNode node, SatClause& c) {
@@ -81,7 +91,10 @@ void CnfStream::assertClause(TNode node, SatClause& c) {
 
   PROOF(if (d_cnfProof) d_cnfProof->pushCurrentDefinition(node););
 
-  ClauseId clause_id = d_satSolver->addClause(c, d_removable);
+  // A kept translation must keep its definition too
+  ClauseId clause_id = d_retaining && d_defining > 0 && isRetained(node)
+                           ? d_satSolver->addDefinitionClause(c)
+                           : d_satSolver->addClause(c, d_removable);
   if (clause_id == ClauseIdUndef) return; // nothing to store (no clause was added)
 
   PROOF
@@ -123,9 +136,14 @@ bool CnfStream::hasLiteral(TNode n) const {
 void TseitinCnfStream::ensureLiteral(TNode n, bool noPreregistration) {
   // These are not removable and have no proof ID
   d_removable = false;
+  d_retaining = false;
 
   Debug("cnf") << "ensureLiteral(" << n << ")" << endl;
   if(hasLiteral(n)) {
+    if (d_polarityAware) {
+      // The literal must be equivalent to n, not just imply or be implied
+      toCNF(n, false);
+    }
     SatLiteral lit = getLiteral(n);
     if(!d_literalToNodeMap.contains(lit)){
       // Store backward-mappings
@@ -186,6 +204,17 @@ SatLiteral CnfStream::newLiteral(TNode node, bool isTheoryAtom, bool preRegister
       }
     } else {
       lit = SatLiteral(d_satSolver->newVar(isTheoryAtom, preRegister, canEliminate));
+      if (d_traceRecorder != NULL && (isTheoryAtom || node.isVar())) {
+        d_traceRecorder->atom(lit.getSatVariable(), node);
+      }
+      // Kept translations never change, so that a kept subformula is
+      // revived with the literals of its kept definition
+      if (d_retaining && d_retained.find(node) == d_retained.end()
+          && (isTheoryAtom || node.isVar() || hasRetainedChildren(node))) {
+        RetainedLiteral retained = {lit, isTheoryAtom, preRegister};
+        d_retained[node] = retained;
+        d_satSolver->retainVar(lit.getSatVariable());
+      }
     }
     d_nodeToLiteralMap.insert(node, lit);
     d_nodeToLiteralMap.insert(node.notNode(), ~lit);
@@ -203,9 +232,11 @@ SatLiteral CnfStream::newLiteral(TNode node, bool isTheoryAtom, bool preRegister
   if (preRegister) {
     // In case we are re-entered due to lemmas, save our state
     bool backupRemovable = d_removable;
+    bool backupRetaining = d_retaining;
     // Should be fine since cnfProof current assertion is stack based.
     d_registrar->preRegister(node);
     d_removable = backupRemovable;
+    d_retaining = backupRetaining;
   }
 
   // Here, you can have it
@@ -214,6 +245,23 @@ SatLiteral CnfStream::newLiteral(TNode node, bool isTheoryAtom, bool preRegister
   return lit;
 }
 
+bool CnfStream::isRetained(TNode node) {
+  TNode atom = stripNot(node);
+  RetainedMap::const_iterator it = d_retained.find(atom);
+  return it != d_retained.end() && hasLiteral(atom)
+         && getLiteral(atom) == (*it).second.d_literal;
+}
+
+bool CnfStream::hasRetainedChildren(TNode node) {
+  for (TNode::const_iterator child = node.begin(), child_end = node.end();
+       child != child_end; ++child) {
+    if (!stripNot(*child).isConst() && !isRetained(*child)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 TNode CnfStream::getNode(const SatLiteral& literal) {
   Debug("cnf") << "getNode(" << literal << ")" << endl;
   Debug("cnf") << "getNode(" << literal << ") => " << d_literalToNodeMap[literal] << endl;
@@ -268,8 +316,8 @@ SatLiteral CnfStream::getLiteral(TNode node) {
   return literal;
 }
 
-SatLiteral TseitinCnfStream::handleXor(TNode xorNode) {
-  Assert(!hasLiteral(xorNode), "Atom already mapped!");
+SatLiteral TseitinCnfStream::handleXor(TNode xorNode, unsigned polarity) {
+  Assert(d_polarityAware || !hasLiteral(xorNode), "Atom already mapped!");
   Assert(xorNode.getKind() == XOR, "Expecting an XOR expression!");
   Assert(xorNode.getNumChildren() == 2, "Expecting exactly 2 children!");
   Assert(!d_removable, "Removable clauses can not contain Boolean structure");
@@ -279,16 +327,20 @@ SatLiteral TseitinCnfStream::handleXor(TNode xorNode) {
 
   SatLiteral xorLit = newLiteral(xorNode);
 
-  assertClause(xorNode.negate(), a, b, ~xorLit);
-  assertClause(xorNode.negate(), ~a, ~b, ~xorLit);
-  assertClause(xorNode, a, ~b, xorLit);
-  assertClause(xorNode, ~a, b, xorLit);
+  if (polarity & POLARITY_POS) {
+    assertClause(xorNode.negate(), a, b, ~xorLit);
+    assertClause(xorNode.negate(), ~a, ~b, ~xorLit);
+  }
+  if (polarity & POLARITY_NEG) {
+    assertClause(xorNode, a, ~b, xorLit);
+    assertClause(xorNode, ~a, b, xorLit);
+  }
 
   return xorLit;
 }
 
-SatLiteral TseitinCnfStream::handleOr(TNode orNode) {
-  Assert(!hasLiteral(orNode), "Atom already mapped!");
+SatLiteral TseitinCnfStream::handleOr(TNode orNode, unsigned polarity) {
+  Assert(d_polarityAware || !hasLiteral(orNode), "Atom already mapped!");
   Assert(orNode.getKind() == OR, "Expecting an OR expression!");
   Assert(orNode.getNumChildren() > 1, "Expecting more then 1 child!");
   Assert(!d_removable, "Removable clauses can not contain Boolean structure");
@@ -301,7 +353,7 @@ SatLiteral TseitinCnfStream::handleOr(TNode orNode) {
   TNode::const_iterator node_it_end = orNode.end();
   SatClause clause(n_children + 1);
   for(int i = 0; node_it != node_it_end; ++node_it, ++i) {
-    clause[i] = toCNF(*node_it);
+    clause[i] = toCNF(*node_it, false, polarity);
   }
 
   // Get the literal for this node
@@ -310,22 +362,26 @@ SatLiteral TseitinCnfStream::handleOr(TNode orNode) {
   // lit <- (a_1 | a_2 | a_3 | ... | a_n)
   // lit | ~(a_1 | a_2 | a_3 | ... | a_n)
   // (lit | ~a_1) & (lit | ~a_2) & (lit & ~a_3) & ... & (lit & ~a_n)
-  for(unsigned i = 0; i < n_children; ++i) {
-    assertClause(orNode, orLit, ~clause[i]);
+  if (polarity & POLARITY_NEG) {
+    for(unsigned i = 0; i < n_children; ++i) {
+      assertClause(orNode, orLit, ~clause[i]);
+    }
   }
 
   // lit -> (a_1 | a_2 | a_3 | ... | a_n)
   // ~lit | a_1 | a_2 | a_3 | ... | a_n
-  clause[n_children] = ~orLit;
-  // This needs to go last, as the clause might get modified by the SAT solver
-  assertClause(orNode.negate(), clause);
+  if (polarity & POLARITY_POS) {
+    clause[n_children] = ~orLit;
+    // This needs to go last, as the clause might get modified by the SAT solver
+    assertClause(orNode.negate(), clause);
+  }
 
   // Return the literal
   return orLit;
 }
 
-SatLiteral TseitinCnfStream::handleAnd(TNode andNode) {
-  Assert(!hasLiteral(andNode), "Atom already mapped!");
+SatLiteral TseitinCnfStream::handleAnd(TNode andNode, unsigned polarity) {
+  Assert(d_polarityAware || !hasLiteral(andNode), "Atom already mapped!");
   Assert(andNode.getKind() == AND, "Expecting an AND expression!");
   Assert(andNode.getNumChildren() > 1, "Expecting more than 1 child!");
   Assert(!d_removable, "Removable clauses can not contain Boolean structure");
@@ -338,7 +394,7 @@ SatLiteral TseitinCnfStream::handleAnd(TNode andNode) {
   TNode::const_iterator node_it_end = andNode.end();
   SatClause clause(n_children + 1);
   for(int i = 0; node_it != node_it_end; ++node_it, ++i) {
-    clause[i] = ~toCNF(*node_it);
+    clause[i] = ~toCNF(*node_it, false, polarity);
   }
 
   // Get the literal for this node
@@ -347,48 +403,57 @@ SatLiteral TseitinCnfStream::handleAnd(TNode andNode) {
   // lit -> (a_1 & a_2 & a_3 & ... & a_n)
   // ~lit | (a_1 & a_2 & a_3 & ... & a_n)
   // (~lit | a_1) & (~lit | a_2) & ... & (~lit | a_n)
-  for(unsigned i = 0; i < n_children; ++i) {
-    assertClause(andNode.negate(), ~andLit, ~clause[i]);
+  if (polarity & POLARITY_POS) {
+    for(unsigned i = 0; i < n_children; ++i) {
+      assertClause(andNode.negate(), ~andLit, ~clause[i]);
+    }
   }
 
   // lit <- (a_1 & a_2 & a_3 & ... a_n)
   // lit | ~(a_1 & a_2 & a_3 & ... & a_n)
   // lit | ~a_1 | ~a_2 | ~a_3 | ... | ~a_n
-  clause[n_children] = andLit;
-  // This needs to go last, as the clause might get modified by the SAT solver
-  assertClause(andNode, clause);
+  if (polarity & POLARITY_NEG) {
+    clause[n_children] = andLit;
+    // This needs to go last, as the clause might get modified by the SAT solver
+    assertClause(andNode, clause);
+  }
 
   return andLit;
 }
 
-SatLiteral TseitinCnfStream::handleImplies(TNode impliesNode) {
-  Assert(!hasLiteral(impliesNode), "Atom already mapped!");
+SatLiteral TseitinCnfStream::handleImplies(TNode impliesNode,
+                                           unsigned polarity) {
+  Assert(d_polarityAware || !hasLiteral(impliesNode), "Atom already mapped!");
   Assert(impliesNode.getKind() == IMPLIES, "Expecting an IMPLIES expression!");
   Assert(impliesNode.getNumChildren() == 2, "Expecting exactly 2 children!");
   Assert(!d_removable, "Removable clauses can not contain Boolean structure");
 
   // Convert the children to cnf
-  SatLiteral a = toCNF(impliesNode[0]);
-  SatLiteral b = toCNF(impliesNode[1]);
+  SatLiteral a = toCNF(impliesNode[0], false, flipPolarity(polarity));
+  SatLiteral b = toCNF(impliesNode[1], false, polarity);
 
   SatLiteral impliesLit = newLiteral(impliesNode);
 
   // lit -> (a->b)
   // ~lit | ~ a | b
-  assertClause(impliesNode.negate(), ~impliesLit, ~a, b);
+  if (polarity & POLARITY_POS) {
+    assertClause(impliesNode.negate(), ~impliesLit, ~a, b);
+  }
 
   // (a->b) -> lit
   // ~(~a | b) | lit
   // (a | l) & (~b | l)
-  assertClause(impliesNode, a, impliesLit);
-  assertClause(impliesNode, ~b, impliesLit);
+  if (polarity & POLARITY_NEG) {
+    assertClause(impliesNode, a, impliesLit);
+    assertClause(impliesNode, ~b, impliesLit);
+  }
 
   return impliesLit;
 }
 
 
-SatLiteral TseitinCnfStream::handleIff(TNode iffNode) {
-  Assert(!hasLiteral(iffNode), "Atom already mapped!");
+SatLiteral TseitinCnfStream::handleIff(TNode iffNode, unsigned polarity) {
+  Assert(d_polarityAware || !hasLiteral(iffNode), "Atom already mapped!");
   Assert(iffNode.getKind() == EQUAL, "Expecting an EQUAL expression!");
   Assert(iffNode.getNumChildren() == 2, "Expecting exactly 2 children!");
 
@@ -404,32 +469,35 @@ SatLiteral TseitinCnfStream::handleIff(TNode iffNode) {
   // lit -> ((a-> b) & (b->a))
   // ~lit | ((~a | b) & (~b | a))
   // (~a | b | ~lit) & (~b | a | ~lit)
-  assertClause(iffNode.negate(), ~a, b, ~iffLit);
-  assertClause(iffNode.negate(), a, ~b, ~iffLit);
+  if (polarity & POLARITY_POS) {
+    assertClause(iffNode.negate(), ~a, b, ~iffLit);
+    assertClause(iffNode.negate(), a, ~b, ~iffLit);
+  }
 
   // (a<->b) -> lit
   // ~((a & b) | (~a & ~b)) | lit
   // (~(a & b)) & (~(~a & ~b)) | lit
   // ((~a | ~b) & (a | b)) | lit
   // (~a | ~b | lit) & (a | b | lit)
-  assertClause(iffNode, ~a, ~b, iffLit);
-  assertClause(iffNode, a, b, iffLit);
+  if (polarity & POLARITY_NEG) {
+    assertClause(iffNode, ~a, ~b, iffLit);
+    assertClause(iffNode, a, b, iffLit);
+  }
 
   return iffLit;
 }
 
 
-SatLiteral TseitinCnfStream::handleNot(TNode notNode) {
-  Assert(!hasLiteral(notNode), "Atom already mapped!");
+SatLiteral TseitinCnfStream::handleNot(TNode notNode, unsigned polarity) {
   Assert(notNode.getKind() == NOT, "Expecting a NOT expression!");
   Assert(notNode.getNumChildren() == 1, "Expecting exactly 1 child!");
 
-  SatLiteral notLit = ~toCNF(notNode[0]);
+  SatLiteral notLit = ~toCNF(notNode[0], false, flipPolarity(polarity));
 
   return notLit;
 }
 
-SatLiteral TseitinCnfStream::handleIte(TNode iteNode) {
+SatLiteral TseitinCnfStream::handleIte(TNode iteNode, unsigned polarity) {
   Assert(iteNode.getKind() == ITE);
   Assert(iteNode.getNumChildren() == 3);
   Assert(!d_removable, "Removable clauses can not contain Boolean structure");
@@ -437,8 +505,8 @@ SatLiteral TseitinCnfStream::handleIte(TNode iteNode) {
   Debug("cnf") << "handleIte(" << iteNode[0] << " " << iteNode[1] << " " << iteNode[2] << ")" << endl;
 
   SatLiteral condLit = toCNF(iteNode[0]);
-  SatLiteral thenLit = toCNF(iteNode[1]);
-  SatLiteral elseLit = toCNF(iteNode[2]);
+  SatLiteral thenLit = toCNF(iteNode[1], false, polarity);
+  SatLiteral elseLit = toCNF(iteNode[2], false, polarity);
 
   SatLiteral iteLit = newLiteral(iteNode);
 
@@ -448,9 +516,11 @@ SatLiteral TseitinCnfStream::handleIte(TNode iteNode) {
   // lit -> (t | e) & (b -> t) & (!b -> e)
   // lit -> (t | e) & (!b | t) & (b | e)
   // (!lit | t | e) & (!lit | !b | t) & (!lit | b | e)
-  assertClause(iteNode.negate(), ~iteLit, thenLit, elseLit);
-  assertClause(iteNode.negate(), ~iteLit, ~condLit, thenLit);
-  assertClause(iteNode.negate(), ~iteLit, condLit, elseLit);
+  if (polarity & POLARITY_POS) {
+    assertClause(iteNode.negate(), ~iteLit, thenLit, elseLit);
+    assertClause(iteNode.negate(), ~iteLit, ~condLit, thenLit);
+    assertClause(iteNode.negate(), ~iteLit, condLit, elseLit);
+  }
 
   // If ITE is false then one of the branches is false and the condition
   // implies which one
@@ -458,69 +528,199 @@ SatLiteral TseitinCnfStream::handleIte(TNode iteNode) {
   // !lit -> (!t | !e) & (b -> !t) & (!b -> !e)
   // !lit -> (!t | !e) & (!b | !t) & (b | !e)
   // (lit | !t | !e) & (lit | !b | !t) & (lit | b | !e)
-  assertClause(iteNode, iteLit, ~thenLit, ~elseLit);
-  assertClause(iteNode, iteLit, ~condLit, ~thenLit);
-  assertClause(iteNode, iteLit, condLit, ~elseLit);
+  if (polarity & POLARITY_NEG) {
+    assertClause(iteNode, iteLit, ~thenLit, ~elseLit);
+    assertClause(iteNode, iteLit, ~condLit, ~thenLit);
+    assertClause(iteNode, iteLit, condLit, ~elseLit);
+  }
 
   return iteLit;
 }
 
 
-SatLiteral TseitinCnfStream::toCNF(TNode node, bool negated) {
+SatLiteral TseitinCnfStream::toCNF(TNode node, bool negated,
+                                   unsigned polarity) {
   Debug("cnf") << "toCNF(" << node << ", negated = " << (negated ? "true" : "false") << ")" << endl;
 
   SatLiteral nodeLit;
   Node negatedNode = node.notNode();
 
-  // If the non-negated node has already been translated, get the translation
-  if(hasLiteral(node)) {
+  if (!d_polarityAware) {
+    polarity = POLARITY_BOTH;
+  }
+
+  ++d_defining;
+  if (d_polarityAware && node.getKind() == NOT) {
+    // Look through the negation, the child may need the other half of its
+    // definition
+    nodeLit = handleNot(node, polarity);
+  } else if(hasLiteral(node) && (polarity & ~definedPolarity(node)) == 0) {
+    // If the non-negated node has already been translated, get the translation
     Debug("cnf") << "toCNF(): already translated" << endl;
     nodeLit = getLiteral(node);
+  } else if (d_retaining && !hasLiteral(node) && reviveRetained(node)) {
+    // Translated at a popped level, with the definition still around
+    Debug("cnf") << "toCNF(): revived" << endl;
+    nodeLit = getLiteral(node);
   } else {
+    // Only add the halves of the definition that are missing
+    unsigned defined = hasLiteral(node) ? definedPolarity(node) : 0;
+    polarity &= ~defined;
+    bool connective = true;
+
     // Handle each Boolean operator case
     switch(node.getKind()) {
     case NOT:
-      nodeLit = handleNot(node);
+      nodeLit = handleNot(node, polarity);
       break;
     case XOR:
-      nodeLit = handleXor(node);
+      nodeLit = handleXor(node, polarity);
       break;
     case ITE:
-      nodeLit = handleIte(node);
+      nodeLit = handleIte(node, polarity);
       break;
     case IMPLIES:
-      nodeLit = handleImplies(node);
+      nodeLit = handleImplies(node, polarity);
       break;
     case OR:
-      nodeLit = handleOr(node);
+      nodeLit = handleOr(node, polarity);
       break;
     case AND:
-      nodeLit = handleAnd(node);
+      nodeLit = handleAnd(node, polarity);
       break;
     case EQUAL:
       if(node[0].getType().isBoolean()) {
-        nodeLit = handleIff(node);
+        nodeLit = handleIff(node, polarity);
       } else {
         nodeLit = convertAtom(node);
+        connective = false;
       }
       break;
     default:
       {
         //TODO make sure this does not contain any boolean substructure
         nodeLit = convertAtom(node);
+        connective = false;
         //Unreachable();
         //Node atomic = handleNonAtomicNode(node);
         //return isCached(atomic) ? lookupInCache(atomic) : convertAtom(atomic);
       }
       break;
     }
+
+    if (d_polarityAware && connective) {
+      d_polarities.insert(node, defined | polarity);
+    }
   }
+  --d_defining;
 
   // Return the appropriate (negated) literal
   if (!negated) return nodeLit;
   else return ~nodeLit;
 }
 
+bool TseitinCnfStream::reviveRetained(TNode node) {
+  NodeSet visited;
+  if (!revivable(node, visited)) {
+    return false;
+  }
+  std::vector<TNode> preRegister;
+  revive(node, preRegister);
+  // Only now, as pre-registration may translate lemmas that share the
+  // subformulas
+  bool backupRemovable = d_removable;
+  bool backupRetaining = d_retaining;
+  for (const TNode& atom : preRegister) {
+    d_registrar->preRegister(atom);
+  }
+  d_removable = backupRemovable;
+  d_retaining = backupRetaining;
+  return true;
+}
+
+bool TseitinCnfStream::revivable(TNode node, NodeSet& visited) {
+  node = stripNot(node);
+  if (node.isConst()) {
+    return true;
+  }
+  RetainedMap::const_iterator it = d_retained.find(node);
+  if (it == d_retained.end()) {
+    return false;
+  }
+  if (hasLiteral(node)) {
+    // The kept definitions of the parents use the kept literal
+    return getLiteral(node) == (*it).second.d_literal;
+  }
+  if (d_unrevivable.find(node) != d_unrevivable.end()) {
+    return false;
+  }
+  if (!visited.insert(node).second) {
+    return true;
+  }
+  bool result = true;
+  if ((*it).second.d_theoryAtom) {
+    result = d_satSolver->value((*it).second.d_literal) == SAT_VALUE_UNKNOWN;
+  } else if (!node.isVar()) {
+    for (TNode::const_iterator child = node.begin(), child_end = node.end();
+         result && child != child_end; ++child) {
+      result = revivable(*child, visited);
+    }
+  }
+  if (!result) {
+    d_unrevivable.insert(node);
+  }
+  return result;
+}
+
+void TseitinCnfStream::revive(TNode node, std::vector<TNode>& preRegister) {
+  node = stripNot(node);
+  if (hasLiteral(node)) {
+    return;
+  }
+  if (node.isConst()) {
+    newLiteral(node);
+    return;
+  }
+  Assert(d_retained.find(node) != d_retained.end());
+  RetainedLiteral retained = d_retained[node];
+  if (!retained.d_theoryAtom) {
+    if (node.isVar()) {
+      d_booleanVariables.push_back(node);
+    } else {
+      for (TNode::const_iterator child = node.begin(), child_end = node.end();
+           child != child_end; ++child) {
+        revive(*child, preRegister);
+      }
+    }
+  }
+
+  SatLiteral lit = retained.d_literal;
+  d_nodeToLiteralMap.insert(node, lit);
+  d_nodeToLiteralMap.insert(node.notNode(), ~lit);
+  if (retained.d_theoryAtom || d_fullLitToNodeMap || Dump.isOn("clauses")) {
+    d_literalToNodeMap.insert_safe(lit, node);
+    d_literalToNodeMap.insert_safe(~lit, node.notNode());
+  }
+  d_satSolver->reviveVar(
+      lit.getSatVariable(), retained.d_theoryAtom, retained.d_preRegister);
+  if (retained.d_preRegister) {
+    preRegister.push_back(node);
+  }
+  Debug("cnf") << "revive(" << node << ") => " << lit << endl;
+}
+
+unsigned TseitinCnfStream::definedPolarity(TNode node) const {
+  Assert(hasLiteral(node));
+  if (d_polarityAware) {
+    PolarityMap::const_iterator it = d_polarities.find(node);
+    if (it != d_polarities.end()) {
+      return (*it).second;
+    }
+  }
+  // Atoms, and subformulas translated without polarities
+  return POLARITY_BOTH;
+}
+
 void TseitinCnfStream::convertAndAssertAnd(TNode node, bool negated) {
   Assert(node.getKind() == AND);
   if (!negated) {
@@ -537,7 +737,7 @@ void TseitinCnfStream::convertAndAssertAnd(TNode node, bool negated) {
     TNode::const_iterator disjunct = node.begin();
     for(int i = 0; i < nChildren; ++ disjunct, ++ i) {
       Assert( disjunct != node.end() );
-      clause[i] = toCNF(*disjunct, true);
+      clause[i] = toClauseLiteral(*disjunct, true);
     }
     Assert(disjunct == node.end());
     assertClause(node.negate(), clause);
@@ -553,7 +753,7 @@ void TseitinCnfStream::convertAndAssertOr(TNode node, bool negated) {
     TNode::const_iterator disjunct = node.begin();
     for(int i = 0; i < nChildren; ++ disjunct, ++ i) {
       Assert( disjunct != node.end() );
-      clause[i] = toCNF(*disjunct, false);
+      clause[i] = toClauseLiteral(*disjunct, false);
     }
     Assert(disjunct == node.end());
     assertClause(node, clause);
@@ -630,11 +830,11 @@ void TseitinCnfStream::convertAndAssertIff(TNode node, bool negated) {
 void TseitinCnfStream::convertAndAssertImplies(TNode node, bool negated) {
   if (!negated) {
     // p => q
-    SatLiteral p = toCNF(node[0], false);
-    SatLiteral q = toCNF(node[1], false);
+    SatLiteral p = toClauseLiteral(node[0], true);
+    SatLiteral q = toClauseLiteral(node[1], false);
     // Construct the clause ~p || q
     SatClause clause(2);
-    clause[0] = ~p;
+    clause[0] = p;
     clause[1] = q;
     assertClause(node, clause);
   } else {// Construct the
@@ -649,8 +849,8 @@ void TseitinCnfStream::convertAndAssertImplies(TNode node, bool negated) {
 void TseitinCnfStream::convertAndAssertIte(TNode node, bool negated) {
   // ITE(p, q, r)
   SatLiteral p = toCNF(node[0], false);
-  SatLiteral q = toCNF(node[1], negated);
-  SatLiteral r = toCNF(node[2], negated);
+  SatLiteral q = toClauseLiteral(node[1], negated);
+  SatLiteral r = toClauseLiteral(node[2], negated);
   // Construct the clauses:
   // (p => q) and (!p => r)
   Node nnode = node;
@@ -679,6 +879,10 @@ void TseitinCnfStream::convertAndAssert(TNode node,
                << ", removable = " << (removable ? "true" : "false")
                << ", negated = " << (negated ? "true" : "false") << ")" << endl;
   d_removable = removable;
+  // Input assertions are converted outside of search, when the SAT solver
+  // can take definitions below the assertion level
+  d_retaining = d_reuse && !removable && proof_id == RULE_GIVEN;
+  d_unrevivable.clear();
   PROOF
     (if (d_cnfProof) {
       Node assertion = negated ? node.notNode() : (Node)node;
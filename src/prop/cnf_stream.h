@@ -25,6 +25,10 @@
 #ifndef __CVC4__PROP__CNF_STREAM_H
 #define __CVC4__PROP__CNF_STREAM_H
 
+#include <unordered_map>
+#include <unordered_set>
+
+#include "context/cdhashmap.h"
 #include "context/cdinsert_hashmap.h"
 #include "context/cdlist.h"
 #include "expr/node.h"
@@ -38,6 +42,7 @@ namespace CVC4 {
 namespace prop {
 
 class PropEngine;
+class SatTraceRecorder;
 
 /**
  * Comments for the behavior of the whole class... [??? -Chris]
@@ -66,6 +71,25 @@ class CnfStream {
   /** Map from literals to nodes */
   LiteralToNodeMap d_literalToNodeMap;
 
+  /** A literal kept for a node across user pops, and how it was made */
+  struct RetainedLiteral
+  {
+    SatLiteral d_literal;
+    bool d_theoryAtom;
+    bool d_preRegister;
+  };
+
+  typedef std::unordered_map<Node, RetainedLiteral, NodeHashFunction>
+      RetainedMap;
+
+  /**
+   * The translations made while d_retaining, which unlike the maps above
+   * survive the pop of the user level they were made at: the SAT solver
+   * keeps their variables and definitional clauses.  A subformula is only
+   * kept if its children are, and its first kept translation stays.
+   */
+  RetainedMap d_retained;
+
   /**
    * True if the lit-to-Node map should be kept for all lits, not just
    * theory lits.  This is true if e.g. replay logging is on, which
@@ -88,6 +112,9 @@ class CnfStream {
   /** Pointer to the proof corresponding to this CnfStream */
   CnfProof* d_cnfProof;
 
+  /** Where to record the atoms of new variables, if anywhere */
+  SatTraceRecorder* d_traceRecorder;
+
   /**
    * How many literals were already mapped at the top-level when we
    * tried to convertAndAssert() something.  This
@@ -123,6 +150,30 @@ class CnfStream {
    */
   bool d_removable;
 
+  /**
+   * Whether the translations made now are to be kept across pops.  This
+   * is set at the beginning of convertAndAssert, like d_removable.
+   */
+  bool d_retaining;
+
+  /**
+   * The number of subformula translations in progress: the clauses
+   * asserted within one define the subformula.
+   */
+  unsigned d_defining;
+
+  /**
+   * Whether node, or the atom it negates, has a kept translation that is
+   * also its current one.
+   */
+  bool isRetained(TNode node);
+
+  /**
+   * Whether the subformulas of node have kept translations, which are
+   * also their current ones.
+   */
+  bool hasRetainedChildren(TNode node);
+
   /**
    * Asserts the given clause to the sat solver.
    * @param node the node giving rise to this clause
@@ -253,6 +304,12 @@ class CnfStream {
   const LiteralToNodeMap& getNodeCache() const { return d_literalToNodeMap; }
 
   void setProof(CnfProof* proof);
+
+  /** Records the atom of each new variable in the given trace (not owned) */
+  void setTraceRecorder(SatTraceRecorder* recorder)
+  {
+    d_traceRecorder = recorder;
+  }
 }; /* class CnfStream */
 
 /**
@@ -264,6 +321,12 @@ class CnfStream {
  * recursively.
  *
  * This implementation does this in a single recursive pass. [??? -Chris]
+ *
+ * In polarity-aware mode (Plaisted-Greenbaum), a subformula only gets the
+ * half of its definition that its occurrences need: l -> phi where it
+ * occurs positively, phi -> l where it occurs negatively.  The other half
+ * is added once the subformula shows up with the other polarity, and
+ * ensureLiteral() always asks for both.
  */
 class TseitinCnfStream : public CnfStream {
  public:
@@ -275,10 +338,15 @@ class TseitinCnfStream : public CnfStream {
    * @param context the context that the CNF should respect.
    * @param fullLitToNodeMap maintain a full SAT-literal-to-Node mapping,
    * even for non-theory literals
+   * @param polarityAware only define subformulas in the polarities they
+   * occur in
+   * @param reuse keep the translations of input assertions across pops,
+   * to revive them when the same subformulas are asserted again
    */
   TseitinCnfStream(SatSolver* satSolver, Registrar* registrar,
                    context::Context* context, bool fullLitToNodeMap = false,
-                   std::string name = "");
+                   std::string name = "", bool polarityAware = false,
+                   bool reuse = false);
 
   /**
    * Convert a given formula to CNF and assert it to the SAT solver.
@@ -293,6 +361,20 @@ class TseitinCnfStream : public CnfStream {
                         TNode from = TNode::null()) override;
 
  private:
+  /**
+   * The halves of a subformula's definition: POLARITY_POS is l -> phi,
+   * POLARITY_NEG is phi -> l.
+   */
+  enum Polarity
+  {
+    POLARITY_POS = 1,
+    POLARITY_NEG = 2,
+    POLARITY_BOTH = 3
+  };
+
+  /** The halves of the definitions asserted so far, by subformula */
+  typedef context::CDHashMap<Node, unsigned, NodeHashFunction> PolarityMap;
+
   /**
    * Same as above, except that removable is remembered.
    */
@@ -307,14 +389,16 @@ class TseitinCnfStream : public CnfStream {
   //   - calling toCNF on its children (if necessary)
   //   - returning l
   //
-  // handleX( n ) can assume that n is not in d_translationCache
-  SatLiteral handleNot(TNode node);
-  SatLiteral handleXor(TNode node);
-  SatLiteral handleImplies(TNode node);
-  SatLiteral handleIff(TNode node);
-  SatLiteral handleIte(TNode node);
-  SatLiteral handleAnd(TNode node);
-  SatLiteral handleOr(TNode node);
+  // handleX( n ) can assume that n is not in d_translationCache, unless
+  // polarity asks for a half of the definition that n does not have yet;
+  // only the clauses for that half are added.
+  SatLiteral handleNot(TNode node, unsigned polarity);
+  SatLiteral handleXor(TNode node, unsigned polarity);
+  SatLiteral handleImplies(TNode node, unsigned polarity);
+  SatLiteral handleIff(TNode node, unsigned polarity);
+  SatLiteral handleIte(TNode node, unsigned polarity);
+  SatLiteral handleAnd(TNode node, unsigned polarity);
+  SatLiteral handleOr(TNode node, unsigned polarity);
 
   void convertAndAssertAnd(TNode node, bool negated);
   void convertAndAssertOr(TNode node, bool negated);
@@ -327,12 +411,74 @@ class TseitinCnfStream : public CnfStream {
    * Transforms the node into CNF recursively.
    * @param node the formula to transform
    * @param negated whether the literal is negated
+   * @param polarity the halves of the definition of node that are needed
+   * (ignored unless the stream is polarity-aware)
    * @return the literal representing the root of the formula
    */
-  SatLiteral toCNF(TNode node, bool negated = false);
+  SatLiteral toCNF(TNode node,
+                   bool negated = false,
+                   unsigned polarity = POLARITY_BOTH);
+
+  /**
+   * The literal for node (negated if negated) to use in a clause, with
+   * the half of node's definition that such an occurrence needs.
+   */
+  SatLiteral toClauseLiteral(TNode node, bool negated)
+  {
+    return toCNF(node, negated, negated ? POLARITY_NEG : POLARITY_POS);
+  }
+
+  /** The halves of the definition of node asserted so far */
+  unsigned definedPolarity(TNode node) const;
+
+  /** The polarity of a subformula occurring negated under the given one */
+  static unsigned flipPolarity(unsigned polarity)
+  {
+    return ((polarity & POLARITY_POS) ? POLARITY_NEG : 0)
+           | ((polarity & POLARITY_NEG) ? POLARITY_POS : 0);
+  }
 
   void ensureLiteral(TNode n, bool noPreregistration = false) override;
 
+  typedef std::unordered_set<Node, NodeHashFunction> NodeSet;
+
+  /**
+   * Puts the kept translation of node back in the maps, if node and all
+   * its subformulas have one, and returns whether it did.
+   */
+  bool reviveRetained(TNode node);
+
+  /**
+   * Whether the kept translation of node can be revived: it has one, as
+   * do its subformulas, and its theory atoms are unassigned (the theories
+   * must see their assignments).
+   */
+  bool revivable(TNode node, NodeSet& visited);
+
+  /**
+   * Revives the kept translation of a revivable node, collecting the
+   * atoms to pre-register once the whole translation is back.
+   */
+  void revive(TNode node, std::vector<TNode>& preRegister);
+
+  /** Whether subformulas are only defined in the polarities they occur in */
+  const bool d_polarityAware;
+
+  /** Whether the translations of input assertions are kept across pops */
+  const bool d_reuse;
+
+  /**
+   * Nodes found not revivable during the current convertAndAssert, so
+   * that each subformula is looked at once.
+   */
+  NodeSet d_unrevivable;
+
+  /**
+   * For polarity-aware conversion, the halves of the definition of each
+   * subformula translated so far.
+   */
+  PolarityMap d_polarities;
+
 }; /* class TseitinCnfStream */
 
 } /* CVC4::prop namespace */
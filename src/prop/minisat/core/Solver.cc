@@ -35,6 +35,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "proof/sat_proof_implementation.h"
 #include "prop/minisat/minisat.h"
 #include "prop/minisat/mtl/Sort.h"
+#include "prop/sat_trace_recorder.h"
 #include "prop/theory_proxy.h"
 
 using namespace CVC4::prop;
@@ -100,6 +101,7 @@ public:
 Solver::Solver(CVC4::prop::TheoryProxy* proxy, CVC4::context::Context* context, bool enable_incremental) :
     proxy(proxy)
   , context(context)
+  , trace(NULL)
   , assertionLevel(0)
   , enable_incremental(enable_incremental)
   , minisat_busy(false)
@@ -127,11 +129,31 @@ Solver::Solver(CVC4::prop::TheoryProxy* proxy, CVC4::context::Context* context,
     //
   , learntsize_adjust_start_confl (100)
   , learntsize_adjust_inc         (1.5)
+  , lbd_tiers                     (false)
+  , lbd_core                      (2)
+  , lbd_tier2                     (6)
+  , reduce_first                  (2000)
+  , reduce_inc                    (300)
+  , glucose_restart               (false)
+  , restart_margin                (1.25)
+  , restart_min_confl             (50)
+  , chrono                        (-1)
+  , use_inprocess                 (false)
+  , inprocess_interval            (10000)
+  , vivify_effort                 (10)
+  , subsume_effort                (10)
+  , trail_saving                  (false)
+  , retain_vars                   (false)
 
     // Statistics: (formerly in 'SolverStats')
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0), resources_consumed(0)
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , chrono_backtracks(0)
+  , inprocessings(0), vivified_clauses(0), vivified_literals(0), subsumed_clauses(0)
+  , replayed_literals(0), replay_conflicts(0)
+  , revived_vars(0)
+  , explanation_cache_hits(0)
 
   , ok                 (true)
   , cla_inc            (1)
@@ -143,6 +165,18 @@ Solver::Solver(CVC4::prop::TheoryProxy* proxy, CVC4::context::Context* context,
   , order_heap         (VarOrderLt(activity))
   , progress_estimate  (0)
   , remove_satisfied   (!enable_incremental)
+  , lbd_stamp          (0)
+  , next_reduce_confl  (reduce_first)
+  , reduce_interval    (reduce_first)
+  , lbd_ema_fast       (0)
+  , lbd_ema_slow       (0)
+  , next_inprocess_confl (0)
+  , inprocess_props    (0)
+  , vivify_next        (0)
+  , probing            (false)
+  , saved_head         (0)
+  , saved_level        (0)
+  , adding_definition  (false)
 
     // Resource constraints:
     //
@@ -182,18 +216,37 @@ Solver::~Solver()
 //
 Var Solver::newVar(bool sign, bool dvar, bool isTheoryAtom, bool preRegister, bool canErase)
 {
-    int v = nVars();
-
-    watches  .init(mkLit(v, false));
-    watches  .init(mkLit(v, true ));
-    assigns  .push(l_Undef);
-    vardata  .push(VarData(CRef_Undef, -1, -1, assertionLevel, -1));
-    activity .push(rnd_init_act ? drand(random_seed) * 0.00001 : 0);
-    seen     .push(0);
-    polarity .push(sign);
-    decision .push();
-    trail    .capacity(v+1);
-    theory   .push(isTheoryAtom);
+    int v;
+    if (free_vars.size() > 0) {
+      // Reuse the slot of a variable deleted by a user pop, its clauses
+      // went with it
+      v = free_vars.last();
+      free_vars.pop();
+      assert(freed[v] && value(v) == l_Undef);
+      freed[v] = 0;
+      vardata[v] = VarData(CRef_Undef, -1, -1, assertionLevel, -1);
+      seen[v] = 0;
+      polarity[v] = sign;
+      theory[v] = isTheoryAtom;
+      reused.push(v);
+    } else {
+      v = nVars();
+
+      watches  .init(mkLit(v, false));
+      watches  .init(mkLit(v, true ));
+      assigns  .push(l_Undef);
+      vardata  .push(VarData(CRef_Undef, -1, -1, assertionLevel, -1));
+      activity .push(rnd_init_act ? drand(random_seed) * 0.00001 : 0);
+      seen     .push(0);
+      polarity .push(sign);
+      decision .push();
+      trail    .capacity(v+1);
+      theory   .push(isTheoryAtom);
+      retained .push(0);
+      freed    .push(0);
+    }
+    // A slot freed or deleted by a pop stands for a new variable now
+    if (trace) trace->newVariable(v);
 
     setDecisionVar(v, dvar);
 
@@ -207,6 +260,49 @@ Var Solver::newVar(bool sign, bool dvar, bool isTheoryAtom, bool preRegister, bo
     return v;
 }
 
+void Solver::reviveVar(Var v, bool isTheoryAtom, bool preRegister)
+{
+    assert(retain_vars);
+    theory[v] = isTheoryAtom;
+    vardata[v].intro_level = assertionLevel;
+    setDecisionVar(v, true);
+
+    if (preRegister) {
+      variables_to_register.push(VarIntroInfo(v, decisionLevel()));
+    }
+
+    reused.push(v);
+    ++revived_vars;
+    Debug("minisat") << "revived var " << v << std::endl;
+}
+
+void Solver::retainVar(Var v)
+{
+    assert(retain_vars);
+    retained[v] = 1;
+}
+
+void Solver::retireVar(Var v)
+{
+    // The variable stays in the kept definitions, which are satisfiable
+    // whatever the value of the subformulas, so it can be left to them
+    theory[v] = false;
+    setDecisionVar(v, false);
+    vardata[v].intro_level = std::min(vardata[v].intro_level, assertionLevel);
+}
+
+void Solver::freeVar(Var v)
+{
+    // A slot freed by an inner pop can come up again in an outer one, as
+    // a variable of that level or as a slot reused at it
+    if (freed[v]) return;
+    assert(value(v) == l_Undef);
+    freed[v] = 1;
+    theory[v] = false;
+    setDecisionVar(v, false);
+    free_vars.push(v);
+}
+
 void Solver::resizeVars(int newSize) {
   assert(enable_incremental);
   assert(decisionLevel() == 0);
@@ -225,7 +321,17 @@ void Solver::resizeVars(int newSize) {
     polarity.shrink(shrinkSize);
     decision.shrink(shrinkSize);
     theory.shrink(shrinkSize);
-
+    retained.shrink(shrinkSize);
+    freed.shrink(shrinkSize);
+
+    // Forget the free slots that went with them
+    int j = 0;
+    for (int i = 0; i < free_vars.size(); ++ i) {
+      if (free_vars[i] < newSize) {
+        free_vars[j++] = free_vars[i];
+      }
+    }
+    free_vars.shrink(free_vars.size() - j);
   }
 
   if (Debug.isOn("minisat::pop")) {
@@ -243,20 +349,25 @@ CRef Solver::reason(Var x) {
     // What's the literal we are trying to explain
     Lit l = mkLit(x, value(x) != l_True);
 
-    // Get the explanation from the theory
-    SatClause explanation_cl;
-    // FIXME: at some point return a tag with the theory that spawned you
-    proxy->explainPropagation(MinisatSatSolver::toSatLiteral(l),
-                              explanation_cl);
+    // Get the explanation from the theory, unless it gave one that still holds
     vec<Lit> explanation;
-    MinisatSatSolver::toMinisatClause(explanation_cl, explanation);
-
-    Debug("pf::sat") << "Solver::reason: explanation_cl = " << explanation_cl << std::endl;
+    if (!cachedExplanation(l, explanation)) {
+      SatClause explanation_cl;
+      // FIXME: at some point return a tag with the theory that spawned you
+      proxy->explainPropagation(MinisatSatSolver::toSatLiteral(l),
+                                explanation_cl);
+      MinisatSatSolver::toMinisatClause(explanation_cl, explanation);
+
+      Debug("pf::sat") << "Solver::reason: explanation_cl = " << explanation_cl << std::endl;
+    }
 
     // Sort the literals by trail index level
     lemma_lt lt(*this);
     sort(explanation, lt);
     Assert(explanation[0] == l);
+    // Record it as the theory gave it, once its level is known
+    vec<Lit> traced;
+    if (trace) explanation.copyTo(traced);
 
     // Compute the assertion level for this clause
     int explLevel = 0;
@@ -315,9 +426,12 @@ CRef Solver::reason(Var x) {
         explanation.push(mkLit(varTrue, true));
       }
     }
+    if (trace) traceClause(traced, false, explLevel);
 
     // Construct the reason
     CRef real_reason = ca.alloc(explLevel, explanation, true);
+    if (lbd_tiers)
+        ca[real_reason].lbd(computeLbd(explanation));
     // FIXME: at some point will need more information about where this explanation
     // came from (ie. the theory/sharing)
     Debug("pf::sat") << "Minisat::Solver registering a THEORY_LEMMA (1)" << std::endl;
@@ -335,21 +449,29 @@ CRef Solver::reason(Var x) {
 bool Solver::addClause_(vec<Lit>& ps, bool removable, ClauseId& id)
 {
     if (!ok) return false;
+    // Record it as given, once its level is known
+    vec<Lit> traced;
+    if (trace) ps.copyTo(traced);
 
     // Check if clause is satisfied and remove false/duplicate literals:
     sort(ps);
     Lit p; int i, j;
 
-    // Which user-level to assert this clause at
-    int clauseLevel = (removable && !assertionLevelOnly()) ? 0 : assertionLevel;
+    // Which user-level to assert this clause at (a kept definition stays
+    // as long as its variables, which are never deleted)
+    int clauseLevel = (removable && !assertionLevelOnly()) || adding_definition
+                          ? 0
+                          : assertionLevel;
 
     // Check the clause for tautologies and similar
     int falseLiteralsCount = 0;
     for (i = j = 0, p = lit_Undef; i < ps.size(); i++) {
       // Update the level
-      clauseLevel = assertionLevelOnly()
-                        ? assertionLevel
-                        : std::max(clauseLevel, intro_level(var(ps[i])));
+      if (!adding_definition) {
+        clauseLevel = assertionLevelOnly()
+                          ? assertionLevel
+                          : std::max(clauseLevel, intro_level(var(ps[i])));
+      }
       // Tautologies are ignored
       if (ps[i] == ~p) {
         id = ClauseIdUndef;
@@ -365,9 +487,10 @@ bool Solver::addClause_(vec<Lit>& ps, bool removable, ClauseId& id)
       if (ps[i] == p) {
         continue;
       }
-      // If a literal is false at 0 level (both sat and user level) we also ignore it
+      // If a literal is false at 0 level (both sat and user level) we also ignore it,
+      // except in a kept definition: it must not shrink to a unit, which a pop would lose
       if (value(ps[i]) == l_False) {
-        if (!PROOF_ON() && level(var(ps[i])) == 0 && user_level(var(ps[i])) == 0) {
+        if (!PROOF_ON() && !adding_definition && level(var(ps[i])) == 0 && user_level(var(ps[i])) == 0) {
           continue;
         } else {
           // If we decide to keep it, we count it into the false literals
@@ -380,6 +503,7 @@ bool Solver::addClause_(vec<Lit>& ps, bool removable, ClauseId& id)
 
     // Fit to size
     ps.shrink(i - j);
+    if (trace) traceClause(traced, false, clauseLevel);
 
     // If we are in solve_ or propagate
     if (minisat_busy)
@@ -452,6 +576,10 @@ bool Solver::addClause_(vec<Lit>& ps, bool removable, ClauseId& id)
       if (ps.size() == falseLiteralsCount + 1) {
         if(assigns[var(ps[0])] == l_Undef) {
           assert(assigns[var(ps[0])] != l_False);
+          // The propagation is undone by a pop, but the definition is not
+          if (adding_definition && assertionLevel > 0) {
+            repropagate.last() = true;
+          }
           uncheckedEnqueue(ps[0], cr);
           Debug("cores") << "i'm registering a unit clause, input" << std::endl;
           PROOF(
@@ -488,6 +616,19 @@ bool Solver::addClause_(vec<Lit>& ps, bool removable, ClauseId& id)
 }
 
 
+bool Solver::addDefinitionClause(const vec<Lit>& ps, ClauseId& id)
+{
+    // Only definitions made outside of search can be kept: lemmas are
+    // attached at the assertion level
+    assert(!minisat_busy);
+    ps.copyTo(add_tmp);
+    adding_definition = retain_vars;
+    bool result = addClause_(add_tmp, false, id);
+    adding_definition = false;
+    return result;
+}
+
+
 void Solver::attachClause(CRef cr) {
     const Clause& c = ca[cr];
     Debug("minisat") << "Solver::attachClause(" << c << "): level " << c.level() << std::endl;
@@ -537,11 +678,17 @@ bool Solver::satisfied(const Clause& c) const {
 
 
 // Revert to the state at given level (keeping all assignment at 'level' but not beyond).
+// With chronological backtracking, assignments of 'level' or below can sit above 'trail_lim[level]';
+// they are kept, in trail order, and handed to the theories again since the SMT context forgot them.
 //
 void Solver::cancelUntil(int level) {
     Debug("minisat") << "minisat::cancelUntil(" << level << ")" << std::endl;
 
     if (decisionLevel() > level){
+        // The saved trail relies on the levels below it, and on the part already replayed
+        if (level < saved_level || saved_head > 0)
+            clearSavedTrail();
+
         // Pop the SMT context
         for (int l = trail_lim.size() - level; l > 0; --l) {
           context->pop();
@@ -551,9 +698,13 @@ void Solver::cancelUntil(int level) {
         }
         for (int c = trail.size()-1; c >= trail_lim[level]; c--){
             Var      x  = var(trail[c]);
+            if (chrono >= 0 && vardata[x].level <= level) {
+                chrono_kept.push(trail[c]);
+                continue;
+            }
             assigns [x] = l_Undef;
             vardata[x].trail_index = -1;
-            if ((phase_saving > 1 ||
+            if (!probing && (phase_saving > 1 ||
                  ((phase_saving == 1) && c > trail_lim.last())
                  ) && ((polarity[x] & 0x2) == 0)) {
               polarity[x] = sign(trail[c]);
@@ -571,7 +722,129 @@ void Solver::cancelUntil(int level) {
           variables_to_register[i].level = currentLevel;
           proxy->variableNotify(MinisatSatSolver::toSatVariable(variables_to_register[i].var));
         }
+
+        // Put back the kept assignments (they will be propagated again)
+        for (int i = chrono_kept.size() - 1; i >= 0; --i) {
+            Lit p = chrono_kept[i];
+            vardata[var(p)].trail_index = trail.size();
+            trail.push_(p);
+            if (theory[var(p)]) {
+              proxy->enqueueTheoryLiteral(MinisatSatSolver::toSatLiteral(p));
+            }
+        }
+        chrono_kept.clear();
+    }
+}
+
+/*_________________________________________________________________________________________________
+|
+|  saveTrail : (level : int)  ->  [void]
+|
+|  Description:
+|    Trail saving: before a backjump to 'level', keeps the assignments of the levels in between
+|    (not those of the conflict level) with their reasons.  When the first of them is assigned
+|    again, 'replaySavedTrail()' re-enqueues the following ones along the same clauses.  The
+|    replayed literals are still propagated through their own watches and sent to the theories,
+|    whose context the backjump popped; what replay saves is finding their reasons unit again
+|    through the watch lists, and a saved literal that is now false is reported as a conflict
+|    before the literals ahead of it are propagated.
+|________________________________________________________________________________________________@*/
+void Solver::saveTrail(int level)
+{
+    clearSavedTrail();
+    if (decisionLevel() - level < 2)
+        return;
+    for (int c = trail_lim[level]; c < trail_lim[decisionLevel() - 1]; c++){
+        saved_trail.push(trail[c]);
+        saved_reasons.push(vardata[var(trail[c])].reason);
+    }
+    saved_level = level;
+}
+
+void Solver::clearSavedTrail()
+{
+    saved_trail.clear();
+    saved_reasons.clear();
+    saved_head  = 0;
+    saved_level = 0;
+}
+
+/*_________________________________________________________________________________________________
+|
+|  replaySavedTrail : ()  ->  [CRef]
+|
+|  Description:
+|    Called when the head of the saved trail has just been propagated.  Every saved literal up to
+|    the next one is now true, so the reason clause of the next one is unit (or falsified) again,
+|    as long as that clause still exists.  Replay stops at a decision or a theory propagation,
+|    whose reasons do not carry over.
+|________________________________________________________________________________________________@*/
+CRef Solver::replaySavedTrail()
+{
+    while (saved_head < saved_trail.size()){
+        Lit  q  = saved_trail[saved_head];
+        CRef cr = saved_reasons[saved_head];
+        if (cr == CRef_Undef || cr == CRef_Lazy)
+            return CRef_Undef;
+        Clause& c = ca[cr];
+        if (c.mark() == 1)
+            break;
+        // The watches may have swapped the implied literal out of the first position
+        if (c[0] != q){
+            if (c[1] != q)
+                break;
+            c[1] = c[0], c[0] = q;
+        }
+        saved_head++;
+        if (value(q) == l_False){
+            ++replay_conflicts;
+            return cr;
+        }
+        if (value(q) == l_Undef){
+            ++replayed_literals;
+            uncheckedEnqueue(q, cr);
+        }
     }
+    clearSavedTrail();
+    return CRef_Undef;
+}
+
+/*_________________________________________________________________________________________________
+|
+|  cachedExplanation : (p : Lit) (out : vec<Lit>&)  ->  [bool]
+|
+|  Description:
+|    Looks up the explanation the theories last gave for 'p'.  It is a theory-valid clause, but
+|    it was computed on another assignment, so it is only used if it still explains 'p': every
+|    other literal must be false and, when 'p' is true, assigned before it.  Returns false, with
+|    'out' empty, if the theories have to be asked again.
+|________________________________________________________________________________________________@*/
+bool Solver::cachedExplanation(Lit p, vec<Lit>& out)
+{
+    SatClause cached;
+    out.clear();
+    if (!proxy->getCachedExplanation(MinisatSatSolver::toSatLiteral(p), cached))
+        return false;
+    MinisatSatSolver::toMinisatClause(cached, out);
+    Assert(out[0] == p);
+    for (int i = 1; i < out.size(); i++){
+        Var x = var(out[i]);
+        if (value(out[i]) != l_False
+            || (value(p) == l_True && trail_index(x) >= trail_index(var(p)))){
+            out.clear();
+            return false;
+        }
+    }
+    ++explanation_cache_hits;
+    return true;
+}
+
+int Solver::implicationLevel(CRef from) const {
+    const Clause& c = ca[from];
+    int lev = 0;
+    for (int i = 1; i < c.size(); i++)
+        lev = std::max(lev, level(var(c[i])));
+    return lev;
 }
 
 void Solver::resetTrail() { cancelUntil(0); }
@@ -701,8 +974,17 @@ int Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
         Clause& c = ca[confl];
         max_resolution_level = std::max(max_resolution_level, c.level());
 
-        if (c.removable())
+        if (c.removable()) {
             claBumpActivity(c);
+            // Clauses that keep taking part in conflicts stay in their tier, and
+            // move up if their literals now span fewer levels
+            if (lbd_tiers && c.lbd() > lbd_core) {
+                unsigned lbd = computeLbd(c);
+                if (lbd < c.lbd())
+                    c.lbd(lbd);
+                c.used(true);
+            }
+        }
 
         for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
             Lit q = c[j];
@@ -728,9 +1010,11 @@ int Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
             }
         }
 
-        // Select next clause to look at:
-        while (!seen[var(trail[index--])]);
-        p     = trail[index+1];
+        // Select next clause to look at (with chronological backtracking,
+        // literals of lower levels can be above those of the current one):
+        while (!seen[var(trail[index])] || level(var(trail[index])) < decisionLevel())
+            index--;
+        p     = trail[index--];
         confl = reason(var(p));
         seen[var(p)] = 0;
         pathC--;
@@ -813,6 +1097,53 @@ int Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  shareLearnt : (learnt : const vec<Lit>&) (lbd : unsigned)  ->  [void]
+|
+|  Description:
+|    Hands a freshly learnt clause to the theory proxy for sharing with the other portfolio
+|    threads, if it passes the length filter and the LBD filter ('lbd' is the number of distinct
+|    decision levels among its literals, measured before backtracking).  Units are not shared, and
+|    neither is anything in incremental mode, where a clause may depend on assertions that get
+|    popped.
+|________________________________________________________________________________________________@*/
+void Solver::shareLearnt(const vec<Lit>& learnt, unsigned lbd)
+{
+    if (learnt.size() < 2 || learnt.size() > options::sharingFilterByLength()
+        || options::incrementalSolving())
+        return;
+
+    unsigned maxLbd = options::sharingFilterByLbd();
+    if (maxLbd > 0 && lbd > maxLbd)
+        return;
+
+    SatClause clause;
+    for (int i = 0; i < learnt.size(); i++)
+        clause.push_back(MinisatSatSolver::toSatLiteral(learnt[i]));
+    proxy->notifyNewLemma(clause);
+}
+
+void Solver::traceClause(const vec<Lit>& c, bool learnt, int level)
+{
+    trace->beginClause(learnt);
+    for (int i = 0; i < c.size(); i++)
+        trace->literal(var(c[i]), sign(c[i]));
+    trace->endClause(level);
+}
+
+void Solver::setTraceRecorder(CVC4::prop::SatTraceRecorder* recorder)
+{
+    trace = recorder;
+    // The constants are enqueued, not asserted by clauses
+    vec<Lit> unit;
+    unit.push(mkLit(varTrue, false));
+    traceClause(unit, false, 0);
+    unit[0] = mkLit(varFalse, true);
+    traceClause(unit, false, 0);
+}
+
+
 // Check if 'p' can be removed. 'abstract_levels' is used to abort early if the algorithm is
 // visiting literals at levels that cannot be removed later.
 bool Solver::litRedundant(Lit p, uint32_t abstract_levels)
@@ -894,9 +1225,12 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
     assert(value(p) == l_Undef);
     assert(var(p) < nVars());
     assigns[var(p)] = lbool(!sign(p));
-    vardata[var(p)] = VarData(from, decisionLevel(), assertionLevel, intro_level(var(p)), trail.size());
+    // Out of order: a clause can imply its literal below the current level
+    int lev = (chrono >= 0 && from != CRef_Undef && from != CRef_Lazy)
+                  ? implicationLevel(from) : decisionLevel();
+    vardata[var(p)] = VarData(from, lev, assertionLevel, intro_level(var(p)), trail.size());
     trail.push_(p);
-    if (theory[var(p)]) {
+    if (theory[var(p)] && !probing) {
       // Enqueue to the theory
       proxy->enqueueTheoryLiteral(MinisatSatSolver::toSatLiteral(p));
     }
@@ -981,13 +1315,18 @@ CRef Solver::propagate(TheoryCheckType type)
 }
 
 void Solver::propagateTheory() {
-  SatClause propagatedLiteralsClause;
   // Doesn't actually call propagate(); that's done in theoryCheck() now that combination
-  // is online.  This just incorporates those propagations previously discovered.
-  proxy->theoryPropagate(propagatedLiteralsClause);
+  // is online.  This just incorporates those propagations previously discovered, in one
+  // batch, through buffers kept across calls.
+  theory_propagated.clear();
+  proxy->theoryPropagate(theory_propagated);
+  if (theory_propagated.empty()) {
+    return;
+  }
 
-  vec<Lit> propagatedLiterals;
-  MinisatSatSolver::toMinisatClause(propagatedLiteralsClause, propagatedLiterals);
+  vec<Lit>& propagatedLiterals = theory_propagated_lits;
+  propagatedLiterals.clear();
+  MinisatSatSolver::toMinisatClause(theory_propagated, propagatedLiterals);
 
   int oldTrailSize = trail.size();
   Debug("minisat") << "old trail size is " << oldTrailSize << ", propagating " << propagatedLiterals.size() << " lits..." << std::endl;
@@ -1000,10 +1339,12 @@ void Solver::propagateTheory() {
     } else {
       if (value(p) == l_False) {
         Debug("minisat") << "Conflict in theory propagation" << std::endl;
-        SatClause explanation_cl;
-        proxy->explainPropagation(MinisatSatSolver::toSatLiteral(p), explanation_cl);
         vec<Lit> explanation;
-        MinisatSatSolver::toMinisatClause(explanation_cl, explanation);
+        if (!cachedExplanation(p, explanation)) {
+          SatClause explanation_cl;
+          proxy->explainPropagation(MinisatSatSolver::toSatLiteral(p), explanation_cl);
+          MinisatSatSolver::toMinisatClause(explanation_cl, explanation);
+        }
         ClauseId id; // FIXME: mark it as explanation here somehow?
         addClause(explanation, true, id);
       }
@@ -1045,6 +1386,20 @@ CRef Solver::propagateBool()
 
     while (qhead < trail.size()){
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
+
+        if (saved_head < saved_trail.size()){
+            Lit head = saved_trail[saved_head];
+            if (p == head){
+                saved_head++;
+                confl = replaySavedTrail();
+                if (confl != CRef_Undef){
+                    qhead = trail.size();
+                    break;
+                }
+            }else if (value(head) == l_False)
+                clearSavedTrail();
+        }
+
         vec<Watcher>&  ws  = watches[p];
         Watcher        *i, *j, *end;
         num_props++;
@@ -1134,6 +1489,58 @@ void Solver::reduceDB()
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  reduceDBTiered : ()  ->  [void]
+|
+|  Description:
+|    Remove learnt clauses by LBD, in the style of Glucose.  Core clauses (LBD at most 'lbd_core')
+|    and binary clauses are kept for good; tier-2 clauses (LBD at most 'lbd_tier2') are kept as
+|    long as they took part in a conflict since the last reduction.  A protected clause (a fresh
+|    theory lemma) is kept once, whatever its LBD, and loses its protection.  The remaining local
+|    clauses are ranked by LBD, then activity, and the worse half of them is removed, minus the
+|    locked ones.  Theory lemmas and explanations are ranked the same way as learnt clauses.
+|________________________________________________________________________________________________@*/
+struct reduceDBTiered_lt {
+    ClauseAllocator& ca;
+    reduceDBTiered_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool operator () (CRef x, CRef y) {
+        if (ca[x].lbd() != ca[y].lbd()) return ca[x].lbd() > ca[y].lbd();
+        return ca[x].activity() < ca[y].activity(); }
+};
+void Solver::reduceDBTiered()
+{
+    int      i, j;
+    vec<CRef> local;
+
+    // Set the kept tiers aside:
+    for (i = j = 0; i < clauses_removable.size(); i++){
+        Clause& c = ca[clauses_removable[i]];
+        bool keep = c.size() == 2 || c.lbd() <= lbd_core || (c.lbd() <= lbd_tier2 && c.used()) || c.protect();
+        c.used(false);
+        c.protect(false);
+        if (keep)
+            clauses_removable[j++] = clauses_removable[i];
+        else
+            local.push(clauses_removable[i]);
+    }
+    clauses_removable.shrink(i - j);
+
+    sort(local, reduceDBTiered_lt(ca));
+    for (i = 0; i < local.size(); i++){
+        Clause& c = ca[local[i]];
+        if (!locked(c) && i < local.size() / 2)
+            removeClause(local[i]);
+        else
+            clauses_removable.push(local[i]);
+    }
+
+    reduce_interval  += reduce_inc;
+    next_reduce_confl = conflicts + reduce_interval;
+    checkGarbage();
+}
+
+
 void Solver::removeSatisfied(vec<CRef>& cs)
 {
     int i, j;
@@ -1241,6 +1648,15 @@ lbool Solver::search(int nof_conflicts)
 
             conflicts++; conflictC++;
 
+            if (chrono >= 0 && confl != CRef_Lazy) {
+                // The conflict may lie entirely below the current level, analyze it at its own
+                int confl_level = 0;
+                const Clause& c = ca[confl];
+                for (int i = 0; i < c.size(); i++)
+                    confl_level = std::max(confl_level, level(var(c[i])));
+                cancelUntil(confl_level);
+            }
+
             if (decisionLevel() == 0) {
                 PROOF( ProofManager::getSatProof()->finalizeProof(confl); )
                 return l_False;
@@ -1249,7 +1665,25 @@ lbool Solver::search(int nof_conflicts)
             // Analyze the conflict
             learnt_clause.clear();
             int max_level = analyze(confl, learnt_clause, backtrack_level);
-            cancelUntil(backtrack_level);
+            if (trace) traceClause(learnt_clause, true, 0);
+            unsigned lbd = computeLbd(learnt_clause);
+            shareLearnt(learnt_clause, lbd);
+            if (chrono >= 0 && learnt_clause.size() > 1
+                && decisionLevel() - backtrack_level > chrono) {
+                // Keep the work of the levels in between, the asserting literal goes out of order
+                ++chrono_backtracks;
+                cancelUntil(decisionLevel() - 1);
+            } else {
+                if (trail_saving && chrono < 0)
+                    saveTrail(backtrack_level);
+                cancelUntil(backtrack_level);
+            }
+
+            if (glucose_restart) {
+                // Until the windows fill up, the averages are plain means
+                lbd_ema_fast += std::max(1.0 / 32, 1.0 / conflicts) * (lbd - lbd_ema_fast);
+                lbd_ema_slow += std::max(1.0 / 16384, 1.0 / conflicts) * (lbd - lbd_ema_slow);
+            }
 
             // Assert the conflict clause and the asserting literal
             if (learnt_clause.size() == 1) {
@@ -1262,6 +1696,7 @@ lbool Solver::search(int nof_conflicts)
                   ca.alloc(assertionLevelOnly() ? assertionLevel : max_level,
                            learnt_clause,
                            true);
+              ca[cr].lbd(lbd);
               clauses_removable.push(cr);
               attachClause(cr);
               claBumpActivity(ca[cr]);
@@ -1320,6 +1755,7 @@ lbool Solver::search(int nof_conflicts)
             }
 
             if (nof_conflicts >= 0 && conflictC >= nof_conflicts ||
+                (glucose_restart && restartDue(conflictC)) ||
                 !withinBudget(options::satConflictStep())) {
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
@@ -1335,7 +1771,22 @@ lbool Solver::search(int nof_conflicts)
                 return l_False;
             }
 
-            if (clauses_removable.size()-nAssigns() >= max_learnts) {
+            if (use_inprocess && decisionLevel() == 0 && conflicts >= next_inprocess_confl) {
+                if (!inprocess()) {
+                    return l_False;
+                }
+                // Propagate the new units before deciding
+                if (qhead < trail.size()) {
+                    continue;
+                }
+            }
+
+            if (lbd_tiers) {
+                if (conflicts >= next_reduce_confl) {
+                    // Reduce the set of learnt clauses:
+                    reduceDBTiered();
+                }
+            } else if (clauses_removable.size()-nAssigns() >= max_learnts) {
                 // Reduce the set of learnt clauses:
                 reduceDB();
             }
@@ -1374,6 +1825,7 @@ lbool Solver::search(int nof_conflicts)
             }
 
             // Increase decision level and enqueue 'next'
+            if (trace) trace->decision(var(next), sign(next));
             newDecisionLevel();
             uncheckedEnqueue(next);
         }
@@ -1381,6 +1833,188 @@ lbool Solver::search(int nof_conflicts)
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  inprocess : ()  ->  [bool]
+|
+|  Description:
+|    Simplifies the learnt clauses at level 0, with a budget for each technique proportional to
+|    the propagations of the search since the last round.  Theory atoms need no freezing: only
+|    redundant clauses are touched, and only in ways implied by the clause database.  Returns
+|    FALSE if the problem turned out to be unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::inprocess()
+{
+    assert(decisionLevel() == 0 && qhead == trail.size());
+
+    uint64_t search_props = propagations - inprocess_props;
+    ++inprocessings;
+
+    subsumeLearnts(std::max<uint64_t>(search_props * subsume_effort / 100, 1000));
+    bool result = vivifyLearnts(std::max<uint64_t>(search_props * vivify_effort / 100, 1000));
+
+    inprocess_props      = propagations;
+    next_inprocess_confl = conflicts + inprocess_interval;
+    checkGarbage();
+    return result;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  vivifyLearnts : (budget : uint64_t)  ->  [bool]
+|
+|  Description:
+|    Vivification: assigns the negations of the literals of a learnt clause one by one and
+|    propagates (on the clauses only).  A conflict, or a literal of the clause becoming true,
+|    shows that the literals assigned so far (plus the true one) already form an implied clause;
+|    literals becoming false can be dropped.  Rounds resume where the previous one stopped.
+|    Returns FALSE if a unit contradicting level 0 is found.
+|________________________________________________________________________________________________@*/
+bool Solver::vivifyLearnts(uint64_t budget)
+{
+    uint64_t limit = propagations + budget;
+    vec<Lit> lits, shorter;
+    vec<Lit> units;
+
+    if (vivify_next >= clauses_removable.size())
+        vivify_next = 0;
+
+    probing = true;
+    for (int n = clauses_removable.size(); n > 0 && propagations < limit; n--){
+        int i = vivify_next;
+        vivify_next = (vivify_next + 1) % clauses_removable.size();
+
+        CRef cr = clauses_removable[i];
+        Clause& c = ca[cr];
+        if (c.size() <= 2 || locked(c) || satisfied(c))
+            continue;
+
+        // Propagation may reorder the literals of the clause, work on a copy
+        lits.clear();
+        for (int k = 0; k < c.size(); k++)
+            lits.push(c[k]);
+
+        shorter.clear();
+        newDecisionLevel();
+        for (int k = 0; k < lits.size(); k++){
+            Lit p = lits[k];
+            if (value(p) == l_True){
+                shorter.push(p);
+                break;
+            }
+            if (value(p) == l_False)
+                continue;
+            shorter.push(p);
+            uncheckedEnqueue(~p);
+            if (propagateBool() != CRef_Undef)
+                break;
+        }
+        cancelUntil(0);
+
+        if (shorter.size() == lits.size())
+            continue;
+        if (trace) traceClause(shorter, true, 0);
+
+        ++vivified_clauses;
+        vivified_literals += lits.size() - shorter.size();
+        if (shorter.size() == 1){
+            units.push(shorter[0]);
+            removeClause(cr);
+            clauses_removable[i] = CRef_Undef;
+        }else{
+            CRef shorter_cr = ca.alloc(ca[cr].level(), shorter, true);
+            Clause& s = ca[shorter_cr];
+            s.activity() = ca[cr].activity();
+            s.lbd(std::min(ca[cr].lbd(), (unsigned)shorter.size()));
+            s.used(ca[cr].used());
+            s.protect(ca[cr].protect());
+            removeClause(cr);
+            attachClause(shorter_cr);
+            clauses_removable[i] = shorter_cr;
+        }
+    }
+    probing = false;
+
+    int i, j;
+    for (i = j = 0; i < clauses_removable.size(); i++)
+        if (clauses_removable[i] != CRef_Undef)
+            clauses_removable[j++] = clauses_removable[i];
+    clauses_removable.shrink(i - j);
+
+    for (i = 0; i < units.size(); i++){
+        if (value(units[i]) == l_False)
+            return ok = false;
+        if (value(units[i]) == l_Undef)
+            uncheckedEnqueue(units[i]);
+    }
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  subsumeLearnts : (budget : uint64_t)  ->  [void]
+|
+|  Description:
+|    Removes the learnt clauses that contain all the literals of another clause.  Every clause is
+|    listed under its first literal; a learnt clause then looks for subsuming clauses in the
+|    lists of its own literals.  'budget' bounds the number of literals visited.
+|________________________________________________________________________________________________@*/
+void Solver::subsumeLearnts(uint64_t budget)
+{
+    vec<vec<CRef> > occs(2 * nVars());
+    for (int i = 0; i < clauses_persistent.size(); i++)
+        occs[toInt(ca[clauses_persistent[i]][0])].push(clauses_persistent[i]);
+    for (int i = 0; i < clauses_removable.size(); i++)
+        occs[toInt(ca[clauses_removable[i]][0])].push(clauses_removable[i]);
+
+    uint64_t visited = 0;
+    int i, j;
+    for (i = j = 0; i < clauses_removable.size(); i++){
+        CRef cr = clauses_removable[i];
+        Clause& c = ca[cr];
+        bool subsumed = false;
+        if (visited < budget && !locked(c)){
+            // Mark the literals of the candidate (1 for positive, 2 for negative)
+            for (int k = 0; k < c.size(); k++)
+                seen[var(c[k])] = 1 + sign(c[k]);
+            for (int k = 0; k < c.size() && !subsumed && visited < budget; k++){
+                const vec<CRef>& os = occs[toInt(c[k])];
+                for (int l = 0; l < os.size() && !subsumed; l++){
+                    if (os[l] == cr)
+                        continue;
+                    const Clause& d = ca[os[l]];
+                    if (d.mark() == 1 || d.size() > c.size())
+                        continue;
+                    int m = 0;
+                    while (m < d.size() && seen[var(d[m])] == 1 + sign(d[m]))
+                        m++;
+                    visited += m + 1;
+                    subsumed = m == d.size();
+                }
+            }
+            for (int k = 0; k < c.size(); k++)
+                seen[var(c[k])] = 0;
+        }
+        if (subsumed){
+            ++subsumed_clauses;
+            removeClause(cr);
+        }else
+            clauses_removable[j++] = cr;
+    }
+    clauses_removable.shrink(i - j);
+}
+
+
+bool Solver::restartDue(int conflictC) const
+{
+    // Restart when the clauses learnt lately are markedly worse than usual
+    return conflictC >= restart_min_confl
+        && lbd_ema_fast > restart_margin * lbd_ema_slow;
+}
+
+
 double Solver::progressEstimate() const
 {
     double  progress = 0;
@@ -1436,6 +2070,7 @@ lbool Solver::solve_()
     conflict.clear();
     if (!ok){
       minisat_busy = false;
+      if (trace) trace->solved(CVC4::prop::SAT_VALUE_FALSE);
       return l_False;
     }
 
@@ -1457,7 +2092,8 @@ lbool Solver::solve_()
     int curr_restarts = 0;
     while (status == l_Undef){
         double rest_base = luby_restart ? luby(restart_inc, curr_restarts) : pow(restart_inc, curr_restarts);
-        status = search(rest_base * restart_first);
+        if (trace && curr_restarts > 0) trace->restart();
+        status = search(glucose_restart ? -1 : rest_base * restart_first);
         if (!withinBudget(options::satConflictStep())) break; // FIXME add restart option?
         curr_restarts++;
     }
@@ -1479,6 +2115,12 @@ lbool Solver::solve_()
     }else if (status == l_False && conflict.size() == 0)
         ok = false;
 
+    if (trace) {
+        trace->solved(status == l_True    ? CVC4::prop::SAT_VALUE_TRUE
+                      : status == l_False ? CVC4::prop::SAT_VALUE_FALSE
+                                          : CVC4::prop::SAT_VALUE_UNKNOWN);
+    }
+
     return status;
 }
 
@@ -1565,6 +2207,9 @@ void Solver::toDimacs(FILE* f, const vec<Lit>& assumps)
 
 void Solver::relocAll(ClauseAllocator& to)
 {
+    // The saved reasons would have to move too, just drop them
+    clearSavedTrail();
+
     // All watchers:
     //
     // for (int i = 0; i < watches.size(); i++)
@@ -1623,8 +2268,11 @@ void Solver::push()
 
   ++assertionLevel;
   Debug("minisat") << "in user push, increasing assertion level to " << assertionLevel << std::endl;
+  if (trace) trace->push();
   trail_ok.push(ok);
   assigns_lim.push(assigns.size());
+  reused_lim.push(reused.size());
+  repropagate.push(false);
 
   context->push(); // SAT context for CVC4
 
@@ -1639,6 +2287,7 @@ void Solver::pop()
 
   // Pop the trail below the user level
   --assertionLevel;
+  if (trace) trace->pop();
   while (true) {
     Debug("minisat") << "== unassigning " << trail.last() << std::endl;
     Var      x  = var(trail.last());
@@ -1664,8 +2313,57 @@ void Solver::pop()
   context->pop(); // SAT context for CVC4
 
   // Pop the created variables
-  resizeVars(assigns_lim.last());
+  if (retain_vars) {
+    // Only the variables of kept translations stay: the others are
+    // deleted at the end, and below the last kept one their slots are
+    // reused
+    int newSize = assigns_lim.last();
+    for (Var v = assigns_lim.last(); v < nVars(); ++ v) {
+      if (retained[v]) {
+        newSize = v + 1;
+      }
+    }
+    for (Var v = assigns_lim.last(); v < newSize; ++ v) {
+      if (retained[v]) {
+        retireVar(v);
+      } else {
+        freeVar(v);
+      }
+    }
+    for (int i = reused_lim.last(); i < reused.size(); ++ i) {
+      if (retained[reused[i]]) {
+        retireVar(reused[i]);
+      } else {
+        freeVar(reused[i]);
+      }
+    }
+    reused.shrink(reused.size() - reused_lim.last());
+    resizeVars(newSize);
+#ifdef CVC4_ASSERTIONS
+    // Each free slot is on free_vars exactly once
+    int numFreed = 0;
+    for (Var v = 0; v < nVars(); ++ v) {
+      numFreed += freed[v];
+    }
+    Assert(numFreed == free_vars.size());
+    for (int i = 0; i < free_vars.size(); ++ i) {
+      Assert(freed[free_vars[i]]);
+    }
+#endif /* CVC4_ASSERTIONS */
+  } else {
+    resizeVars(assigns_lim.last());
+  }
   assigns_lim.pop();
+  reused_lim.pop();
+  // Definitions that propagated at this level are unit again, at the one
+  // below, whose pop undoes them in turn
+  if (repropagate.last()) {
+    qhead = 0;
+    if (repropagate.size() > 1) {
+      repropagate[repropagate.size() - 2] = true;
+    }
+  }
+  repropagate.pop();
   variables_to_register.clear();
 
   // Pop the OK
@@ -1795,6 +2493,12 @@ CRef Solver::updateLemmas() {
       }
 
       lemma_ref = ca.alloc(clauseLevel, lemma, removable);
+      if (removable && lbd_tiers) {
+        // A theory lemma has not had the chance to take part in a conflict
+        // yet, so it survives the next reduction even if its LBD is poor
+        ca[lemma_ref].lbd(computeLbd(lemma));
+        ca[lemma_ref].protect(true);
+      }
       PROOF
         (
          TNode cnf_assertion = lemmas_cnf_assertion[i].first;
@@ -1881,6 +2585,9 @@ void ClauseAllocator::reloc(CRef& cr,
   // Copy extra data-fields:
   // (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
   to[cr].mark(c.mark());
+  to[cr].lbd(c.lbd());
+  to[cr].used(c.used());
+  to[cr].protect(c.protect());
   if (to[cr].removable())         to[cr].activity() = c.activity();
   else if (to[cr].has_extra()) to[cr].calcAbstraction();
 }
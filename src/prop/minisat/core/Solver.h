@@ -40,6 +40,7 @@ namespace CVC4 {
 template <class Solver> class TSatProof;
 
 namespace prop {
+  class SatTraceRecorder;
   class TheoryProxy;
 }/* CVC4::prop namespace */
 }/* CVC4 namespace */
@@ -75,6 +76,9 @@ protected:
   /** The context from the SMT solver */
   CVC4::context::Context* context;
 
+  /** Where to record the search, if anywhere (not owned) */
+  CVC4::prop::SatTraceRecorder* trace;
+
   /** The current assertion level (user) */
   int assertionLevel;
 
@@ -87,6 +91,8 @@ protected:
 public:
   /** Returns the current user assertion level */
   int getAssertionLevel() const { return assertionLevel; }
+  /** Records the clauses, decisions and restarts from now on */
+  void setTraceRecorder(CVC4::prop::SatTraceRecorder* recorder);
 protected:
   /** Do we allow incremental solving */
   bool enable_incremental;
@@ -123,6 +129,28 @@ protected:
   /** Keep only newSize variables */
   void resizeVars(int newSize);
 
+  /**
+   * Variables older than their user level that were brought back at it:
+   * revived ones (see 'reviveVar') and reused slots (see 'free_vars')
+   */
+  vec<Var> reused;
+  vec<int> reused_lim;
+
+  /** Whether each variable belongs to a translation kept across user pops, see 'retainVar' */
+  vec<char> retained;
+
+  /** Slots of variables deleted by a user pop, for 'newVar' to reuse */
+  vec<Var> free_vars;
+
+  /** Whether each variable is on 'free_vars' */
+  vec<char> freed;
+
+  /** Take a kept variable of a popped user level out of the search */
+  void retireVar(Var v);
+
+  /** Delete a variable of a popped user level that is not the last one */
+  void freeVar(Var v);
+
 public:
 
     // Constructor/Destructor:
@@ -183,6 +211,9 @@ public:
     bool    addClause (Lit p, Lit q, Lit r, bool removable, ClauseId& id); // Add a ternary clause to the solver.
     bool    addClause_(      vec<Lit>& ps, bool removable, ClauseId& id);  // Add a clause to the solver without making superflous internal copy. Will
                                                                                  // change the passed vector 'ps'.
+    bool    addDefinitionClause(const vec<Lit>& ps, ClauseId& id);          // Add a clause defining a subformula, kept across user pops if 'retain_vars'.
+    void    retainVar (Var v);                                             // Keep a variable across the pop of its user level (see 'retain_vars').
+    void    reviveVar (Var v, bool isTheoryAtom, bool preRegister);        // Bring back a variable retired by a user pop (see 'retain_vars').
 
     // Solving:
     //
@@ -272,10 +303,31 @@ public:
     int       learntsize_adjust_start_confl;
     double    learntsize_adjust_inc;
 
+    bool      lbd_tiers;          // Manage learnt clauses in tiers by LBD instead of by activity alone.                     (default false)
+    unsigned  lbd_core;           // Learnt clauses with an LBD up to this are never removed.                                  (default 2)
+    unsigned  lbd_tier2;          // Learnt clauses with an LBD up to this are kept while they take part in conflicts.         (default 6)
+    int       reduce_first;       // The number of conflicts before the first tiered reduction.                                (default 2000)
+    int       reduce_inc;         // The number of conflicts added to the interval between tiered reductions.                  (default 300)
+    bool      glucose_restart;    // Restart when recent learnt clauses have a high LBD compared to the long-term average.     (default false)
+    double    restart_margin;     // Restart once the fast LBD average exceeds the slow one by this factor.                    (default 1.25)
+    int       restart_min_confl;  // The least number of conflicts between two LBD-driven restarts.                            (default 50)
+    int       chrono;             // Backtrack one level only when a conflict would undo more than this many levels (-1: never). (default -1)
+    bool      use_inprocess;      // Periodically vivify learnt clauses and remove subsumed ones at level 0.                   (default false)
+    int       inprocess_interval; // The number of conflicts between two inprocessing rounds.                                  (default 10000)
+    int       vivify_effort;      // Vivification may propagate this many percent of the propagations done by the search.      (default 10)
+    int       subsume_effort;     // Subsumption may visit this many percent of the propagations done by the search, in literals. (default 10)
+    bool      trail_saving;       // Keep the trail undone by a backjump and replay it when its head is assigned again.      (default false)
+    bool      retain_vars;        // On user pops, retire the kept variables of the popped level instead of deleting them.    (default false)
+
     // Statistics: (read-only member variable)
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts, resources_consumed;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t chrono_backtracks;
+    uint64_t inprocessings, vivified_clauses, vivified_literals, subsumed_clauses;
+    uint64_t replayed_literals, replay_conflicts;
+    uint64_t revived_vars;
+    uint64_t explanation_cache_hits;
 
 protected:
 
@@ -378,6 +430,27 @@ protected:
     double              learntsize_adjust_confl;
     int                 learntsize_adjust_cnt;
 
+    vec<uint64_t>       lbd_seen;           // Per decision level, the last 'lbd_stamp' at which 'computeLbd' counted it.
+    uint64_t            lbd_stamp;
+    uint64_t            next_reduce_confl;  // Conflict count at which the next tiered reduction is due.
+    int                 reduce_interval;
+    double              lbd_ema_fast;       // Moving averages of the LBD of learnt clauses, over the last few dozen
+    double              lbd_ema_slow;       // and the last several thousand conflicts.
+    vec<Lit>            chrono_kept;        // Assignments kept on the trail by a chronological 'cancelUntil'.
+    vec<Lit>            saved_trail;        // The levels between the backjump level and the conflict level of the last backjump,
+    vec<CRef>           saved_reasons;      // and their reasons.
+    int                 saved_head;         // The next literal of 'saved_trail' to replay.
+    int                 saved_level;        // The backjump level: the saved trail is void once the solver backtracks below it.
+    CVC4::prop::SatClause theory_propagated; // The batch of literals propagated by the theories (reused by 'propagateTheory').
+    vec<Lit>            theory_propagated_lits;
+    uint64_t            next_inprocess_confl; // Conflict count at which the next inprocessing round is due.
+    uint64_t            inprocess_props;    // The value of 'propagations' after the last inprocessing round.
+    int                 vivify_next;        // Where in 'clauses_removable' the next vivification round starts.
+    bool                probing;            // Whether assignments are tentative and kept from the theories.
+    bool                adding_definition;  // Whether 'addClause_' is adding a definition to keep across user pops.
+    vec<char>           repropagate;        // For each user level above 0, whether a kept definition propagated at it, so that
+                                            // its pop must propagate the remaining trail again.
+
     // Resource contraints:
     //
     int64_t             conflict_budget;    // -1 means no budget.
@@ -398,14 +471,27 @@ protected:
     void     theoryCheck      (CVC4::theory::Theory::Effort effort);                   // Perform a theory satisfiability check. Adds lemmas.
     CRef     updateLemmas     ();                                                      // Add the lemmas, backtraking if necessary and return a conflict if there is one
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
+    int      implicationLevel (CRef from) const;                                       // The level at which the first literal of 'from' is implied.
+    void     saveTrail        (int level);                                             // Save the trail above 'level' (but not the current level) for replay.
+    void     clearSavedTrail  ();
+    CRef     replaySavedTrail ();                                                      // Replay the saved trail after its head literal. Returns a conflict if any.
     int      analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel);    // (bt = backtrack)
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()') - true if p is redundant
+    void     shareLearnt      (const vec<Lit>& learnt, unsigned lbd);                  // Offer a learnt clause to the other portfolio threads.
+    void     traceClause      (const vec<Lit>& c, bool learnt, int level);             // Record a clause of the given user level in 'trace'.
+    template<class Lits>
+    unsigned computeLbd       (const Lits& lits);                                      // Number of distinct decision levels among the literals (the LBD).
     lbool    search           (int nof_conflicts);                                     // Search for a given number of conflicts.
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
+    void     reduceDBTiered   ();                                                      // Reduce the set of learnt clauses, keeping them in tiers by LBD.
+    bool     restartDue       (int conflictC) const;                                   // Whether the LBD averages call for a restart.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
     void     rebuildOrderHeap ();
+    bool     inprocess        ();                                                      // Run a round of inprocessing at level 0. Returns false if unsat.
+    bool     vivifyLearnts    (uint64_t budget);                                       // Shorten learnt clauses by propagating their negation.
+    void     subsumeLearnts   (uint64_t budget);                                       // Remove learnt clauses subsumed by other clauses.
 
     // Maintaining Variable/Clause activity:
     //
@@ -430,6 +516,7 @@ protected:
     int      decisionLevel    ()      const; // Gives the current decisionlevel.
     uint32_t abstractLevel    (Var x) const; // Used to represent an abstraction of sets of decision levels.
     CRef     reason           (Var x); // Get the reason of the variable (non const as it might create the explanation on the fly)
+    bool     cachedExplanation(Lit p, vec<Lit>& out); // Get an earlier theory explanation of 'p' if it still holds on the trail.
     bool     hasReasonClause  (Var x) const; // Does the variable have a reason
     bool     isPropagated     (Var x) const; // Does the variable have a propagated variables
     bool     isPropagatedBy   (Var x, const Clause& c) const; // Is the value of the variable propagated by the clause Clause C
@@ -504,6 +591,25 @@ inline void Solver::claBumpActivity (Clause& c) {
                 ca[clauses_removable[i]].activity() *= 1e-20;
             cla_inc *= 1e-20; } }
 
+template<class Lits>
+inline unsigned Solver::computeLbd(const Lits& lits) {
+    // Unassigned literals (possible in theory lemmas) all count as one level
+    lbd_stamp++;
+    unsigned lbd = 0;
+    bool unassigned = false;
+    for (int i = 0; i < lits.size(); i++){
+        Var v = var(lits[i]);
+        if (value(v) == l_Undef){
+            unassigned = true;
+            continue; }
+        int l = level(v);
+        if (l >= lbd_seen.size())
+            lbd_seen.growTo(l + 1, 0);
+        if (lbd_seen[l] != lbd_stamp){
+            lbd_seen[l] = lbd_stamp;
+            lbd++; } }
+    return unassigned ? lbd + 1 : lbd; }
+
 inline void Solver::checkGarbage(void){ return checkGarbage(garbage_frac); }
 inline void Solver::checkGarbage(double gf){
     if (ca.wasted() > ca.size() * gf)
@@ -193,7 +193,10 @@ class Clause {
         unsigned has_extra : 1;
         unsigned reloced   : 1;
         unsigned size      : 27;
-        unsigned level     : 32; }                            header;
+        unsigned level     : 23;
+        unsigned lbd       : 7;
+        unsigned used      : 1;
+        unsigned protect   : 1; }                             header;
     union { Lit lit; float act; uint32_t abs; CRef rel; } data[0];
 
     friend class ClauseAllocator;
@@ -207,6 +210,9 @@ class Clause {
         header.reloced   = 0;
         header.size      = ps.size();
         header.level     = level;
+        header.lbd       = ps.size() < (int)LBD_MAX ? ps.size() : LBD_MAX;
+        header.used      = 0;
+        header.protect   = 0;
 
         for (int i = 0; i < ps.size(); i++) 
             data[i].lit = ps[i];
@@ -219,6 +225,9 @@ class Clause {
     }
 
 public:
+    // The largest LBD a clause can record; larger values saturate.
+    static const unsigned LBD_MAX = 127;
+
     void calcAbstraction() {
         assert(header.has_extra);
         uint32_t abstraction = 0;
@@ -236,6 +245,12 @@ public:
     uint32_t     mark        ()      const   { return header.mark; }
     void         mark        (uint32_t m)    { header.mark = m; }
     const Lit&   last        ()      const   { return data[header.size-1].lit; }
+    unsigned     lbd         ()      const   { return header.lbd; }
+    void         lbd         (unsigned l)    { header.lbd = l < LBD_MAX ? l : LBD_MAX; }
+    bool         used        ()      const   { return header.used; }
+    void         used        (bool u)        { header.used = u; }
+    bool         protect     ()      const   { return header.protect; }
+    void         protect     (bool p)        { header.protect = p; }
 
     bool         reloced     ()      const   { return header.reloced; }
     CRef         relocation  ()      const   { return data[0].rel; }
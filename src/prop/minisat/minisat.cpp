@@ -115,6 +115,9 @@ void MinisatSatSolver::initialize(context::Context* context, TheoryProxy* theory
   d_minisat = new Minisat::SimpSolver(theoryProxy, d_context,
                                       options::incrementalSolving() ||
                                       options::decisionMode() != decision::DECISION_STRATEGY_INTERNAL );
+  // Set before the first pop, which setupOptions() need not precede
+  d_minisat->retain_vars =
+      options::cnfReuse() && options::incrementalSolving();
 
   d_statistics.init(d_minisat);
 }
@@ -139,6 +142,16 @@ void MinisatSatSolver::setupOptions() {
   d_minisat->clause_decay = options::satClauseDecay();
   d_minisat->restart_first = options::satRestartFirst();
   d_minisat->restart_inc = options::satRestartInc();
+  d_minisat->lbd_tiers = options::satLbdTiers();
+  d_minisat->lbd_core = options::satLbdCore();
+  d_minisat->lbd_tier2 = options::satLbdTier2();
+  d_minisat->glucose_restart = options::satGlucoseRestarts();
+  d_minisat->chrono = options::satChronoBacktrack();
+  d_minisat->use_inprocess = options::satInprocess();
+  d_minisat->inprocess_interval = options::satInprocessInterval();
+  d_minisat->vivify_effort = options::satVivifyEffort();
+  d_minisat->subsume_effort = options::satSubsumeEffort();
+  d_minisat->trail_saving = options::satTrailSaving();
 }
 
 ClauseId MinisatSatSolver::addClause(SatClause& clause, bool removable) {
@@ -155,10 +168,31 @@ ClauseId MinisatSatSolver::addClause(SatClause& clause, bool removable) {
   return clause_id;
 }
 
+ClauseId MinisatSatSolver::addDefinitionClause(SatClause& clause) {
+  Minisat::vec<Minisat::Lit> minisat_clause;
+  toMinisatClause(clause, minisat_clause);
+  ClauseId clause_id = ClauseIdError;
+  if (!ok()) {
+    return ClauseIdUndef;
+  }
+  d_minisat->addDefinitionClause(minisat_clause, clause_id);
+  return clause_id;
+}
+
 SatVariable MinisatSatSolver::newVar(bool isTheoryAtom, bool preRegister, bool canErase) {
   return d_minisat->newVar(true, true, isTheoryAtom, preRegister, canErase);
 }
 
+void MinisatSatSolver::retainVar(SatVariable var) {
+  d_minisat->retainVar(var);
+}
+
+void MinisatSatSolver::reviveVar(SatVariable var,
+                                 bool isTheoryAtom,
+                                 bool preRegister) {
+  d_minisat->reviveVar(var, isTheoryAtom, preRegister);
+}
+
 SatValue MinisatSatSolver::solve(unsigned long& resource) {
   Trace("limit") << "SatSolver::solve(): have limit of " << resource << " conflicts" << std::endl;
   setupOptions();
@@ -234,6 +268,10 @@ void MinisatSatSolver::pop() {
 
 void MinisatSatSolver::resetTrail() { d_minisat->resetTrail(); }
 
+void MinisatSatSolver::setTraceRecorder(SatTraceRecorder* recorder) {
+  d_minisat->setTraceRecorder(recorder);
+}
+
 /// Statistics for MinisatSatSolver
 
 MinisatSatSolver::Statistics::Statistics(StatisticsRegistry* registry) :
@@ -246,7 +284,16 @@ MinisatSatSolver::Statistics::Statistics(StatisticsRegistry* registry) :
     d_statClausesLiterals("sat::clauses_literals"),
     d_statLearntsLiterals("sat::learnts_literals"),
     d_statMaxLiterals("sat::max_literals"),
-    d_statTotLiterals("sat::tot_literals")
+    d_statTotLiterals("sat::tot_literals"),
+    d_statChronoBacktracks("sat::chrono_backtracks"),
+    d_statInprocessings("sat::inprocessings"),
+    d_statVivifiedClauses("sat::vivified_clauses"),
+    d_statVivifiedLiterals("sat::vivified_literals"),
+    d_statSubsumedClauses("sat::subsumed_clauses"),
+    d_statReplayedLiterals("sat::replayed_literals"),
+    d_statReplayConflicts("sat::replay_conflicts"),
+    d_statRevivedVars("sat::revived_vars"),
+    d_statExplanationCacheHits("sat::explanation_cache_hits")
 {
   d_registry->registerStat(&d_statStarts);
   d_registry->registerStat(&d_statDecisions);
@@ -257,6 +304,15 @@ MinisatSatSolver::Statistics::Statistics(StatisticsRegistry* registry) :
   d_registry->registerStat(&d_statLearntsLiterals);
   d_registry->registerStat(&d_statMaxLiterals);
   d_registry->registerStat(&d_statTotLiterals);
+  d_registry->registerStat(&d_statChronoBacktracks);
+  d_registry->registerStat(&d_statInprocessings);
+  d_registry->registerStat(&d_statVivifiedClauses);
+  d_registry->registerStat(&d_statVivifiedLiterals);
+  d_registry->registerStat(&d_statSubsumedClauses);
+  d_registry->registerStat(&d_statReplayedLiterals);
+  d_registry->registerStat(&d_statReplayConflicts);
+  d_registry->registerStat(&d_statRevivedVars);
+  d_registry->registerStat(&d_statExplanationCacheHits);
 }
 
 MinisatSatSolver::Statistics::~Statistics() {
@@ -269,6 +325,15 @@ MinisatSatSolver::Statistics::~Statistics() {
   d_registry->unregisterStat(&d_statLearntsLiterals);
   d_registry->unregisterStat(&d_statMaxLiterals);
   d_registry->unregisterStat(&d_statTotLiterals);
+  d_registry->unregisterStat(&d_statChronoBacktracks);
+  d_registry->unregisterStat(&d_statInprocessings);
+  d_registry->unregisterStat(&d_statVivifiedClauses);
+  d_registry->unregisterStat(&d_statVivifiedLiterals);
+  d_registry->unregisterStat(&d_statSubsumedClauses);
+  d_registry->unregisterStat(&d_statReplayedLiterals);
+  d_registry->unregisterStat(&d_statReplayConflicts);
+  d_registry->unregisterStat(&d_statRevivedVars);
+  d_registry->unregisterStat(&d_statExplanationCacheHits);
 }
 
 void MinisatSatSolver::Statistics::init(Minisat::SimpSolver* d_minisat){
@@ -281,6 +346,15 @@ void MinisatSatSolver::Statistics::init(Minisat::SimpSolver* d_minisat){
   d_statLearntsLiterals.setData(d_minisat->learnts_literals);
   d_statMaxLiterals.setData(d_minisat->max_literals);
   d_statTotLiterals.setData(d_minisat->tot_literals);
+  d_statChronoBacktracks.setData(d_minisat->chrono_backtracks);
+  d_statInprocessings.setData(d_minisat->inprocessings);
+  d_statVivifiedClauses.setData(d_minisat->vivified_clauses);
+  d_statVivifiedLiterals.setData(d_minisat->vivified_literals);
+  d_statSubsumedClauses.setData(d_minisat->subsumed_clauses);
+  d_statReplayedLiterals.setData(d_minisat->replayed_literals);
+  d_statReplayConflicts.setData(d_minisat->replay_conflicts);
+  d_statRevivedVars.setData(d_minisat->revived_vars);
+  d_statExplanationCacheHits.setData(d_minisat->explanation_cache_hits);
 }
 
 } /* namespace CVC4::prop */
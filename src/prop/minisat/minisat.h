@@ -42,6 +42,7 @@ public:
   void initialize(context::Context* context, TheoryProxy* theoryProxy) override;
 
   ClauseId addClause(SatClause& clause, bool removable) override;
+  ClauseId addDefinitionClause(SatClause& clause) override;
   ClauseId addXorClause(SatClause& clause, bool rhs, bool removable) override
   {
     Unreachable("Minisat does not support native XOR reasoning");
@@ -50,6 +51,8 @@ public:
   SatVariable newVar(bool isTheoryAtom,
                      bool preRegister,
                      bool canErase) override;
+  void retainVar(SatVariable var) override;
+  void reviveVar(SatVariable var, bool isTheoryAtom, bool preRegister) override;
   SatVariable trueVar() override { return d_minisat->trueVar(); }
   SatVariable falseVar() override { return d_minisat->falseVar(); }
 
@@ -82,6 +85,8 @@ public:
 
   bool isDecision(SatVariable decn) const override;
 
+  void setTraceRecorder(SatTraceRecorder* recorder) override;
+
  private:
 
   /** The SatSolver used */
@@ -99,7 +104,11 @@ public:
     ReferenceStat<uint64_t> d_statRndDecisions, d_statPropagations;
     ReferenceStat<uint64_t> d_statConflicts, d_statClausesLiterals;
     ReferenceStat<uint64_t> d_statLearntsLiterals,  d_statMaxLiterals;
-    ReferenceStat<uint64_t> d_statTotLiterals;
+    ReferenceStat<uint64_t> d_statTotLiterals, d_statChronoBacktracks;
+    ReferenceStat<uint64_t> d_statInprocessings, d_statVivifiedClauses;
+    ReferenceStat<uint64_t> d_statVivifiedLiterals, d_statSubsumedClauses;
+    ReferenceStat<uint64_t> d_statReplayedLiterals, d_statReplayConflicts;
+    ReferenceStat<uint64_t> d_statRevivedVars, d_statExplanationCacheHits;
   public:
     Statistics(StatisticsRegistry* registry);
     ~Statistics();
@@ -28,12 +28,14 @@
 #include "options/decision_options.h"
 #include "options/main_options.h"
 #include "options/options.h"
+#include "options/prop_options.h"
 #include "options/smt_options.h"
 #include "proof/proof_manager.h"
 #include "proof/proof_manager.h"
 #include "prop/cnf_stream.h"
 #include "prop/sat_solver.h"
 #include "prop/sat_solver_factory.h"
+#include "prop/sat_trace_recorder.h"
 #include "prop/theory_proxy.h"
 #include "smt/smt_statistics_registry.h"
 #include "smt/command.h"
@@ -86,13 +88,21 @@ PropEngine::PropEngine(TheoryEngine* te, DecisionEngine *de, Context* satContext
   d_satSolver(NULL),
   d_registrar(NULL),
   d_cnfStream(NULL),
+  d_traceRecorder(NULL),
   d_interrupted(false),
   d_resourceManager(NodeManager::currentResourceManager())
 {
 
   Debug("prop") << "Constructing the PropEngine" << endl;
 
-  d_satSolver = SatSolverFactory::createDPLLMinisat(smtStatisticsRegistry());
+  if (options::dpllCadical())
+  {
+    d_satSolver = SatSolverFactory::createDPLLCadical(smtStatisticsRegistry());
+  }
+  else
+  {
+    d_satSolver = SatSolverFactory::createDPLLMinisat(smtStatisticsRegistry());
+  }
 
   d_registrar = new theory::TheoryRegistrar(d_theoryEngine);
   d_cnfStream = new CVC4::prop::TseitinCnfStream
@@ -100,13 +110,25 @@ PropEngine::PropEngine(TheoryEngine* te, DecisionEngine *de, Context* satContext
      // fullLitToNode Map =
      options::threads() > 1 ||
      options::decisionMode() == decision::DECISION_STRATEGY_RELEVANCY ||
-     ( CVC4_USE_REPLAY && replayLog != NULL ));
+     ( CVC4_USE_REPLAY && replayLog != NULL ),
+     "",
+     // proofs record the full definition of every subformula, and kept
+     // translations must be complete to be reused
+     options::cnfPolarity() && !PROOF_ON() && !options::cnfReuse(),
+     options::cnfReuse() && options::incrementalSolving());
 
   d_theoryProxy = new TheoryProxy(
-      this, d_theoryEngine, d_decisionEngine, d_context, d_cnfStream, replayLog,
-      replayStream, channels);
+      this, d_theoryEngine, d_decisionEngine, d_context, userContext,
+      d_cnfStream, replayLog, replayStream, channels);
   d_satSolver->initialize(d_context, d_theoryProxy);
 
+  if (!options::satTrace().empty())
+  {
+    d_traceRecorder = new SatTraceRecorder(options::satTrace());
+    d_satSolver->setTraceRecorder(d_traceRecorder);
+    d_cnfStream->setTraceRecorder(d_traceRecorder);
+  }
+
   d_decisionEngine->setSatSolver(d_satSolver);
   d_decisionEngine->setCnfStream(d_cnfStream);
   PROOF (
@@ -120,6 +142,7 @@ PropEngine::~PropEngine() {
   delete d_registrar;
   delete d_satSolver;
   delete d_theoryProxy;
+  delete d_traceRecorder;
 }
 
 void PropEngine::assertFormula(TNode node) {
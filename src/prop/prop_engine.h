@@ -46,6 +46,7 @@ namespace prop {
 
 class CnfStream;
 class DPLLSatSolverInterface;
+class SatTraceRecorder;
 
 class PropEngine;
 
@@ -85,6 +86,9 @@ class PropEngine {
   /** The CNF converter in use */
   CnfStream* d_cnfStream;
 
+  /** The recorder of the search, with --sat-trace */
+  SatTraceRecorder* d_traceRecorder;
+
   /** Whether we were just interrupted (or not) */
   bool d_interrupted;
   /** Pointer to resource manager for associated SmtEngine */
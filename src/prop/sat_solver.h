@@ -36,6 +36,7 @@ class BitVectorProof;
 
 namespace prop {
 
+class SatTraceRecorder;
 class TheoryProxy;
 
 class SatSolver {
@@ -49,6 +50,16 @@ public:
   virtual ClauseId addClause(SatClause& clause,
                              bool removable) = 0;
 
+  /**
+   * Assert a clause of the definition of a subformula, whose translation
+   * the CNF stream keeps across user pops (see reviveVar()).  Solvers that
+   * do not keep variables across pops assert it as a permanent clause.
+   */
+  virtual ClauseId addDefinitionClause(SatClause& clause)
+  {
+    return addClause(clause, false);
+  }
+
   /** Return true if the solver supports native xor resoning */
   virtual bool nativeXor() { return false; }
 
@@ -64,6 +75,26 @@ public:
    */
   virtual SatVariable newVar(bool isTheoryAtom, bool preRegister, bool canErase) = 0;
 
+  /**
+   * Keep a variable across the pop of the user level it was created at,
+   * for a translation the CNF stream keeps.  The solver deletes the other
+   * variables of a popped level.
+   */
+  virtual void retainVar(SatVariable var)
+  {
+    Unreachable("this SAT solver does not keep variables across pops");
+  }
+
+  /**
+   * Bring back a variable that was created (or last revived) at a popped
+   * user level, for a translation kept across the pop.  Only called on
+   * solvers that keep such variables, unassigned if it is a theory atom.
+   */
+  virtual void reviveVar(SatVariable var, bool isTheoryAtom, bool preRegister)
+  {
+    Unreachable("this SAT solver does not keep variables across pops");
+  }
+
   /** Create a new (or return an existing) boolean variable representing the constant true */
   virtual SatVariable trueVar() = 0;
 
@@ -161,6 +192,9 @@ public:
   virtual bool flipDecision() = 0;
 
   virtual bool isDecision(SatVariable decn) const = 0;
+
+  /** Records the search in the given trace (not owned), if supported */
+  virtual void setTraceRecorder(SatTraceRecorder* recorder) {}
 };/* class DPLLSatSolverInterface */
 
 inline std::ostream& operator <<(std::ostream& out, prop::SatLiteral lit) {
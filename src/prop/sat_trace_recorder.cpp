@@ -0,0 +1,110 @@
+/*********************                                                        */
+/*! \file sat_trace_recorder.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A recorder of the Boolean side of a DPLL(T) run
+ **
+ ** A recorder of the Boolean side of a DPLL(T) run.
+ **/
+
+#include "prop/sat_trace_recorder.h"
+
+#include <sstream>
+
+#include "base/output.h"
+#include "options/option_exception.h"
+
+namespace CVC4 {
+namespace prop {
+
+SatTraceRecorder::SatTraceRecorder(const std::string& filename)
+    : d_file(std::fopen(filename.c_str(), "w")),
+      d_learnt(false),
+      d_separate(false),
+      d_numDimacs(0)
+{
+  if (d_file == NULL)
+  {
+    throw OptionException("cannot open SAT trace file " + filename);
+  }
+  // The events are small and many: write them in large blocks
+  std::setvbuf(d_file, NULL, _IOFBF, 1 << 20);
+  std::fputs("p inccnf\n", d_file);
+}
+
+SatTraceRecorder::~SatTraceRecorder()
+{
+  if (std::fclose(d_file) != 0)
+  {
+    Warning() << "cannot write the SAT trace" << std::endl;
+  }
+}
+
+void SatTraceRecorder::solved(SatValue result)
+{
+  switch (result)
+  {
+    case SAT_VALUE_TRUE: std::fputs("c s sat\n", d_file); break;
+    case SAT_VALUE_FALSE: std::fputs("c s unsat\n", d_file); break;
+    default: std::fputs("c s unknown\n", d_file); break;
+  }
+  std::fputc('a', d_file);
+  for (int act : d_activation)
+  {
+    std::fputc(' ', d_file);
+    writeInt(act);
+  }
+  std::fputs(" 0\n", d_file);
+}
+
+void SatTraceRecorder::push()
+{
+  d_activation.push_back(++d_numDimacs);
+  std::fputs("c push ", d_file);
+  writeInt(d_activation.back());
+  std::fputc('\n', d_file);
+}
+
+void SatTraceRecorder::atom(SatVariable var, TNode node)
+{
+  std::stringstream ss;
+  ss << node;
+  std::string s = ss.str();
+  // Keep the atom on its line
+  for (char& c : s)
+  {
+    if (c == '\n')
+    {
+      c = ' ';
+    }
+  }
+  std::fprintf(d_file, "c v %d %s\n", toDimacs(var), s.c_str());
+}
+
+void SatTraceRecorder::writeInt(int n)
+{
+  char buffer[16];
+  char* end = buffer + sizeof(buffer);
+  char* p = end;
+  unsigned u = n < 0 ? 0u - unsigned(n) : unsigned(n);
+  do
+  {
+    *--p = char('0' + u % 10);
+    u /= 10;
+  } while (u != 0);
+  if (n < 0)
+  {
+    *--p = '-';
+  }
+  std::fwrite(p, 1, end - p, d_file);
+}
+
+}/* CVC4::prop namespace */
+}/* CVC4 namespace */
@@ -0,0 +1,189 @@
+/*********************                                                        */
+/*! \file sat_trace_recorder.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A recorder of the Boolean side of a DPLL(T) run
+ **
+ ** The recorder writes what the DPLL(T) SAT solver sees and does, as it
+ ** happens, in the incremental CNF format (iCNF) so that the Boolean core
+ ** of a query can be replayed offline by other SAT solvers:
+ **
+ **   p inccnf              header
+ **   1 -2 0                an input clause, theory lemma or theory
+ **                         explanation (the clauses of the Boolean core)
+ **   1 -2 -7 0             the same, for a clause the solver drops when
+ **                         user level 1 is popped, 7 being the
+ **                         activation literal of that level
+ **   a 7 0                 the end of a check-sat: solve the clauses so
+ **                         far, assuming the activation literals of the
+ **                         current user levels
+ **   c v 3 (= x y)         variable 3 stands for the given atom
+ **   c l -1 4 0            a learnt clause
+ **   c d -4                a decision
+ **   c r                   a restart
+ **   c s unsat             the result of the last check-sat
+ **   c push 7 / c pop      user push, with the activation literal of the
+ **                         new level, and pop
+ **
+ ** iCNF cannot retract clauses, so each user level has its own
+ ** activation literal: a clause of a popped level is never active again,
+ ** and a new level gets a new literal.  The DIMACS variables are numbered
+ ** in the order they first appear, activation literals included.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__PROP__SAT_TRACE_RECORDER_H
+#define __CVC4__PROP__SAT_TRACE_RECORDER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "base/cvc4_assert.h"
+#include "expr/node.h"
+#include "prop/sat_solver_types.h"
+
+namespace CVC4 {
+namespace prop {
+
+class SatTraceRecorder {
+ public:
+  /** Opens the trace file; throws an OptionException if it cannot. */
+  SatTraceRecorder(const std::string& filename);
+
+  /** Writes out the buffered events and closes the file. */
+  ~SatTraceRecorder();
+
+  /**
+   * Starts a clause of the Boolean core (learnt false) or a learnt
+   * clause (learnt true), to be followed by its literals and endClause().
+   */
+  void beginClause(bool learnt)
+  {
+    d_learnt = learnt;
+    if (learnt)
+    {
+      std::fputs("c l", d_file);
+      d_separate = true;
+    }
+    else
+    {
+      d_separate = false;
+    }
+  }
+
+  /** Adds a literal to the current clause. */
+  void literal(SatVariable var, bool negated)
+  {
+    writeLiteral(toDimacs(var), negated);
+  }
+
+  /**
+   * Ends the current clause.  A clause of the Boolean core that the solver
+   * keeps until the pop of the given user level (0 for a clause kept for
+   * good) gets the activation literal of that level.
+   */
+  void endClause(int level)
+  {
+    if (!d_learnt && level > 0)
+    {
+      Assert(size_t(level) <= d_activation.size());
+      writeLiteral(d_activation[level - 1], true);
+    }
+    std::fputs(d_separate ? " 0\n" : "0\n", d_file);
+  }
+
+  /** Records a decision on the literal. */
+  void decision(SatVariable var, bool negated)
+  {
+    std::fputs("c d ", d_file);
+    writeInt(negated ? -toDimacs(var) : toDimacs(var));
+    std::fputc('\n', d_file);
+  }
+
+  void restart() { std::fputs("c r\n", d_file); }
+
+  /** Records the end of a search, with its result. */
+  void solved(SatValue result);
+
+  /** Opens a user level, with a new activation literal. */
+  void push();
+
+  void pop()
+  {
+    Assert(!d_activation.empty());
+    d_activation.pop_back();
+    std::fputs("c pop\n", d_file);
+  }
+
+  /** Records the atom a SAT variable stands for. */
+  void atom(SatVariable var, TNode node);
+
+  /**
+   * Records a new SAT variable.  The solver reuses the slots of variables
+   * a user pop deleted, so the DIMACS variable of the old one is forgotten
+   * and the new one gets its own on first use.
+   */
+  void newVariable(SatVariable var)
+  {
+    if (var < d_dimacs.size())
+    {
+      d_dimacs[var] = 0;
+    }
+  }
+
+  /** The DIMACS variable of a SAT variable, numbered on first use */
+  int toDimacs(SatVariable var)
+  {
+    if (var >= d_dimacs.size())
+    {
+      d_dimacs.resize(var + 1, 0);
+    }
+    if (d_dimacs[var] == 0)
+    {
+      d_dimacs[var] = ++d_numDimacs;
+    }
+    return d_dimacs[var];
+  }
+
+ private:
+  SatTraceRecorder(const SatTraceRecorder&) = delete;
+  SatTraceRecorder& operator=(const SatTraceRecorder&) = delete;
+
+  void writeLiteral(int var, bool negated)
+  {
+    if (d_separate)
+    {
+      std::fputc(' ', d_file);
+    }
+    writeInt(negated ? -var : var);
+    d_separate = true;
+  }
+
+  void writeInt(int n);
+
+  FILE* d_file;
+  /** Whether the current clause is a learnt one */
+  bool d_learnt;
+  /** Whether the current clause line needs a space before the next literal */
+  bool d_separate;
+  /** The DIMACS variable of each SAT variable, 0 if it has none yet */
+  std::vector<int> d_dimacs;
+  /** The number of DIMACS variables handed out */
+  int d_numDimacs;
+  /** The activation literal of each user level above 0 */
+  std::vector<int> d_activation;
+};/* class SatTraceRecorder */
+
+}/* CVC4::prop namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__PROP__SAT_TRACE_RECORDER_H */
@@ -39,6 +39,7 @@ TheoryProxy::TheoryProxy(PropEngine* propEngine,
                          TheoryEngine* theoryEngine,
                          DecisionEngine* decisionEngine,
                          context::Context* context,
+                         context::Context* userContext,
                          CnfStream* cnfStream,
                          std::ostream* replayLog,
                          ExprStream* replayStream,
@@ -51,6 +52,7 @@ TheoryProxy::TheoryProxy(PropEngine* propEngine,
       d_replayLog(replayLog),
       d_replayStream(replayStream),
       d_queue(context),
+      d_explanations(userContext),
       d_replayedDecisions("prop::theoryproxy::replayedDecisions", 0)
 {
   smtStatisticsRegistry()->registerStat(&d_replayedDecisions);
@@ -89,6 +91,7 @@ void TheoryProxy::theoryPropagate(std::vector<SatLiteral>& output) {
   // Get the propagated literals
   std::vector<TNode> outputNodes;
   d_theoryEngine->getPropagatedLiterals(outputNodes);
+  output.reserve(output.size() + outputNodes.size());
   for (unsigned i = 0, i_end = outputNodes.size(); i < i_end; ++ i) {
     Debug("prop-explain") << "theoryPropagate() => " << outputNodes[i] << std::endl;
     output.push_back(d_cnfStream->getLiteral(outputNodes[i]));
@@ -128,6 +131,20 @@ void TheoryProxy::explainPropagation(SatLiteral l, SatClause& explanation) {
     explanation.push_back(l);
     explanation.push_back(~d_cnfStream->getLiteral(theoryExplanation));
   }
+
+  if (!PROOF_ON()) {
+    d_explanations.insert(l, explanation);
+  }
+}
+
+bool TheoryProxy::getCachedExplanation(SatLiteral l,
+                                       SatClause& explanation) const {
+  ExplanationCache::const_iterator it = d_explanations.find(l);
+  if (it == d_explanations.end()) {
+    return false;
+  }
+  explanation = (*it).second;
+  return true;
 }
 
 void TheoryProxy::enqueueTheoryLiteral(const SatLiteral& l) {
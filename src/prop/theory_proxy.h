@@ -26,6 +26,7 @@
 #include <iosfwd>
 #include <unordered_set>
 
+#include "context/cdhashmap.h"
 #include "context/cdqueue.h"
 #include "expr/expr_stream.h"
 #include "expr/node.h"
@@ -55,6 +56,7 @@ public:
               TheoryEngine* theoryEngine,
               DecisionEngine* decisionEngine,
               context::Context* context,
+              context::Context* userContext,
               CnfStream* cnfStream,
               std::ostream* replayLog,
               ExprStream* replayStream,
@@ -67,6 +69,13 @@ public:
 
   void explainPropagation(SatLiteral l, SatClause& explanation);
 
+  /**
+   * Copies the last explanation computed for l into explanation, if any.
+   * The clause is theory-valid, but the caller must check that it still
+   * explains l on the current assignment.
+   */
+  bool getCachedExplanation(SatLiteral l, SatClause& explanation) const;
+
   void theoryPropagate(SatClause& output);
 
   void enqueueTheoryLiteral(const SatLiteral& l);
@@ -141,6 +150,17 @@ public:
    */
   std::unordered_set<Node, NodeHashFunction> d_shared;
 
+  /**
+   * The last explanation of each propagated literal, in the user context.
+   * An explanation is a theory-valid clause, so it outlives the SAT
+   * context levels it was computed at and can explain the same
+   * propagation again after a backjump.  Not filled when producing
+   * proofs, which need the proof recipe of each explanation.
+   */
+  typedef context::CDHashMap<SatLiteral, SatClause, SatLiteralHashFunction>
+      ExplanationCache;
+  ExplanationCache d_explanations;
+
   /**
    * Statistic: the number of replayed decisions (via --replay).
    */
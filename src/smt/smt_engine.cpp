@@ -94,6 +94,7 @@
 #include "smt/logic_request.h"
 #include "smt/managed_ostreams.h"
 #include "smt/smt_engine_scope.h"
+#include "smt/statistics_sampler.h"
 #include "smt/term_formula_removal.h"
 #include "smt/update_ostream.h"
 #include "smt_util/boolean_simplification.h"
@@ -110,6 +111,8 @@
 #include "theory/quantifiers/sygus/ce_guided_instantiation.h"
 #include "theory/quantifiers/sygus_inference.h"
 #include "theory/quantifiers/term_util.h"
+#include "theory/persistent_rewrite_cache.h"
+#include "theory/rewrite_cache.h"
 #include "theory/sort_inference.h"
 #include "theory/strings/theory_strings.h"
 #include "theory/substitutions.h"
@@ -597,6 +600,12 @@ public:
    */
   void removeITEs();
 
+  /**
+   * Rewrite a top-level assertion, going through the on-disk rewrite
+   * cache if there is one (see --rewrite-cache-file).
+   */
+  Node rewriteAssertion(TNode n);
+
   Node realToInt(TNode n, NodeToNodeHashMap& cache, std::vector< Node >& var_eq);
   Node purifyNlTerms(TNode n, NodeToNodeHashMap& cache, NodeToNodeHashMap& bcache, std::vector< Node >& var_eq, bool beneathMult = false);
 
@@ -1003,6 +1012,9 @@ SmtEngine::SmtEngine(ExprManager* em)
       d_theoryEngine(NULL),
       d_propEngine(NULL),
       d_proofManager(NULL),
+      d_rewriteCache(NULL),
+      d_persistentRewriteCache(NULL),
+      d_statisticsSampler(NULL),
       d_definedFunctions(NULL),
       d_fmfRecFunctionsDefined(NULL),
       d_assertionList(NULL),
@@ -1080,6 +1092,27 @@ void SmtEngine::finishInit() {
   // ensure that our heuristics are properly set up
   setDefaults();
 
+  if (options::rewriteCacheSize() > 0)
+  {
+    d_rewriteCache = new theory::RewriteCache(options::rewriteCacheSize());
+  }
+  if (!options::rewriteCacheFile().empty())
+  {
+    d_persistentRewriteCache = new theory::PersistentRewriteCache(
+        options::rewriteCacheFile(), d_logic.getLogicString());
+    d_persistentRewriteCache->load();
+  }
+  if (!options::statsSampleFile().empty())
+  {
+    d_statisticsSampler = new smt::StatisticsSampler(
+        options::statsSampleFile(),
+        options::statsBinary() ? STATS_EXPORT_BINARY : STATS_EXPORT_JSON,
+        options::statsSampleInterval(),
+        options::statsSampleBuffer(),
+        d_statisticsRegistry,
+        NodeManager::currentResourceManager());
+  }
+
   Trace("smt-debug") << "Making decision engine..." << std::endl;
 
   d_decisionEngine = new DecisionEngine(d_context, d_userContext);
@@ -1224,12 +1257,24 @@ SmtEngine::~SmtEngine()
     //destroy all passes before destroying things that they refer to
     d_private->unregisterPreprocessingPasses();
 
+    // take the last sample while the theories' statistics are still there
+    delete d_statisticsSampler;
+    d_statisticsSampler = NULL;
+
     delete d_theoryEngine;
     d_theoryEngine = NULL;
     delete d_propEngine;
     d_propEngine = NULL;
     delete d_decisionEngine;
     d_decisionEngine = NULL;
+    delete d_rewriteCache;
+    d_rewriteCache = NULL;
+    if (d_persistentRewriteCache != NULL)
+    {
+      d_persistentRewriteCache->save();
+      delete d_persistentRewriteCache;
+      d_persistentRewriteCache = NULL;
+    }
 
 
 // d_proofManager is always created when proofs are enabled at configure time.
@@ -1325,6 +1370,72 @@ void SmtEngine::setDefaults() {
     options::sygusRepairConst.set(false);
   }
 
+  if (options::dpllCadical())
+  {
+    if (options::incrementalSolving())
+    {
+      if (options::incrementalSolving.wasSetByUser())
+      {
+        throw OptionException(std::string(
+            "CaDiCaL as the DPLL(T) solver does not support incremental mode. "
+            "Try without --dpll-cadical"));
+      }
+      Notice() << "SmtEngine: turning off incremental to use CaDiCaL as the "
+               << "DPLL(T) solver" << endl;
+      setOption("incremental", SExpr("false"));
+    }
+    if (options::proof() || options::unsatCores())
+    {
+      throw OptionException(std::string(
+          "CaDiCaL as the DPLL(T) solver does not support proofs or unsat "
+          "cores. Try without --dpll-cadical"));
+    }
+    if (options::cumulativeResourceLimit.wasSetByUser()
+        || options::perCallResourceLimit.wasSetByUser())
+    {
+      throw OptionException(std::string(
+          "CaDiCaL as the DPLL(T) solver does not support resource limits. "
+          "Try --tlimit or without --dpll-cadical"));
+    }
+  }
+
+  if (options::satChronoBacktrack() >= 0
+      && (options::proof() || options::unsatCores()))
+  {
+    throw OptionException(std::string(
+        "Chronological backtracking does not support proofs or unsat cores. "
+        "Try without --chrono-backtrack"));
+  }
+
+  if (options::cnfReuse() && (options::proof() || options::unsatCores()))
+  {
+    throw OptionException(std::string(
+        "Reusing the CNF translation across pops does not support proofs or "
+        "unsat cores. Try without --cnf-reuse"));
+  }
+
+  if (options::satInprocess())
+  {
+    if (options::incrementalSolving())
+    {
+      if (options::incrementalSolving.wasSetByUser())
+      {
+        throw OptionException(std::string(
+            "Inprocessing of learnt clauses does not support incremental mode. "
+            "Try without --sat-inprocess"));
+      }
+      Notice() << "SmtEngine: turning off incremental to inprocess learnt "
+               << "clauses" << endl;
+      setOption("incremental", SExpr("false"));
+    }
+    if (options::proof() || options::unsatCores())
+    {
+      throw OptionException(std::string(
+          "Inprocessing of learnt clauses does not support proofs or unsat "
+          "cores. Try without --sat-inprocess"));
+    }
+  }
+
   if (options::bitblastMode() == theory::bv::BITBLAST_MODE_EAGER)
   {
     if (options::incrementalSolving())
@@ -2966,6 +3077,13 @@ Node SmtEnginePrivate::purifyNlTerms(TNode n, NodeMap& cache, NodeMap& bcache, s
   return ret;
 }
 
+Node SmtEnginePrivate::rewriteAssertion(TNode n) {
+  if(d_smt.d_persistentRewriteCache != NULL) {
+    return d_smt.d_persistentRewriteCache->rewrite(n);
+  }
+  return Rewriter::rewrite(n);
+}
+
 void SmtEnginePrivate::removeITEs() {
   d_smt.finalOptionsAreSet();
   spendResource(options::preprocessStep());
@@ -2973,9 +3091,7 @@ void SmtEnginePrivate::removeITEs() {
 
   // Remove all of the ITE occurrences and normalize
   d_iteRemover.run(d_assertions.ref(), d_iteSkolemMap, true);
-  for (unsigned i = 0; i < d_assertions.size(); ++ i) {
-    d_assertions.replace(i, Rewriter::rewrite(d_assertions[i]));
-  }
+  d_assertions.mapAssertions([this](TNode a) { return rewriteAssertion(a); });
 }
 
 
@@ -4025,7 +4141,7 @@ void SmtEnginePrivate::applySubstitutionsToAssertions() {
       }
       Trace("simplify") << "applying to " << d_assertions[i] << endl;
       spendResource(options::preprocessStep());
-      d_assertions.replace(i, Rewriter::rewrite(d_topLevelSubstitutions.apply(d_assertions[i])));
+      d_assertions.replace(i, rewriteAssertion(d_topLevelSubstitutions.apply(d_assertions[i])));
       Trace("simplify") << "  got " << d_assertions[i] << endl;
     }
   }
@@ -4050,6 +4166,9 @@ void SmtEnginePrivate::processAssertions() {
     return;
   }
 
+  // Profiles the passes below that are not PreprocessingPasses (may be null)
+  PassProfiler* profiler = d_preprocessingPassContext->getPassProfiler();
+
   if (options::bvGaussElim())
   {
     TimerStat::CodeTimer gaussElimTimer(d_smt.d_stats->d_gaussElimTime);
@@ -4080,10 +4199,10 @@ void SmtEnginePrivate::processAssertions() {
     Chat() << "expanding definitions..." << endl;
     Trace("simplify") << "SmtEnginePrivate::simplify(): expanding definitions" << endl;
     TimerStat::CodeTimer codeTimer(d_smt.d_stats->d_definitionExpansionTime);
+    PassProfiler::Scope profile(profiler, "expand-definitions", d_assertions);
     unordered_map<Node, Node, NodeHashFunction> cache;
-    for(unsigned i = 0; i < d_assertions.size(); ++ i) {
-      d_assertions.replace(i, expandDefinitions(d_assertions[i], cache));
-    }
+    d_assertions.mapAssertions(
+        [&](TNode a) { return expandDefinitions(a, cache); });
   }
   Trace("smt-proc") << "SmtEnginePrivate::processAssertions() : post-definition-expansion" << endl;
   dumpAssertions("post-definition-expansion", d_assertions);
@@ -4107,6 +4226,7 @@ void SmtEnginePrivate::processAssertions() {
   }
 
   if( options::nlExtPurify() ){
+    PassProfiler::Scope profile(profiler, "nl-ext-purify", d_assertions);
     unordered_map<Node, Node, NodeHashFunction> cache;
     unordered_map<Node, Node, NodeHashFunction> bcache;
     std::vector< Node > var_eq;
@@ -4164,6 +4284,7 @@ void SmtEnginePrivate::processAssertions() {
 
   if (options::extRewPrep())
   {
+    PassProfiler::Scope profile(profiler, "ext-rew-prep", d_assertions);
     theory::quantifiers::ExtendedRewriter extr(options::extRewPrepAgg());
     for (unsigned i = 0; i < d_assertions.size(); ++i)
     {
@@ -4177,9 +4298,9 @@ void SmtEnginePrivate::processAssertions() {
     Trace("smt-proc") << "SmtEnginePrivate::processAssertions() : pre-unconstrained-simp" << endl;
     dumpAssertions("pre-unconstrained-simp", d_assertions);
     Chat() << "...doing unconstrained simplification..." << endl;
-    for (unsigned i = 0; i < d_assertions.size(); ++ i) {
-      d_assertions.replace(i, Rewriter::rewrite(d_assertions[i]));
-    }
+    PassProfiler::Scope profile(profiler, "unconstrained-simp", d_assertions);
+    d_assertions.mapAssertions(
+        [this](TNode a) { return rewriteAssertion(a); });
     unconstrainedSimp();
     Trace("smt-proc") << "SmtEnginePrivate::processAssertions() : post-unconstrained-simp" << endl;
     dumpAssertions("post-unconstrained-simp", d_assertions);
@@ -4193,13 +4314,15 @@ void SmtEnginePrivate::processAssertions() {
   Trace("smt-proc") << "SmtEnginePrivate::processAssertions() : pre-substitution" << endl;
   dumpAssertions("pre-substitution", d_assertions);
 
-  if(options::unsatCores()) {
-    // special rewriting pass for unsat cores, since many of the passes below are skipped
-    for (unsigned i = 0; i < d_assertions.size(); ++ i) {
-      d_assertions.replace(i, Rewriter::rewrite(d_assertions[i]));
+  {
+    PassProfiler::Scope profile(profiler, "substitution", d_assertions);
+    if(options::unsatCores()) {
+      // special rewriting pass for unsat cores, since many of the passes below are skipped
+      d_assertions.mapAssertions(
+          [this](TNode a) { return rewriteAssertion(a); });
+    } else {
+      applySubstitutionsToAssertions();
     }
-  } else {
-    applySubstitutionsToAssertions();
   }
   Trace("smt-proc") << "SmtEnginePrivate::processAssertions() : post-substitution" << endl;
   dumpAssertions("post-substitution", d_assertions);
@@ -4242,6 +4365,7 @@ void SmtEnginePrivate::processAssertions() {
 
   if( d_smt.d_logic.isQuantified() ){
     Trace("smt-proc") << "SmtEnginePrivate::processAssertions() : pre-quant-preprocess" << endl;
+    PassProfiler::Scope profile(profiler, "quant-preprocess", d_assertions);
 
     dumpAssertions("pre-skolem-quant", d_assertions);
     //remove rewrite rules, apply pre-skolemization to existential quantifiers
@@ -4325,7 +4449,10 @@ void SmtEnginePrivate::processAssertions() {
   Trace("smt-proc") << "SmtEnginePrivate::processAssertions() : pre-simplify" << endl;
   dumpAssertions("pre-simplify", d_assertions);
   Chat() << "simplifying assertions..." << endl;
-  noConflict = simplifyAssertions();
+  {
+    PassProfiler::Scope profile(profiler, "simplify", d_assertions);
+    noConflict = simplifyAssertions();
+  }
   if(!noConflict){
     ++(d_smt.d_stats->d_simplifiedToFalse);
   }
@@ -4349,6 +4476,7 @@ void SmtEnginePrivate::processAssertions() {
   {
     Chat() << "removing term ITEs..." << endl;
     TimerStat::CodeTimer codeTimer(d_smt.d_stats->d_iteRemovalTime);
+    PassProfiler::Scope profile(profiler, "ite-removal", d_assertions);
     // Remove ITEs, updating d_iteSkolemMap
     d_smt.d_stats->d_numAssertionsPre += d_assertions.size();
     removeITEs();
@@ -4365,6 +4493,7 @@ void SmtEnginePrivate::processAssertions() {
   if(options::repeatSimp()) {
     Trace("smt-proc") << "SmtEnginePrivate::processAssertions() : pre-repeat-simplify" << endl;
     Chat() << "re-simplifying assertions..." << endl;
+    PassProfiler::Scope profile(profiler, "repeat-simplify", d_assertions);
     ScopeCounter depth(d_simplifyAssertionsDepth);
     noConflict &= simplifyAssertions();
     if (noConflict) {
@@ -4437,6 +4566,8 @@ void SmtEnginePrivate::processAssertions() {
   if(options::rewriteApplyToConst()) {
     Chat() << "Rewriting applies to constants..." << endl;
     TimerStat::CodeTimer codeTimer(d_smt.d_stats->d_rewriteApplyToConstTime);
+    PassProfiler::Scope profile(
+        profiler, "rewrite-apply-to-const", d_assertions);
     for (unsigned i = 0; i < d_assertions.size(); ++ i) {
       d_assertions[i] = Rewriter::rewrite(rewriteApplyToConst(d_assertions[i]));
     }
@@ -4459,6 +4590,7 @@ void SmtEnginePrivate::processAssertions() {
   {
     Chat() << "theory preprocessing..." << endl;
     TimerStat::CodeTimer codeTimer(d_smt.d_stats->d_theoryPreprocessTime);
+    PassProfiler::Scope profile(profiler, "theory-preprocessing", d_assertions);
     // Call the theory preprocessors
     d_smt.d_theoryEngine->preprocessStart();
     for (unsigned i = 0; i < d_assertions.size(); ++ i) {
@@ -4497,6 +4629,11 @@ void SmtEnginePrivate::processAssertions() {
   Trace("smt-proc") << "SmtEnginePrivate::processAssertions() end" << endl;
   dumpAssertions("post-everything", d_assertions);
 
+  if (profiler != nullptr)
+  {
+    profiler->writeReport();
+  }
+
   // Push the formula to SAT
   {
     Chat() << "converting to CNF..." << endl;
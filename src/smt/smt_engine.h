@@ -78,6 +78,11 @@ namespace prop {
   class PropEngine;
 }/* CVC4::prop namespace */
 
+namespace theory {
+  class PersistentRewriteCache;
+  class RewriteCache;
+}/* CVC4::theory namespace */
+
 namespace smt {
   /**
    * Representation of a defined function.  We keep these around in
@@ -91,8 +96,10 @@ namespace smt {
   class SmtEnginePrivate;
   class SmtScope;
   class BooleanTermConverter;
+  class StatisticsSampler;
 
   ProofManager* currentProofManager();
+  theory::RewriteCache* currentRewriteCache();
 
   struct CommandCleanup;
   typedef context::CDList<Command*, CommandCleanup> CommandList;
@@ -145,6 +152,12 @@ class CVC4_PUBLIC SmtEngine {
   prop::PropEngine* d_propEngine;
   /** The proof manager */
   ProofManager* d_proofManager;
+  /** The cache in front of the Rewriter's attribute tables (may be null) */
+  theory::RewriteCache* d_rewriteCache;
+  /** The on-disk cache of assertion rewrites (may be null) */
+  theory::PersistentRewriteCache* d_persistentRewriteCache;
+  /** Periodic snapshots of the statistics for --stats-sample (may be null) */
+  smt::StatisticsSampler* d_statisticsSampler;
   /** An index of our defined functions */
   DefinedFunctionMap* d_definedFunctions;
   /** recursive function definition abstractions for --fmf-fun */
@@ -383,6 +396,7 @@ class CVC4_PUBLIC SmtEngine {
   friend class ::CVC4::smt::SmtScope;
   friend class ::CVC4::smt::BooleanTermConverter;
   friend ProofManager* ::CVC4::smt::currentProofManager();
+  friend theory::RewriteCache* ::CVC4::smt::currentRewriteCache();
   friend class ::CVC4::LogicRequest;
   // to access d_modelCommands
   friend class ::CVC4::Model;
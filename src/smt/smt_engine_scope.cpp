@@ -47,6 +47,13 @@ ProofManager* currentProofManager() {
 #endif /* IS_PROOFS_BUILD */
 }
 
+theory::RewriteCache* currentRewriteCache() {
+  if(s_smtEngine_current == NULL) {
+    return NULL;
+  }
+  return s_smtEngine_current->d_rewriteCache;
+}
+
 SmtScope::SmtScope(const SmtEngine* smt)
     : NodeManagerScope(smt->d_nodeManager),
       d_oldSmtEngine(s_smtEngine_current) {
@@ -28,6 +28,10 @@ class ProofManager;
 class SmtEngine;
 class StatisticsRegistry;
 
+namespace theory {
+class RewriteCache;
+}/* CVC4::theory namespace */
+
 namespace smt {
 
 SmtEngine* currentSmtEngine();
@@ -36,6 +40,12 @@ bool smtEngineInScope();
 // FIXME: Maybe move into SmtScope?
 ProofManager* currentProofManager();
 
+/**
+ * The RewriteCache of the SmtEngine in scope, or NULL if there is no
+ * SmtEngine in scope or it has no such cache.
+ */
+theory::RewriteCache* currentRewriteCache();
+
 class SmtScope : public NodeManagerScope {
   /** The old NodeManager, to be restored on destruction. */
   SmtEngine* d_oldSmtEngine;
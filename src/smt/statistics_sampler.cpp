@@ -0,0 +1,129 @@
+/*********************                                                        */
+/*! \file statistics_sampler.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Periodic snapshots of an SmtEngine's statistics
+ **
+ ** Periodic snapshots of an SmtEngine's statistics.
+ **/
+
+#include "smt/statistics_sampler.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "base/output.h"
+#include "util/resource_manager.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace smt {
+
+namespace {
+
+class SampleListener : public Listener {
+ public:
+  SampleListener(StatisticsSampler* sampler) : d_sampler(sampler) {}
+  void notify() override { d_sampler->safePoint(); }
+
+ private:
+  StatisticsSampler* d_sampler;
+};/* class SampleListener */
+
+}/* anonymous namespace */
+
+StatisticsSampler::StatisticsSampler(const std::string& filename,
+                                     StatisticsExportFormat format,
+                                     unsigned intervalMs,
+                                     unsigned bufferSize,
+                                     StatisticsRegistry* registry,
+                                     ResourceManager* resourceManager)
+    : d_filename(filename),
+      d_format(format),
+      d_interval(intervalMs),
+      d_bufferSize(bufferSize == 0 ? 1 : bufferSize),
+      d_registry(registry),
+      d_start(std::chrono::steady_clock::now()),
+      d_nextSample(d_start + d_interval),
+      d_safePoints(0),
+      d_buffer(),
+      d_fileStarted(false),
+      d_registration(resourceManager->registerSafePointListener(
+          new SampleListener(this)))
+{
+  d_buffer.reserve(d_bufferSize);
+}
+
+StatisticsSampler::~StatisticsSampler()
+{
+  d_registration.reset();
+  sample();
+  flush();
+}
+
+void StatisticsSampler::sample()
+{
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::chrono::milliseconds elapsed =
+      std::chrono::duration_cast<std::chrono::milliseconds>(now - d_start);
+
+  StatisticsExporter exporter;
+  exporter.add("sample::time", SExpr(Integer(elapsed.count())));
+  exporter.add(*d_registry);
+
+  std::stringstream ss;
+  if (d_format == STATS_EXPORT_JSON)
+  {
+    exporter.writeJson(ss);
+    ss << std::endl;
+  }
+  else
+  {
+    exporter.writeBinary(ss);
+  }
+  d_buffer.push_back(ss.str());
+  if (d_buffer.size() >= d_bufferSize)
+  {
+    flush();
+  }
+
+  d_nextSample = now + d_interval;
+}
+
+void StatisticsSampler::flush()
+{
+  if (d_buffer.empty())
+  {
+    return;
+  }
+  std::ofstream out(
+      d_filename.c_str(),
+      std::ios::out | std::ios::binary
+          | (d_fileStarted ? std::ios::app : std::ios::trunc));
+  if (!d_fileStarted && d_format == STATS_EXPORT_BINARY)
+  {
+    StatisticsExporter::writeBinaryMagic(out);
+  }
+  for (const std::string& s : d_buffer)
+  {
+    out << s;
+  }
+  out.close();
+  if (!out)
+  {
+    Warning() << "cannot write statistics samples to " << d_filename
+              << std::endl;
+  }
+  d_fileStarted = true;
+  d_buffer.clear();
+}
+
+}/* CVC4::smt namespace */
+}/* CVC4 namespace */
@@ -0,0 +1,112 @@
+/*********************                                                        */
+/*! \file statistics_sampler.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Periodic snapshots of an SmtEngine's statistics
+ **
+ ** The sampler takes a snapshot of every statistic in a registry at
+ ** regular intervals while the solver runs, so that the progress of a
+ ** long job can be plotted afterwards.  Snapshots are taken at the
+ ** ResourceManager's safe points, on the solver's own thread: a separate
+ ** sampling thread would read counters and timers while the solver
+ ** updates them.  The cost when no snapshot is due is a counter
+ ** increment, plus a clock read every few dozen safe points.
+ **
+ ** Snapshots are kept in a fixed-size buffer that is appended to the
+ ** sample file whenever it fills up, and when the sampler is destroyed.
+ ** In JSON format the file has one object per line, in binary format it
+ ** is a sequence of records (see util/statistics_export.h); each
+ ** snapshot includes "sample::time", the milliseconds since the sampler
+ ** was created.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__SMT__STATISTICS_SAMPLER_H
+#define __CVC4__SMT__STATISTICS_SAMPLER_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/listener.h"
+#include "util/statistics_export.h"
+
+namespace CVC4 {
+
+class ResourceManager;
+class StatisticsRegistry;
+
+namespace smt {
+
+class StatisticsSampler {
+ public:
+  /**
+   * Sample the statistics in registry every intervalMs milliseconds,
+   * keeping up to bufferSize snapshots in memory between writes to
+   * filename.
+   */
+  StatisticsSampler(const std::string& filename,
+                    StatisticsExportFormat format,
+                    unsigned intervalMs,
+                    unsigned bufferSize,
+                    StatisticsRegistry* registry,
+                    ResourceManager* resourceManager);
+
+  /** Takes a last snapshot and writes out the buffer. */
+  ~StatisticsSampler();
+
+  /** Called at each safe point; takes a snapshot if one is due. */
+  void safePoint()
+  {
+    if (++d_safePoints < SAFE_POINTS_PER_CLOCK_CHECK)
+    {
+      return;
+    }
+    d_safePoints = 0;
+    if (std::chrono::steady_clock::now() >= d_nextSample)
+    {
+      sample();
+    }
+  }
+
+ private:
+  /** The number of safe points between two looks at the clock. */
+  static const unsigned SAFE_POINTS_PER_CLOCK_CHECK = 64;
+
+  /** Takes a snapshot now. */
+  void sample();
+
+  /** Appends the buffered snapshots to the file and empties the buffer. */
+  void flush();
+
+  std::string d_filename;
+  StatisticsExportFormat d_format;
+  std::chrono::milliseconds d_interval;
+  size_t d_bufferSize;
+  StatisticsRegistry* d_registry;
+
+  std::chrono::steady_clock::time_point d_start;
+  std::chrono::steady_clock::time_point d_nextSample;
+  unsigned d_safePoints;
+
+  /** The encoded snapshots not yet written */
+  std::vector<std::string> d_buffer;
+  /** Whether the file has been started (so later writes append to it) */
+  bool d_fileStarted;
+
+  std::unique_ptr<ListenerCollection::Registration> d_registration;
+};/* class StatisticsSampler */
+
+}/* CVC4::smt namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__SMT__STATISTICS_SAMPLER_H */
@@ -0,0 +1,317 @@
+/*********************                                                        */
+/*! \file fp_shadow_simplex.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A floating-point simplex run on a double copy of the tableau
+ **
+ ** A floating-point simplex run on a double copy of the tableau.
+ **/
+
+#include "theory/arith/fp_shadow_simplex.h"
+
+#include <cmath>
+
+#include "base/output.h"
+
+using namespace std;
+
+namespace CVC4 {
+namespace theory {
+namespace arith {
+
+namespace {
+
+/* Violations smaller than this (relative to the bound) are not fixed. */
+const double s_feasibilityTolerance = 1e-9;
+/* Entries smaller than this are not pivoted on. */
+const double s_pivotTolerance = 1e-9;
+/* Entries smaller than this are dropped when rows are combined. */
+const double s_dropTolerance = 1e-13;
+/* Beyond this magnitude doubles no longer represent integers exactly. */
+const double s_maxMagnitude = 1e15;
+
+}/* anonymous namespace */
+
+FloatShadowSimplex::FloatShadowSimplex(const ArithVariables& vars,
+                                       const Tableau& tableau)
+  : d_vars(vars)
+  , d_tableau(tableau)
+  , d_rowsCurrent(false)
+  , d_rowsVersion(0)
+  , d_pivots(0)
+  , d_numericFailure(false)
+{}
+
+bool FloatShadowSimplex::sync(){
+  d_pivots = 0;
+  d_numericFailure = false;
+
+  size_t n = d_vars.getNumberOfVariables();
+  d_value.assign(n, 0.0);
+  d_lower.assign(n, -HUGE_VAL);
+  d_upper.assign(n, HUGE_VAL);
+  d_state.assign(n, Unmoved);
+  d_scratch.resize(n, 0.0);
+  d_inScratch.resize(n, false);
+  d_rowOf.resize(n, -1);
+  d_colRows.resize(n);
+
+  const double delta = ApproximateSimplex::SMALL_FIXED_DELTA;
+  for(ArithVariables::var_iterator vi = d_vars.var_begin(), vi_end = d_vars.var_end(); vi != vi_end; ++vi){
+    ArithVar v = *vi;
+    d_value[v] = d_vars.getAssignment(v).approx(delta);
+    check(d_value[v]);
+    if(d_vars.hasLowerBound(v)){
+      d_lower[v] = d_vars.getLowerBound(v).approx(delta);
+      check(d_lower[v]);
+    }
+    if(d_vars.hasUpperBound(v)){
+      d_upper[v] = d_vars.getUpperBound(v).approx(delta);
+      check(d_upper[v]);
+    }
+  }
+
+  if(d_rowsCurrent && d_rowsVersion == d_tableau.getVersion()){
+    return true;
+  }
+  copyRows();
+  return false;
+}
+
+void FloatShadowSimplex::copyRows(){
+  d_rows.clear();
+  d_rowOf.assign(d_rowOf.size(), -1);
+  for(vector< vector<uint32_t> >::iterator i = d_colRows.begin(), i_end = d_colRows.end(); i != i_end; ++i){
+    (*i).clear();
+  }
+
+  for(Tableau::BasicIterator bi = d_tableau.beginBasic(), bi_end = d_tableau.endBasic(); bi != bi_end; ++bi){
+    ArithVar basic = *bi;
+    uint32_t ridx = d_rows.size();
+    d_rows.push_back(Row());
+    Row& row = d_rows.back();
+    row.d_basic = basic;
+    d_rowOf[basic] = ridx;
+    for(Tableau::RowIterator ri = d_tableau.basicRowIterator(basic); !ri.atEnd(); ++ri){
+      const Tableau::Entry& entry = *ri;
+      ArithVar col = entry.getColVar();
+      if(col != basic){
+        double coeff = entry.getCoefficient().getDouble();
+        check(coeff);
+        row.d_entries.push_back(make_pair(col, coeff));
+        d_colRows[col].push_back(ridx);
+      }
+    }
+  }
+  d_rowsCurrent = true;
+  d_rowsVersion = d_tableau.getVersion();
+}
+
+void FloatShadowSimplex::check(double x){
+  if(!std::isfinite(x) || std::fabs(x) > s_maxMagnitude){
+    d_numericFailure = true;
+  }
+}
+
+double FloatShadowSimplex::tolerance(double bound) const{
+  return s_feasibilityTolerance * (1.0 + std::fabs(bound));
+}
+
+bool FloatShadowSimplex::belowLower(ArithVar v) const{
+  return d_value[v] < d_lower[v] - tolerance(d_lower[v]);
+}
+
+bool FloatShadowSimplex::aboveUpper(ArithVar v) const{
+  return d_value[v] > d_upper[v] + tolerance(d_upper[v]);
+}
+
+ArithVar FloatShadowSimplex::selectInfeasible() const{
+  ArithVar best = ARITHVAR_SENTINEL;
+  for(vector<Row>::const_iterator i = d_rows.begin(), i_end = d_rows.end(); i != i_end; ++i){
+    ArithVar b = (*i).d_basic;
+    if(b < best && (belowLower(b) || aboveUpper(b))){
+      best = b;
+    }
+  }
+  return best;
+}
+
+ArithVar FloatShadowSimplex::selectEntering(ArithVar b, bool increase) const{
+  ArithVar best = ARITHVAR_SENTINEL;
+  const RowEntries& entries = d_rows[d_rowOf[b]].d_entries;
+  for(RowEntries::const_iterator i = entries.begin(), i_end = entries.end(); i != i_end; ++i){
+    ArithVar nb = (*i).first;
+    double coeff = (*i).second;
+    if(nb >= best || std::fabs(coeff) < s_pivotTolerance){ continue; }
+    bool up = (coeff > 0) == increase;
+    bool canMove = up ?
+      d_value[nb] < d_upper[nb] - tolerance(d_upper[nb]) :
+      d_value[nb] > d_lower[nb] + tolerance(d_lower[nb]);
+    if(canMove){
+      best = nb;
+    }
+  }
+  return best;
+}
+
+double FloatShadowSimplex::coefficient(uint32_t ridx, ArithVar v) const{
+  const RowEntries& entries = d_rows[ridx].d_entries;
+  for(RowEntries::const_iterator i = entries.begin(), i_end = entries.end(); i != i_end; ++i){
+    if((*i).first == v){ return (*i).second; }
+  }
+  return 0.0;
+}
+
+void FloatShadowSimplex::pivotAndUpdate(ArithVar b, ArithVar e, bool increase){
+  uint32_t pivotRow = d_rowOf[b];
+  double a = coefficient(pivotRow, e);
+  Assert(a != 0.0);
+  // The rows now differ from the tableau's until it takes this basis
+  d_rowsCurrent = false;
+
+  double target = increase ? d_lower[b] : d_upper[b];
+  double theta = (target - d_value[b]) / a;
+
+  // Solve the pivot row for e:  e = (1/a) b - sum (c_j/a) x_j
+  RowEntries& pivotEntries = d_rows[pivotRow].d_entries;
+  RowEntries solved;
+  solved.reserve(pivotEntries.size());
+  solved.push_back(make_pair(b, 1.0 / a));
+  for(RowEntries::const_iterator i = pivotEntries.begin(), i_end = pivotEntries.end(); i != i_end; ++i){
+    if((*i).first != e){
+      solved.push_back(make_pair((*i).first, -(*i).second / a));
+    }
+  }
+  pivotEntries.swap(solved);
+  d_rows[pivotRow].d_basic = e;
+  d_rowOf[e] = pivotRow;
+  d_rowOf[b] = -1;
+  d_colRows[b].push_back(pivotRow);
+
+  d_value[e] += theta;
+  d_value[b] = target;
+  d_state[b] = increase ? AtLower : AtUpper;
+  check(d_value[e]);
+
+  // Substitute e away in the other rows that contain it
+  vector<uint32_t> rows;
+  rows.swap(d_colRows[e]);
+  for(vector<uint32_t>::const_iterator ri = rows.begin(), ri_end = rows.end(); ri != ri_end; ++ri){
+    uint32_t ridx = *ri;
+    if(ridx == pivotRow){ continue; }
+    double mult = coefficient(ridx, e);
+    if(mult == 0.0){ continue; }
+
+    Row& row = d_rows[ridx];
+    d_value[row.d_basic] += mult * theta;
+    check(d_value[row.d_basic]);
+
+    vector<ArithVar> touched;
+    for(RowEntries::const_iterator i = row.d_entries.begin(), i_end = row.d_entries.end(); i != i_end; ++i){
+      ArithVar v = (*i).first;
+      if(v != e){
+        d_scratch[v] = (*i).second;
+        d_inScratch[v] = true;
+        touched.push_back(v);
+      }
+    }
+    for(RowEntries::const_iterator i = pivotEntries.begin(), i_end = pivotEntries.end(); i != i_end; ++i){
+      ArithVar v = (*i).first;
+      if(d_inScratch[v]){
+        d_scratch[v] += mult * (*i).second;
+      }else{
+        d_scratch[v] = mult * (*i).second;
+        d_inScratch[v] = true;
+        touched.push_back(v);
+        d_colRows[v].push_back(ridx);
+      }
+    }
+    row.d_entries.clear();
+    for(vector<ArithVar>::const_iterator ti = touched.begin(), ti_end = touched.end(); ti != ti_end; ++ti){
+      ArithVar v = *ti;
+      double coeff = d_scratch[v];
+      d_inScratch[v] = false;
+      if(std::fabs(coeff) >= s_dropTolerance){
+        check(coeff);
+        row.d_entries.push_back(make_pair(v, coeff));
+      }
+    }
+  }
+  ++d_pivots;
+}
+
+LinResult FloatShadowSimplex::findModel(uint32_t pivotLimit){
+  while(!d_numericFailure){
+    ArithVar b = selectInfeasible();
+    if(b == ARITHVAR_SENTINEL){
+      Debug("arith::fpShadow") << "shadow feasible after " << d_pivots << endl;
+      return LinFeasible;
+    }
+    if(d_pivots >= pivotLimit){
+      return LinExhausted;
+    }
+    bool increase = belowLower(b);
+    ArithVar e = selectEntering(b, increase);
+    if(e == ARITHVAR_SENTINEL){
+      Debug("arith::fpShadow") << "shadow infeasible row " << b << endl;
+      return LinInfeasible;
+    }
+    pivotAndUpdate(b, e, increase);
+  }
+  Debug("arith::fpShadow") << "shadow gave up after " << d_pivots << endl;
+  // The rows may be what went wrong
+  d_rowsCurrent = false;
+  return LinUnknown;
+}
+
+ApproximateSimplex::Solution FloatShadowSimplex::extractSolution() const{
+  ApproximateSimplex::Solution sol;
+  for(ArithVariables::var_iterator vi = d_vars.var_begin(), vi_end = d_vars.var_end(); vi != vi_end; ++vi){
+    ArithVar v = *vi;
+    if(d_rowOf[v] >= 0){
+      sol.newBasis.add(v);
+    }else{
+      switch(d_state[v]){
+      case AtLower:
+        sol.newValues.set(v, d_vars.getLowerBound(v));
+        break;
+      case AtUpper:
+        sol.newValues.set(v, d_vars.getUpperBound(v));
+        break;
+      case Unmoved:
+      default:
+        sol.newValues.set(v, d_vars.getAssignment(v));
+        break;
+      }
+    }
+  }
+  return sol;
+}
+
+void FloatShadowSimplex::basisImported(){
+  if(d_rowsCurrent || d_numericFailure){
+    return;
+  }
+  size_t basics = 0;
+  for(Tableau::BasicIterator bi = d_tableau.beginBasic(), bi_end = d_tableau.endBasic(); bi != bi_end; ++bi){
+    if(d_rowOf[*bi] < 0){
+      return;
+    }
+    ++basics;
+  }
+  if(basics == d_rows.size()){
+    d_rowsCurrent = true;
+    d_rowsVersion = d_tableau.getVersion();
+  }
+}
+
+}/* CVC4::theory::arith namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
@@ -0,0 +1,139 @@
+/*********************                                                        */
+/*! \file fp_shadow_simplex.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A floating-point simplex run on a double copy of the tableau
+ **
+ ** The shadow copies the rows of the exact Tableau, the bounds and the
+ ** assignment into doubles and runs the same pivot-and-update search as the
+ ** exact simplex (infeasible basic variable and entering variable both
+ ** chosen by Bland's rule) without touching any Rational.  The only thing
+ ** it hands back is a basis and, for each non-basic variable, either its
+ ** exact current value or one of its exact bounds: AttemptSolutionSDP then
+ ** pivots the real Tableau to that basis, so every value and every
+ ** conclusion is recomputed exactly.  Numerical trouble (non-finite or huge
+ ** entries) gives up on the shadow rather than producing a guess.
+ **
+ ** The shadow lives as long as the tableau.  Its rows are only copied
+ ** again when the tableau changed since they were last a copy of it, which
+ ** they are again once the tableau was pivoted to the shadow's basis.
+ **/
+
+#include "cvc4_private.h"
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "theory/arith/approx_simplex.h"
+#include "theory/arith/arithvar.h"
+#include "theory/arith/partial_model.h"
+#include "theory/arith/tableau.h"
+
+namespace CVC4 {
+namespace theory {
+namespace arith {
+
+class FloatShadowSimplex {
+public:
+  FloatShadowSimplex(const ArithVariables& vars, const Tableau& tableau);
+
+  /**
+   * Copies the bounds and the assignment into doubles, and the rows of
+   * the tableau unless the current copy is still good.  Returns whether
+   * the rows were reused.
+   */
+  bool sync();
+
+  /**
+   * Searches for a feasible basis with at most pivotLimit pivots.
+   * Returns LinFeasible or LinInfeasible as judged in floating point,
+   * LinExhausted if it ran out of pivots and LinUnknown if the doubles
+   * could not be trusted.
+   */
+  LinResult findModel(uint32_t pivotLimit);
+
+  /** The basis reached by findModel() and the exact non-basic values. */
+  ApproximateSimplex::Solution extractSolution() const;
+
+  /**
+   * To be called once the solution was imported: if the tableau now has
+   * the shadow's basis, the rows are a copy of it again.
+   */
+  void basisImported();
+
+  uint32_t getPivots() const { return d_pivots; }
+
+private:
+  /** Where a non-basic variable of the shadow is */
+  enum VarState { Unmoved, AtLower, AtUpper };
+
+  typedef std::vector< std::pair<ArithVar, double> > RowEntries;
+  struct Row {
+    ArithVar d_basic;
+    /* d_basic = sum of coefficient * variable over the entries */
+    RowEntries d_entries;
+  };
+
+  /** Returns the smallest basic variable violating a bound, or the sentinel. */
+  ArithVar selectInfeasible() const;
+
+  /**
+   * Returns the smallest non-basic variable of b's row that can move b
+   * towards its violated bound (up if increase), or the sentinel.
+   */
+  ArithVar selectEntering(ArithVar b, bool increase) const;
+
+  /** Moves b to its violated bound and exchanges it with e in the basis. */
+  void pivotAndUpdate(ArithVar b, ArithVar e, bool increase);
+
+  /** Returns the coefficient of v in row ridx, or 0.0. */
+  double coefficient(uint32_t ridx, ArithVar v) const;
+
+  /** Records x; gives up on the shadow if x is not a usable double. */
+  void check(double x);
+
+  /** Copies the rows of the tableau into doubles. */
+  void copyRows();
+
+  double tolerance(double bound) const;
+  bool belowLower(ArithVar v) const;
+  bool aboveUpper(ArithVar v) const;
+
+  const ArithVariables& d_vars;
+  const Tableau& d_tableau;
+
+  /* Whether d_rows is a copy of the tableau at version d_rowsVersion */
+  bool d_rowsCurrent;
+  uint64_t d_rowsVersion;
+
+  std::vector<double> d_value;
+  std::vector<double> d_lower;
+  std::vector<double> d_upper;
+  std::vector<VarState> d_state;
+
+  std::vector<Row> d_rows;
+  /** ArithVar |-> index of its row if it is basic, -1 otherwise */
+  std::vector<int> d_rowOf;
+  /** ArithVar |-> rows that may contain it (a superset, checked on use) */
+  std::vector< std::vector<uint32_t> > d_colRows;
+
+  /* Dense scratch space for adding a multiple of one row to another */
+  std::vector<double> d_scratch;
+  std::vector<bool> d_inScratch;
+
+  uint32_t d_pivots;
+  bool d_numericFailure;
+};/* class FloatShadowSimplex */
+
+}/* CVC4::theory::arith namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
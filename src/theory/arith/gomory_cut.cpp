@@ -0,0 +1,148 @@
+/*********************                                                        */
+/*! \file gomory_cut.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Gomory mixed-integer cuts read off the exact Tableau
+ **
+ ** Gomory mixed-integer cuts read off the exact Tableau.
+ **/
+
+#include "theory/arith/gomory_cut.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/output.h"
+#include "theory/arith/constraint.h"
+
+using namespace std;
+
+namespace CVC4 {
+namespace theory {
+namespace arith {
+
+namespace {
+
+/** Returns q - floor(q), in [0, 1). */
+Rational fractionalPart(const Rational& q){
+  return q - Rational(q.floor());
+}
+
+}/* anonymous namespace */
+
+GomoryCutGenerator::GomoryCutGenerator(const ArithVariables& vars,
+                                       const Tableau& tableau)
+  : d_vars(vars)
+  , d_tableau(tableau)
+{}
+
+bool GomoryCutGenerator::generate(DenseVector& cut, ConstraintCPVec& exp) const{
+  // Rank the rows by how far the value is from an integer
+  const Rational half(1, 2);
+  vector< pair<Rational, ArithVar> > candidates;
+  for(Tableau::BasicIterator bi = d_tableau.beginBasic(), bi_end = d_tableau.endBasic(); bi != bi_end; ++bi){
+    ArithVar basic = *bi;
+    const DeltaRational& value = d_vars.getAssignment(basic);
+    if(d_vars.isInteger(basic) && value.infinitesimalIsZero() && !value.isIntegral()){
+      Rational f = fractionalPart(value.getNoninfinitesimalPart());
+      candidates.push_back(make_pair((f - half).abs(), basic));
+    }
+  }
+  sort(candidates.begin(), candidates.end());
+
+  for(vector< pair<Rational, ArithVar> >::const_iterator i = candidates.begin(), i_end = candidates.end(); i != i_end; ++i){
+    if(cutFromRow((*i).second, cut, exp)){
+      return true;
+    }
+  }
+  return false;
+}
+
+bool GomoryCutGenerator::cutFromRow(ArithVar basic, DenseVector& cut, ConstraintCPVec& exp) const{
+  Assert(d_tableau.isBasic(basic));
+  cut.purge();
+  exp.clear();
+
+  const DeltaRational& value = d_vars.getAssignment(basic);
+  if(!d_vars.isInteger(basic) || !value.infinitesimalIsZero()){
+    return false;
+  }
+  Rational f0 = fractionalPart(value.getNoninfinitesimalPart());
+  if(f0.isZero()){
+    return false;
+  }
+  Rational oneMinusF0 = Rational(1) - f0;
+
+  // The row reads basic = sum a_j x_j over the non-basic x_j.  With s_j the
+  // distance of x_j from its bound, basic + sum alpha_j s_j = value where
+  // alpha_j = -a_j at a lower bound and a_j at an upper bound.  The cut is
+  //   sum pi_j s_j >= 1
+  // with pi_j = f_j/f0 or (1-f_j)/(1-f0) for integral s_j (f_j being the
+  // fractional part of alpha_j), and alpha_j/f0 or -alpha_j/(1-f0) for the
+  // others.
+  Rational rhs(1);
+  for(Tableau::RowIterator ri = d_tableau.basicRowIterator(basic); !ri.atEnd(); ++ri){
+    const Tableau::Entry& entry = *ri;
+    ArithVar x = entry.getColVar();
+    if(x == basic){ continue; }
+
+    bool atLower = d_vars.hasLowerBound(x) && d_vars.cmpAssignmentLowerBound(x) == 0;
+    bool atUpper = !atLower &&
+      d_vars.hasUpperBound(x) && d_vars.cmpAssignmentUpperBound(x) == 0;
+    if(!atLower && !atUpper){
+      Debug("arith::gomory") << "row of " << basic << ": " << x << " is not at a bound" << endl;
+      return false;
+    }
+    ConstraintP bound = atLower ?
+      d_vars.getLowerBoundConstraint(x) : d_vars.getUpperBoundConstraint(x);
+    const DeltaRational& boundValue = bound->getValue();
+    if(!boundValue.infinitesimalIsZero()){
+      return false;
+    }
+    const Rational& b = boundValue.getNoninfinitesimalPart();
+
+    const Rational& a = entry.getCoefficient();
+    Rational alpha = atLower ? -a : a;
+    Rational pi;
+    if(d_vars.isInteger(x) && b.isIntegral()){
+      Rational fj = fractionalPart(alpha);
+      pi = (fj <= f0) ? fj / f0 : (Rational(1) - fj) / oneMinusF0;
+    }else{
+      pi = (alpha.sgn() > 0) ? alpha / f0 : -alpha / oneMinusF0;
+    }
+    if(pi.isZero()){ continue; }
+
+    // s_j is x - b at a lower bound and b - x at an upper bound
+    if(atLower){
+      cut.lhs.set(x, pi);
+      rhs += pi * b;
+    }else{
+      cut.lhs.set(x, -pi);
+      rhs -= pi * b;
+    }
+    exp.push_back(bound);
+  }
+
+  if(cut.lhs.empty()){
+    // The bounds alone force basic to its non-integral value
+    exp.clear();
+    return false;
+  }
+  cut.rhs = rhs;
+  Debug("arith::gomory") << "cut from the row of " << basic << ": ";
+  if(Debug.isOn("arith::gomory")){ cut.print(Debug("arith::gomory")); }
+  Debug("arith::gomory") << endl;
+  return true;
+}
+
+}/* CVC4::theory::arith namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
@@ -0,0 +1,66 @@
+/*********************                                                        */
+/*! \file gomory_cut.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Gomory mixed-integer cuts read off the exact Tableau
+ **
+ ** When the assignment is a vertex, i.e. every non-basic variable of a row
+ ** sits exactly on one of its bounds, the row of a basic integer variable x
+ ** with a non-integral value is
+ **   x = f + sum_j a_j s_j
+ ** where each s_j >= 0 is the distance of a non-basic variable from its
+ ** bound, and s_j is integral when the variable and its bound are.  The
+ ** Gomory mixed-integer cut of that row is a linear inequality that every
+ ** solution with x integral satisfies but the current assignment violates.
+ ** It is computed with exact Rationals, and is implied by the bounds of the
+ ** non-basic variables, which are its explanation.  This needs neither an
+ ** external LP solver nor the approximate simplex.
+ **/
+
+#include "cvc4_private.h"
+
+#pragma once
+
+#include "theory/arith/arithvar.h"
+#include "theory/arith/constraint_forward.h"
+#include "theory/arith/cut_log.h"
+#include "theory/arith/partial_model.h"
+#include "theory/arith/tableau.h"
+
+namespace CVC4 {
+namespace theory {
+namespace arith {
+
+class GomoryCutGenerator {
+public:
+  GomoryCutGenerator(const ArithVariables& vars, const Tableau& tableau);
+
+  /**
+   * Tries the rows of the basic integer variables with non-integral values,
+   * most fractional first.  On success, returns true, sets cut to a cut
+   * sum cut.lhs >= cut.rhs and exp to the bound constraints that imply it.
+   */
+  bool generate(DenseVector& cut, ConstraintCPVec& exp) const;
+
+  /**
+   * Computes the cut of the row of basic.  Fails if basic is not an
+   * integer variable with a non-integral standard value or if a non-basic
+   * variable on the row is not exactly on a bound.
+   */
+  bool cutFromRow(ArithVar basic, DenseVector& cut, ConstraintCPVec& exp) const;
+
+private:
+  const ArithVariables& d_vars;
+  const Tableau& d_tableau;
+};/* class GomoryCutGenerator */
+
+}/* CVC4::theory::arith namespace */
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <queue>
 #include <utility>
 #include <vector>
@@ -207,6 +208,19 @@ public:
   uint32_t size() const{ return d_size; }
   uint32_t capacity() const{ return d_entries.capacity(); }
 
+  /** One past the largest EntryID handed out, free or not. */
+  EntryID numSlots() const{ return d_entries.size(); }
+
+  /**
+   * Takes over entries (swapping them in) as the complete set of live
+   * entries, with no free slots.
+   */
+  void replace(EntryArray& entries){
+    d_entries.swap(entries);
+    std::queue<EntryID>().swap(d_freedEntries);
+    d_size = d_entries.size();
+  }
+
 
 private:
   bool inBounds(EntryID id) const{
@@ -399,6 +413,17 @@ protected:
 
   T d_zero;
 
+  /**
+   * If true, the entries are periodically renumbered so that the entries of
+   * each row are contiguous and in row order (see compact()).
+   */
+  bool d_compactLayout;
+
+  /** Entries added since the last compaction */
+  uint32_t d_entriesSinceCompaction;
+
+  uint32_t d_compactions;
+
 public:
   /**
    * Constructs an empty Matrix.
@@ -410,7 +435,10 @@ public:
     d_rowInMergeBuffer(ROW_INDEX_SENTINEL),
     d_entriesInUse(0),
     d_entries(),
-    d_zero(0)
+    d_zero(0),
+    d_compactLayout(false),
+    d_entriesSinceCompaction(0),
+    d_compactions(0)
   {}
 
   Matrix(const T& zero)
@@ -420,7 +448,10 @@ public:
     d_rowInMergeBuffer(ROW_INDEX_SENTINEL),
     d_entriesInUse(0),
     d_entries(),
-    d_zero(zero)
+    d_zero(zero),
+    d_compactLayout(false),
+    d_entriesSinceCompaction(0),
+    d_compactions(0)
   {}
 
   Matrix(const Matrix& m)
@@ -430,7 +461,10 @@ public:
     d_rowInMergeBuffer(m.d_rowInMergeBuffer),
     d_entriesInUse(m.d_entriesInUse),
     d_entries(m.d_entries),
-    d_zero(m.d_zero)
+    d_zero(m.d_zero),
+    d_compactLayout(m.d_compactLayout),
+    d_entriesSinceCompaction(m.d_entriesSinceCompaction),
+    d_compactions(m.d_compactions)
   {
     d_columns.clear();
     for(typename ColumnTable::const_iterator c=m.d_columns.begin(), cend = m.d_columns.end(); c!=cend; ++c){
@@ -450,6 +484,9 @@ public:
     d_entriesInUse = (m.d_entriesInUse);
     d_entries = (m.d_entries);
     d_zero = (m.d_zero);
+    d_compactLayout = m.d_compactLayout;
+    d_entriesSinceCompaction = m.d_entriesSinceCompaction;
+    d_compactions = m.d_compactions;
     d_columns.clear();
     for(typename ColumnTable::const_iterator c=m.d_columns.begin(), cend = m.d_columns.end(); c!=cend; ++c){
       const ColumnVector<T>& col = *c;
@@ -480,6 +517,7 @@ protected:
 
 
     ++d_entriesInUse;
+    ++d_entriesSinceCompaction;
 
     d_rows[row].insert(newId);
     d_columns[col].insert(newId);
@@ -905,6 +943,81 @@ public:
     releaseRowIndex(rid);
   }
 
+  void setCompactLayout(bool compact){
+    d_compactLayout = compact;
+  }
+
+  bool getCompactLayout() const { return d_compactLayout; }
+
+  /** The number of times the entries have been compacted. */
+  const uint32_t& getNumCompactions() const { return d_compactions; }
+
+  /**
+   * Renumbers the entries row by row so that the entries of each row are
+   * contiguous, in the order the row is iterated, and removes the free
+   * slots.  The order in which rows and columns are iterated is unchanged;
+   * only the EntryIDs (and so any Entry references) are invalidated.
+   * The merge buffer must be empty.
+   */
+  void compact(){
+    Assert(d_rowInMergeBuffer == ROW_INDEX_SENTINEL);
+    Assert(d_mergeBuffer.empty());
+
+    std::vector<EntryID> renumbered(d_entries.numSlots(), ENTRYID_SENTINEL);
+    std::vector<Entry> compacted;
+    compacted.reserve(d_entries.size());
+
+    for(RowIndex rid = 0, N = d_rows.size(); rid < N; ++rid){
+      EntryID head = compacted.size();
+      RowIterator i = getRow(rid).begin(), i_end = getRow(rid).end();
+      for(; i != i_end; ++i){
+        EntryID id = i.getID();
+        EntryID newId = compacted.size();
+        renumbered[id] = newId;
+        compacted.push_back(std::move(d_entries.get(id)));
+
+        Entry& entry = compacted.back();
+        entry.setPrevRowEntryID(newId == head ? ENTRYID_SENTINEL : newId - 1);
+        entry.setNextRowEntryID(newId + 1);
+      }
+      uint32_t length = compacted.size() - head;
+      if(length > 0){
+        compacted.back().setNextRowEntryID(ENTRYID_SENTINEL);
+      }
+      d_rows[rid] = RowVectorT(length > 0 ? head : ENTRYID_SENTINEL, length, &d_entries);
+    }
+    Assert(compacted.size() == d_entries.size());
+
+    for(typename std::vector<Entry>::iterator i = compacted.begin(), i_end = compacted.end(); i != i_end; ++i){
+      Entry& entry = *i;
+      EntryID prev = entry.getPrevColEntryID();
+      EntryID next = entry.getNextColEntryID();
+      entry.setPrevColEntryID(prev == ENTRYID_SENTINEL ? ENTRYID_SENTINEL : renumbered[prev]);
+      entry.setNextColEntryID(next == ENTRYID_SENTINEL ? ENTRYID_SENTINEL : renumbered[next]);
+    }
+    for(ArithVar v = 0, N = d_columns.size(); v < N; ++v){
+      const ColumnVectorT& col = d_columns[v];
+      EntryID head = col.getHead();
+      d_columns[v] = ColumnVectorT(head == ENTRYID_SENTINEL ? ENTRYID_SENTINEL : renumbered[head], col.getSize(), &d_entries);
+    }
+
+    d_entries.replace(compacted);
+    d_entriesSinceCompaction = 0;
+    ++d_compactions;
+  }
+
+  /**
+   * If the layout is kept compact, compacts once about as many entries have
+   * been added since the last compaction as half of the entries in use.
+   * The cost of compacting is then amortized over the additions.
+   */
+  void maybeCompact(){
+    if(d_compactLayout &&
+       d_entriesSinceCompaction >= std::max(d_entriesInUse / 2, (uint32_t)64)){
+      compact();
+    }
+  }
+
   double densityMeasure() const{
     Assert(numNonZeroEntriesByRow() == numNonZeroEntries());
     Assert(numNonZeroEntriesByCol() == numNonZeroEntries());
@@ -30,6 +30,8 @@ void Tableau::pivot(ArithVar oldBasic, ArithVar newBasic, CoefficientChangeCallb
   Assert(d_mergeBuffer.empty());
 
   Debug("tableau") << "Tableau::pivot(" <<  oldBasic <<", " << newBasic <<")"  << endl;
+  Trace("arith::pivot-log") << "pivot " << oldBasic << " " << newBasic << endl;
+  ++d_version;
 
   RowIndex ridx = basicToRowIndex(oldBasic);
 
@@ -62,6 +64,8 @@ void Tableau::pivot(ArithVar oldBasic, ArithVar newBasic, CoefficientChangeCallb
   Assert(!isBasic(oldBasic));
   Assert(isBasic(newBasic));
   Assert(getColLength(newBasic) == 1);
+
+  maybeCompact();
 }
 
 /**
@@ -104,6 +108,15 @@ void Tableau::addRow(ArithVar basic,
   Assert(debugIsASet(variables));
   Assert(coefficients.size() == variables.size() );
   Assert(!isBasic(basic));
+  ++d_version;
+
+  if(Trace.isOn("arith::pivot-log")){
+    Trace("arith::pivot-log") << "row " << basic;
+    for(size_t i = 0, N = variables.size(); i < N; ++i){
+      Trace("arith::pivot-log") << " " << variables[i] << " " << coefficients[i];
+    }
+    Trace("arith::pivot-log") << endl;
+  }
 
   RowIndex newRow = Matrix<Rational>::addRow(coefficients, variables);
   addEntry(newRow, basic, Rational(-1));
@@ -146,6 +159,8 @@ void Tableau::addRow(ArithVar basic,
 }
 
 void Tableau::removeBasicRow(ArithVar basic){
+  Trace("arith::pivot-log") << "remove " << basic << endl;
+  ++d_version;
   RowIndex rid = basicToRowIndex(basic);
 
   removeRow(rid);
@@ -155,6 +170,8 @@ void Tableau::removeBasicRow(ArithVar basic){
 
 void Tableau::substitutePlusTimesConstant(ArithVar to, ArithVar from, const Rational& mult,  CoefficientChangeCallback& cb){
   if(!mult.isZero()){
+    Trace("arith::pivot-log") << "substitute " << to << " " << from << " " << mult << endl;
+    ++d_version;
     RowIndex to_idx = basicToRowIndex(to);
     addEntry(to_idx, from, mult); // Add an entry to be cancelled out
     RowIndex from_idx = basicToRowIndex(from);
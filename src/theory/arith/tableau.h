@@ -35,6 +35,21 @@ namespace arith {
  * Each row has a basic variable with coefficient -1 that is solved.
  * Tableau is optimized for pivoting.
  * The tableau should only be updated via pivot calls.
+ *
+ * If the layout is kept compact (setCompactLayout()), pivot() periodically
+ * renumbers the entries so that each row is stored contiguously.  Entry
+ * references must then not be held across a pivot, which is already the
+ * case as pivoting may grow the entry storage.
+ *
+ * The rows added, pivots and removals are written to
+ * Trace("arith::pivot-log") one per line as
+ *   row <basic> <var> <coeff> <var> <coeff> ...
+ *   pivot <oldBasic> <newBasic>
+ *   substitute <to> <from> <mult>
+ *   add <basic> <var> <mult>
+ *   remove <basic>
+ * so that a pivot sequence can be recorded and replayed against the
+ * Tableau alone.
  */
 class Tableau : public Matrix<Rational> {
 public:
@@ -48,9 +63,18 @@ private:
   typedef DenseMap<ArithVar> RowIndexToBasicMap;
   RowIndexToBasicMap d_rowIndex2basic;
 
+  /* Incremented by every change to the rows, see getVersion() */
+  uint64_t d_version;
+
 public:
 
-  Tableau() : Matrix<Rational>(Rational(0)) {}
+  Tableau() : Matrix<Rational>(Rational(0)), d_version(0) {}
+
+  /**
+   * A number that changes whenever a row is added, removed, pivoted or
+   * modified, so that a copy of the rows can tell it is still current.
+   */
+  uint64_t getVersion() const { return d_version; }
 
   typedef Matrix<Rational>::ColIterator ColIterator;
   typedef Matrix<Rational>::RowIterator RowIterator;
@@ -139,6 +163,8 @@ public:
   void substitutePlusTimesConstant(ArithVar to, ArithVar from, const Rational& mult,  CoefficientChangeCallback& cb);
 
   void directlyAddToCoefficient(ArithVar rowVar, ArithVar col, const Rational& mult,  CoefficientChangeCallback& cb){
+    Trace("arith::pivot-log") << "add " << rowVar << " " << col << " " << mult << std::endl;
+    ++d_version;
     RowIndex ridx = basicToRowIndex(rowVar);
     manipulateRowEntry(ridx, col, mult, cb);
   }
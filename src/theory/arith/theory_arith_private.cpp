@@ -54,6 +54,7 @@
 #include "theory/arith/delta_rational.h"
 #include "theory/arith/delta_rational.h"
 #include "theory/arith/dio_solver.h"
+#include "theory/arith/gomory_cut.h"
 #include "theory/arith/linear_equality.h"
 #include "theory/arith/matrix.h"
 #include "theory/arith/matrix.h"
@@ -136,15 +137,21 @@ TheoryArithPrivate::TheoryArithPrivate(TheoryArith& containing,
           d_linEq, d_errorSet, RaiseConflict(*this), TempVarMalloc(*this)),
       d_attemptSolSimplex(
           d_linEq, d_errorSet, RaiseConflict(*this), TempVarMalloc(*this)),
+      d_fpShadow(d_partialModel, d_tableau),
       d_nonlinearExtension(NULL),
       d_pass1SDP(NULL),
       d_otherSDP(NULL),
       d_lastContextIntegerAttempted(c, -1),
 
       d_DELTA_ZERO(0),
+      d_boundTrail(c),
+      d_boundTrailHead(c, 0),
+      d_boundTrailColumn(c, 0),
+      d_boundTrailColumnVersion(c, 0),
       d_approxCuts(c),
       d_fullCheckCounter(0),
       d_cutCount(c, 0),
+      d_gomoryCutCount(c, 0),
       d_cutInContext(c),
       d_likelyIntegerInfeasible(c, false),
       d_guessedCoeffSet(c, false),
@@ -164,6 +171,8 @@ TheoryArithPrivate::TheoryArithPrivate(TheoryArith& containing,
       d_int_div_skolem(u),
       d_nlin_inverse_skolem(u)
 {
+  d_tableau.setCompactLayout(options::arithCompactTableau());
+  d_statistics.d_tableauCompactions.setData(d_tableau.getNumCompactions());
   if( options::nlExt() ){
     d_nonlinearExtension = new NonlinearExtension(
         containing, d_congruenceManager.getEqualityEngine());
@@ -349,6 +358,7 @@ TheoryArithPrivate::Statistics::Statistics()
   , d_newPropTime("theory::arith::newPropTimer")
   , d_externalBranchAndBounds("theory::arith::externalBranchAndBounds",0)
   , d_initialTableauSize("theory::arith::initialTableauSize", 0)
+  , d_tableauCompactions("theory::arith::tableauCompactions")
   , d_currSetToSmaller("theory::arith::currSetToSmaller", 0)
   , d_smallerSetToCurr("theory::arith::smallerSetToCurr", 0)
   , d_restartTimer("theory::arith::restartTimer")
@@ -389,6 +399,18 @@ TheoryArithPrivate::Statistics::Statistics()
   , d_relaxLinInfeasFailures("theory::arith::z::arith::relax::infeasible::failures",0)
   , d_relaxLinExhausted("theory::arith::z::arith::relax::exhausted",0)
   , d_relaxOthers("theory::arith::z::arith::relax::other",0)
+  , d_fpShadowCalls("theory::arith::z::fpShadow::calls",0)
+  , d_fpShadowDecided("theory::arith::z::fpShadow::decided",0)
+  , d_fpShadowFallbacks("theory::arith::z::fpShadow::fallbacks",0)
+  , d_fpShadowReused("theory::arith::z::fpShadow::reused",0)
+  , d_fpShadowTimer("theory::arith::z::fpShadow::timer")
+  , d_gomoryCuts("theory::arith::z::gomory::cuts",0)
+  , d_gomoryCutsRejected("theory::arith::z::gomory::rejected",0)
+  , d_gomoryTimer("theory::arith::z::gomory::timer")
+  , d_watchedPropRows("theory::arith::z::watchedProp::rows",0)
+  , d_watchedPropSuccesses("theory::arith::z::watchedProp::successes",0)
+  , d_watchedPropBudgetExhausted("theory::arith::z::watchedProp::budgetExhausted",0)
+  , d_watchedPropTimer("theory::arith::z::watchedProp::timer")
   , d_applyRowsDeleted("theory::arith::z::arith::cuts::applyRowsDeleted",0)
   , d_replaySimplexTimer("theory::arith::z::approx::replay::simplex::timer")
   , d_replayLogTimer("theory::arith::z::approx::replay::log::timer")
@@ -427,6 +449,7 @@ TheoryArithPrivate::Statistics::Statistics()
   smtStatisticsRegistry()->registerStat(&d_externalBranchAndBounds);
 
   smtStatisticsRegistry()->registerStat(&d_initialTableauSize);
+  smtStatisticsRegistry()->registerStat(&d_tableauCompactions);
   smtStatisticsRegistry()->registerStat(&d_currSetToSmaller);
   smtStatisticsRegistry()->registerStat(&d_smallerSetToCurr);
   smtStatisticsRegistry()->registerStat(&d_restartTimer);
@@ -476,6 +499,19 @@ TheoryArithPrivate::Statistics::Statistics()
   smtStatisticsRegistry()->registerStat(&d_relaxLinInfeasFailures);
   smtStatisticsRegistry()->registerStat(&d_relaxLinExhausted);
   smtStatisticsRegistry()->registerStat(&d_relaxOthers);
+  smtStatisticsRegistry()->registerStat(&d_fpShadowCalls);
+  smtStatisticsRegistry()->registerStat(&d_fpShadowDecided);
+  smtStatisticsRegistry()->registerStat(&d_fpShadowFallbacks);
+  smtStatisticsRegistry()->registerStat(&d_fpShadowReused);
+  smtStatisticsRegistry()->registerStat(&d_fpShadowTimer);
+  smtStatisticsRegistry()->registerStat(&d_gomoryCuts);
+  smtStatisticsRegistry()->registerStat(&d_gomoryCutsRejected);
+  smtStatisticsRegistry()->registerStat(&d_gomoryTimer);
+
+  smtStatisticsRegistry()->registerStat(&d_watchedPropRows);
+  smtStatisticsRegistry()->registerStat(&d_watchedPropSuccesses);
+  smtStatisticsRegistry()->registerStat(&d_watchedPropBudgetExhausted);
+  smtStatisticsRegistry()->registerStat(&d_watchedPropTimer);
 
   smtStatisticsRegistry()->registerStat(&d_applyRowsDeleted);
 
@@ -520,6 +556,7 @@ TheoryArithPrivate::Statistics::~Statistics(){
   smtStatisticsRegistry()->unregisterStat(&d_externalBranchAndBounds);
 
   smtStatisticsRegistry()->unregisterStat(&d_initialTableauSize);
+  smtStatisticsRegistry()->unregisterStat(&d_tableauCompactions);
   smtStatisticsRegistry()->unregisterStat(&d_currSetToSmaller);
   smtStatisticsRegistry()->unregisterStat(&d_smallerSetToCurr);
   smtStatisticsRegistry()->unregisterStat(&d_restartTimer);
@@ -569,6 +606,19 @@ TheoryArithPrivate::Statistics::~Statistics(){
   smtStatisticsRegistry()->unregisterStat(&d_relaxLinInfeasFailures);
   smtStatisticsRegistry()->unregisterStat(&d_relaxLinExhausted);
   smtStatisticsRegistry()->unregisterStat(&d_relaxOthers);
+  smtStatisticsRegistry()->unregisterStat(&d_fpShadowCalls);
+  smtStatisticsRegistry()->unregisterStat(&d_fpShadowDecided);
+  smtStatisticsRegistry()->unregisterStat(&d_fpShadowFallbacks);
+  smtStatisticsRegistry()->unregisterStat(&d_fpShadowReused);
+  smtStatisticsRegistry()->unregisterStat(&d_fpShadowTimer);
+  smtStatisticsRegistry()->unregisterStat(&d_gomoryCuts);
+  smtStatisticsRegistry()->unregisterStat(&d_gomoryCutsRejected);
+  smtStatisticsRegistry()->unregisterStat(&d_gomoryTimer);
+
+  smtStatisticsRegistry()->unregisterStat(&d_watchedPropRows);
+  smtStatisticsRegistry()->unregisterStat(&d_watchedPropSuccesses);
+  smtStatisticsRegistry()->unregisterStat(&d_watchedPropBudgetExhausted);
+  smtStatisticsRegistry()->unregisterStat(&d_watchedPropTimer);
 
   smtStatisticsRegistry()->unregisterStat(&d_applyRowsDeleted);
 
@@ -802,6 +852,7 @@ bool TheoryArithPrivate::AssertLower(ConstraintP constraint){
   }
 
   d_updatedBounds.softAdd(x_i);
+  pushBoundTrail(x_i);
 
   if(Debug.isOn("model")) {
     Debug("model") << "before" << endl;
@@ -942,6 +993,7 @@ bool TheoryArithPrivate::AssertUpper(ConstraintP constraint){
   }
 
   d_updatedBounds.softAdd(x_i);
+  pushBoundTrail(x_i);
 
   if(Debug.isOn("model")) {
     Debug("model") << "before" << endl;
@@ -1035,6 +1087,7 @@ bool TheoryArithPrivate::AssertEquality(ConstraintP constraint){
   }
 
   d_updatedBounds.softAdd(x_i);
+  pushBoundTrail(x_i);
 
   if(Debug.isOn("model")) {
     Debug("model") << "before" << endl;
@@ -3276,7 +3329,9 @@ bool TheoryArithPrivate::solveRealRelaxation(Theory::Effort effortLevel){
     << endl;
   
   bool noPivotLimitPass1 = noPivotLimit && !useApprox;
-  d_qflraStatus = simplex.findModel(noPivotLimitPass1);
+  if(!(options::fpShadowSimplex() && solveFloatShadow())){
+    d_qflraStatus = simplex.findModel(noPivotLimitPass1);
+  }
 
   Debug("TheoryArithPrivate::solveRealRelaxation")
     << "solveRealRelaxation()" << " pass1 " << d_qflraStatus << endl;
@@ -3352,6 +3407,35 @@ bool TheoryArithPrivate::solveRealRelaxation(Theory::Effort effortLevel){
   return emmittedConflictOrSplit;
 }
 
+bool TheoryArithPrivate::solveFloatShadow(){
+  if(d_errorSet.errorEmpty() && !d_errorSet.moreSignals()){
+    return false;
+  }
+  TimerStat::CodeTimer codeTimer(d_statistics.d_fpShadowTimer);
+  ++d_statistics.d_fpShadowCalls;
+
+  if(d_fpShadow.sync()){
+    ++d_statistics.d_fpShadowReused;
+  }
+  LinResult res = d_fpShadow.findModel(options::fpShadowPivotLimit());
+  Debug("arith::fpShadow") << "solveFloatShadow() " << res
+                           << " after " << d_fpShadow.getPivots() << endl;
+  if(res != LinFeasible && res != LinInfeasible){
+    ++d_statistics.d_fpShadowFallbacks;
+    return false;
+  }
+
+  // Pivots the tableau to the shadow's basis and recomputes it exactly
+  importSolution(d_fpShadow.extractSolution());
+  d_fpShadow.basisImported();
+  if(d_qflraStatus == Result::SAT_UNKNOWN){
+    ++d_statistics.d_fpShadowFallbacks;
+    return false;
+  }
+  ++d_statistics.d_fpShadowDecided;
+  return true;
+}
+
 //   LinUnknown,  /* Unknown error */
 //   LinFeasible, /* Relaxation is feasible */
 //   LinInfeasible,   /* Relaxation is infeasible/all integer branches closed */
@@ -3763,6 +3847,11 @@ void TheoryArithPrivate::check(Theory::Effort effortLevel){
   Debug("arith::ems") << "ems: " << emmittedConflictOrSplit
                       << "post unate" << endl;
 
+  if(!emmittedConflictOrSplit && d_qflraStatus == Result::SAT &&
+     options::arithWatchedPropBudget() > 0){
+    watchedRowPropagation();
+  }
+
   if(!emmittedConflictOrSplit && Theory::fullEffort(effortLevel)){
     ++d_fullCheckCounter;
   }
@@ -3804,6 +3893,18 @@ void TheoryArithPrivate::check(Theory::Effort effortLevel){
       }
     }
 
+    if(!emmittedConflictOrSplit &&
+       d_gomoryCutCount < options::arithGomoryCuts()){
+      Node possibleLemma = gomoryCut();
+      if(!possibleLemma.isNull()){
+        emmittedConflictOrSplit = true;
+        d_gomoryCutCount = d_gomoryCutCount + 1;
+        d_cutCount = d_cutCount + 1;
+        Debug("arith::lemma") << "gomory cut   " << possibleLemma << endl;
+        outputLemma(possibleLemma);
+      }
+    }
+
     if(!emmittedConflictOrSplit) {
       Node possibleLemma = roundRobinBranch();
       if(!possibleLemma.isNull()){
@@ -3858,6 +3959,32 @@ void TheoryArithPrivate::check(Theory::Effort effortLevel){
   Debug("arith") << "TheoryArithPrivate::check end" << std::endl;
 }
 
+Node TheoryArithPrivate::gomoryCut(){
+  TimerStat::CodeTimer codeTimer(d_statistics.d_gomoryTimer);
+
+  GomoryCutGenerator generator(d_partialModel, d_tableau);
+  DenseVector cut;
+  ConstraintCPVec exp;
+  if(!generator.generate(cut, exp)){
+    return Node::null();
+  }
+  if(!complexityBelow(cut.lhs, options::lemmaRejectCutSize())){
+    ++(d_statistics.d_gomoryCutsRejected);
+    return Node::null();
+  }
+  Node sum = toSumNode(d_partialModel, cut.lhs);
+  if(sum.isNull()){
+    ++(d_statistics.d_gomoryCutsRejected);
+    return Node::null();
+  }
+
+  NodeManager* nm = NodeManager::currentNM();
+  Node implied = Rewriter::rewrite(nm->mkNode(kind::GEQ, sum, mkRationalNode(cut.rhs)));
+  Node bounds = Constraint::externalExplainByAssertions(exp);
+  ++(d_statistics.d_gomoryCuts);
+  return bounds.impNode(implied);
+}
+
 Node TheoryArithPrivate::branchIntegerVariable(ArithVar x) const {
   const DeltaRational& d = d_partialModel.getAssignment(x);
   Assert(!d.isIntegral());
@@ -4827,7 +4954,6 @@ bool TheoryArithPrivate::propagateCandidateRow(RowIndex ridx){
   BoundCounts hasCount = d_linEq.hasBoundCount(ridx);
   uint32_t rowLength = d_tableau.getRowLength(ridx);
 
-  bool success = false;
   static int instance = 0;
   ++instance;
 
@@ -4840,6 +4966,13 @@ bool TheoryArithPrivate::propagateCandidateRow(RowIndex ridx){
   {
     return false;
   }
+  return propagateRowBounds(ridx);
+}
+
+bool TheoryArithPrivate::propagateRowBounds(RowIndex ridx){
+  BoundCounts hasCount = d_linEq.hasBoundCount(ridx);
+  uint32_t rowLength = d_tableau.getRowLength(ridx);
+  bool success = false;
 
   if(hasCount.lowerBoundCount() == rowLength){
     success |= attemptFull(ridx, false);
@@ -4855,6 +4988,79 @@ bool TheoryArithPrivate::propagateCandidateRow(RowIndex ridx){
   return success;
 }
 
+void TheoryArithPrivate::pushBoundTrail(ArithVar x){
+  if(options::arithWatchedPropBudget() > 0){
+    d_boundTrail.push_back(x);
+  }
+}
+
+void TheoryArithPrivate::watchedRowPropagation(){
+  Assert(d_qflraStatus == Result::SAT);
+  size_t head = d_boundTrailHead;
+  if(head >= d_boundTrail.size()){ return; }
+
+  TimerStat::CodeTimer codeTimer(d_statistics.d_watchedPropTimer);
+  UpdateTrackingCallback utcb(&d_linEq);
+  d_partialModel.processBoundsQueue(utcb);
+
+  // The bound counts of the rows are kept up to date on every bound
+  // assertion and pivot, so propagateRowBounds() only computes a row bound
+  // when at most one variable of the row lacks a bound in that direction.
+  // The work is the number of row entries visited.
+  const uint32_t budget = options::arithWatchedPropBudget();
+  uint32_t work = 0;
+  Assert(d_watchedRowsSeen.empty());
+  // A long column may hold more than the budget, so the budget is also
+  // checked between its rows; skip counts the rows of the column at head
+  // that an earlier call already visited.
+  uint32_t skip = 0;
+  if(d_boundTrailColumnVersion == d_tableau.getVersion()){
+    skip = d_boundTrailColumn;
+  }
+  while(head < d_boundTrail.size() && !anyConflict()){
+    if(work >= budget){
+      ++(d_statistics.d_watchedPropBudgetExhausted);
+      break;
+    }
+    ArithVar x = d_boundTrail[head];
+
+    if(d_tableau.isBasic(x)){
+      work += watchedPropagateRow(d_tableau.basicToRowIndex(x));
+    }else{
+      Tableau::ColIterator ci = d_tableau.colIterator(x);
+      uint32_t pos = 0;
+      for(; !ci.atEnd() && !anyConflict() && work < budget; ++ci, ++pos){
+        if(pos >= skip){
+          work += watchedPropagateRow((*ci).getRowIndex());
+        }
+      }
+      if(!ci.atEnd()){
+        skip = pos;
+        continue;
+      }
+    }
+    ++head;
+    skip = 0;
+  }
+  d_watchedRowsSeen.purge();
+  d_boundTrailHead = head;
+  d_boundTrailColumn = skip;
+  d_boundTrailColumnVersion = d_tableau.getVersion();
+
+  Debug("arith::prop") << "watchedRowPropagation " << work << " "
+                       << head << "/" << d_boundTrail.size() << endl;
+}
+
+uint32_t TheoryArithPrivate::watchedPropagateRow(RowIndex ridx){
+  if(d_watchedRowsSeen.isMember(ridx)){ return 0; }
+  d_watchedRowsSeen.add(ridx);
+  ++(d_statistics.d_watchedPropRows);
+  if(propagateRowBounds(ridx)){
+    ++(d_statistics.d_watchedPropSuccesses);
+  }
+  return d_tableau.getRowLength(ridx);
+}
+
 void TheoryArithPrivate::dumpUpdatedBoundsToRows(){
   Assert(d_candidateRows.empty());
   DenseSet::const_iterator i = d_updatedBounds.begin();
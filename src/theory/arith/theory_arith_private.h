@@ -48,6 +48,7 @@
 #include "theory/arith/dio_solver.h"
 #include "theory/arith/dual_simplex.h"
 #include "theory/arith/fc_simplex.h"
+#include "theory/arith/fp_shadow_simplex.h"
 #include "theory/arith/infer_bounds.h"
 #include "theory/arith/linear_equality.h"
 #include "theory/arith/matrix.h"
@@ -239,6 +240,12 @@ private:
   Node callDioSolver();
   Node dioCutting();
 
+  /**
+   * Returns a Gomory mixed-integer cut of the current vertex as a lemma
+   * (bounds => cut), or Node::null() if there is none (--arith-gomory-cuts).
+   */
+  Node gomoryCut();
+
   Comparison mkIntegerEqualityFromAssignment(ArithVar v);
 
   /**
@@ -373,12 +380,21 @@ private:
   FCSimplexDecisionProcedure d_fcSimplex;
   SumOfInfeasibilitiesSPD d_soiSimplex;
   AttemptSolutionSDP d_attemptSolSimplex;
+
+  /** The floating-point copy of the tableau for --fp-shadow-simplex */
+  FloatShadowSimplex d_fpShadow;
   
   /** non-linear algebraic approach */
   NonlinearExtension * d_nonlinearExtension;
 
   bool solveRealRelaxation(Theory::Effort effortLevel);
 
+  /**
+   * Runs FloatShadowSimplex and imports its basis (--fp-shadow-simplex).
+   * Returns true if this decided d_qflraStatus (SAT or UNSAT).
+   */
+  bool solveFloatShadow();
+
   /* Returns true if this is heuristically a good time to try
    * to solve the integers.
    */
@@ -569,6 +585,25 @@ private:
   DenseSet d_candidateBasics;
   DenseSet d_candidateRows;
 
+  /**
+   * The variables whose bounds were asserted, in assertion order, for the
+   * watched-row propagation (--arith-watched-prop).  The entries before
+   * d_boundTrailHead have been processed.  Both are context dependent so
+   * that a backtrack drops the retracted bounds and rewinds the head.
+   */
+  context::CDList<ArithVar> d_boundTrail;
+  context::CDO<size_t> d_boundTrailHead;
+  /**
+   * The entries of the column of the variable at d_boundTrailHead already
+   * visited when the budget ran out in the middle of it, and the version
+   * of the tableau then.  The column is started over if the tableau has
+   * changed since.
+   */
+  context::CDO<uint32_t> d_boundTrailColumn;
+  context::CDO<uint64_t> d_boundTrailColumnVersion;
+  /** The rows visited by the current watchedRowPropagation() call. */
+  DenseSet d_watchedRowsSeen;
+
   bool hasAnyUpdates() { return !d_updatedBounds.empty(); }
   void clearUpdates();
 
@@ -577,6 +612,28 @@ private:
   void propagateCandidatesNew();
   void dumpUpdatedBoundsToRows();
   bool propagateCandidateRow(RowIndex rid);
+  /**
+   * Derives the bounds implied by the row ridx in each direction where at
+   * most one variable lacks a bound.  This is propagateCandidateRow()
+   * without the random cutoff on long rows.
+   */
+  bool propagateRowBounds(RowIndex ridx);
+
+  /**
+   * Propagates over the rows of the variables on d_boundTrail, starting at
+   * d_boundTrailHead, until the rows visited total more than
+   * --arith-watched-prop entries.  The rest of the trail, starting in the
+   * middle of a column if need be, is left for the next call.  Requires
+   * the assignment to be feasible.
+   */
+  void watchedRowPropagation();
+  /**
+   * Propagates over ridx unless it was already visited by this call.
+   * Returns the work done, the length of the row or 0.
+   */
+  uint32_t watchedPropagateRow(RowIndex ridx);
+  /** Appends x to d_boundTrail if the watched-row propagation is on. */
+  void pushBoundTrail(ArithVar x);
   bool propagateMightSucceed(ArithVar v, bool ub) const;
   /** Attempt to perform a row propagation where there is at most 1 possible variable.*/
   bool attemptSingleton(RowIndex ridx, bool rowUp);
@@ -676,6 +733,8 @@ private:
   void branchVector(const std::vector<ArithVar>& lemmas);
 
   context::CDO<unsigned> d_cutCount;
+  /** The number of Gomory cuts emitted in the current context */
+  context::CDO<unsigned> d_gomoryCutCount;
   context::CDHashSet<ArithVar, std::hash<ArithVar> > d_cutInContext;
 
   context::CDO<bool> d_likelyIntegerInfeasible;
@@ -744,6 +803,7 @@ private:
     IntStat d_externalBranchAndBounds;
 
     IntStat d_initialTableauSize;
+    ReferenceStat<uint32_t> d_tableauCompactions;
     IntStat d_currSetToSmaller;
     IntStat d_smallerSetToCurr;
     TimerStat d_restartTimer;
@@ -789,6 +849,21 @@ private:
       d_relaxLinExhausted,
       d_relaxOthers;
 
+    IntStat d_fpShadowCalls,
+      d_fpShadowDecided,
+      d_fpShadowFallbacks,
+      d_fpShadowReused;
+    TimerStat d_fpShadowTimer;
+
+    IntStat d_gomoryCuts,
+      d_gomoryCutsRejected;
+    TimerStat d_gomoryTimer;
+
+    IntStat d_watchedPropRows,
+      d_watchedPropSuccesses,
+      d_watchedPropBudgetExhausted;
+    TimerStat d_watchedPropTimer;
+
     IntStat d_applyRowsDeleted;
     TimerStat d_replaySimplexTimer;
 
@@ -0,0 +1,768 @@
+/*********************                                                        */
+/*! \file persistent_rewrite_cache.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief An on-disk cache of rewrites of top-level assertions
+ **
+ ** An on-disk cache of rewrites of top-level assertions.
+ **/
+
+#include "theory/persistent_rewrite_cache.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+
+#include "base/configuration.h"
+#include "base/output.h"
+#include "expr/node_manager_attributes.h"
+#include "options/options.h"
+#include "smt/smt_statistics_registry.h"
+#include "theory/rewriter.h"
+#include "util/bitvector.h"
+#include "util/rational.h"
+
+using namespace std;
+
+namespace CVC4 {
+namespace theory {
+
+namespace {
+
+/** The first bytes of every cache file */
+const char s_magic[] = "CVC4 rewrite cache\n";
+
+/**
+ * The options read by the theory rewriters, and by Theory::theoryOf(),
+ * which picks the rewriter.  Their values are part of the file header,
+ * so that a cache written under one setting is never replayed under
+ * another.  A rewriter that starts reading an option must add it here.
+ */
+const char* const s_rewriterOptions[] = {
+    // theory::bv
+    "bv-div-zero-const",
+    "bv-extract-arith",
+    "bv-lazy-rewrite-extf",
+    // theory::datatypes
+    "dt-use-testers",
+    "sygus-eval-builtin",
+    // theory::quantifiers
+    "ag-miniscope-quant",
+    "cond-rewrite-quant",
+    "cond-var-split-agg-quant",
+    "cond-var-split-quant",
+    "dt-var-exp-quant",
+    "elim-ext-arith-quant",
+    "elim-taut-quant",
+    "ite-dtt-split-quant",
+    "ite-lift-quant",
+    "miniscope-quant",
+    "miniscope-quant-fv",
+    "pre-skolem-quant",
+    "pre-skolem-quant-agg",
+    "pre-skolem-quant-nested",
+    "prenex-quant",
+    "prenex-quant-user",
+    "quant-split",
+    "rewrite-rules",
+    "user-pat",
+    "var-elim-quant",
+    "var-ineq-elim-quant",
+    // theory::sep
+    "sep-pre-skolem-emp",
+    // theory
+    "theoryof-mode",
+    NULL};
+
+/** Record tags of the term encoding */
+const char TAG_VARIABLE = 'v';
+const char TAG_CONSTANT = 'c';
+const char TAG_NODE = 'n';
+
+uint64_t fnv1a(const char* data, size_t length, uint64_t h)
+{
+  for (size_t i = 0; i < length; ++i)
+  {
+    h ^= static_cast<unsigned char>(data[i]);
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+const uint64_t FNV_BASIS = 0xcbf29ce484222325ull;
+
+uint64_t checksum(const char* input,
+                  size_t inputLength,
+                  const char* result,
+                  size_t resultLength)
+{
+  return fnv1a(result, resultLength, fnv1a(input, inputLength, FNV_BASIS));
+}
+
+void writeUnsigned(string& out, uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    out.push_back(char((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(char(value));
+}
+
+void writeString(string& out, const string& s)
+{
+  writeUnsigned(out, s.size());
+  out.append(s);
+}
+
+void writeFixed64(string& out, uint64_t value)
+{
+  for (unsigned i = 0; i < 8; ++i)
+  {
+    out.push_back(char(value >> (8 * i)));
+  }
+}
+
+/** Reads back what the write functions above produce. */
+class Reader
+{
+ public:
+  Reader(const char* begin, const char* end) : d_pos(begin), d_end(end) {}
+
+  bool atEnd() const { return d_pos == d_end; }
+  const char* position() const { return d_pos; }
+
+  bool readUnsigned(uint64_t& value)
+  {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+      if (d_pos == d_end)
+      {
+        return false;
+      }
+      unsigned char c = *d_pos++;
+      value |= uint64_t(c & 0x7f) << shift;
+      if ((c & 0x80) == 0)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool readBytes(const char*& data, uint64_t& length)
+  {
+    if (!readUnsigned(length) || uint64_t(d_end - d_pos) < length)
+    {
+      return false;
+    }
+    data = d_pos;
+    d_pos += length;
+    return true;
+  }
+
+  bool readString(string& s)
+  {
+    const char* data;
+    uint64_t length;
+    if (!readBytes(data, length))
+    {
+      return false;
+    }
+    s.assign(data, length);
+    return true;
+  }
+
+  bool readChar(char& c)
+  {
+    if (d_pos == d_end)
+    {
+      return false;
+    }
+    c = *d_pos++;
+    return true;
+  }
+
+  bool readFixed64(uint64_t& value)
+  {
+    if (d_end - d_pos < 8)
+    {
+      return false;
+    }
+    value = 0;
+    for (unsigned i = 0; i < 8; ++i)
+    {
+      value |= uint64_t(static_cast<unsigned char>(*d_pos++)) << (8 * i);
+    }
+    return true;
+  }
+
+ private:
+  const char* d_pos;
+  const char* d_end;
+};/* class Reader */
+
+/**
+ * Writes a term as a postorder listing of its DAG.  Each distinct
+ * subterm is one record, referring to its children by record number.
+ *
+ * In collecting mode, free variables are numbered in order of first
+ * occurrence (and stored in vars) and written with their name and type.
+ * Otherwise only variables already in vars may occur, and they are
+ * written by number alone.
+ */
+class TermWriter
+{
+ public:
+  TermWriter(vector<Node>& vars, bool collect) : d_vars(vars), d_collect(collect)
+  {
+    for (size_t i = 0; i < vars.size(); ++i)
+    {
+      d_varIndex[vars[i]] = i;
+    }
+  }
+
+  /** Returns false if the term cannot be written. */
+  bool write(TNode n, string& out)
+  {
+    vector<pair<TNode, bool> > visit;
+    visit.push_back(make_pair(n, false));
+    while (!visit.empty())
+    {
+      TNode cur = visit.back().first;
+      if (d_record.find(cur) != d_record.end())
+      {
+        visit.pop_back();
+        continue;
+      }
+      kind::MetaKind mk = cur.getMetaKind();
+      if (!visit.back().second && mk != kind::metakind::VARIABLE
+          && mk != kind::metakind::CONSTANT)
+      {
+        visit.back().second = true;
+        for (size_t i = cur.getNumChildren(); i > 0; --i)
+        {
+          visit.push_back(make_pair(cur[i - 1], false));
+        }
+        if (mk == kind::metakind::PARAMETERIZED)
+        {
+          visit.push_back(make_pair(cur.getOperator(), false));
+        }
+        continue;
+      }
+      visit.pop_back();
+      if (!writeRecord(cur, out))
+      {
+        return false;
+      }
+      size_t index = d_record.size();
+      d_record[cur] = index;
+    }
+    return true;
+  }
+
+ private:
+  bool writeRecord(TNode n, string& out)
+  {
+    switch (n.getMetaKind())
+    {
+      case kind::metakind::VARIABLE: return writeVariable(n, out);
+      case kind::metakind::CONSTANT: return writeConstant(n, out);
+      case kind::metakind::PARAMETERIZED:
+      case kind::metakind::OPERATOR:
+      {
+        out.push_back(TAG_NODE);
+        writeUnsigned(out, n.getKind());
+        bool param = n.getMetaKind() == kind::metakind::PARAMETERIZED;
+        writeUnsigned(out, n.getNumChildren() + (param ? 1 : 0));
+        if (param)
+        {
+          writeUnsigned(out, d_record[n.getOperator()]);
+        }
+        for (TNode::iterator i = n.begin(); i != n.end(); ++i)
+        {
+          writeUnsigned(out, d_record[*i]);
+        }
+        return true;
+      }
+      default: return false;
+    }
+  }
+
+  bool writeVariable(TNode n, string& out)
+  {
+    if (n.getKind() != kind::VARIABLE)
+    {
+      return false;
+    }
+    unordered_map<TNode, size_t, TNodeHashFunction>::const_iterator i =
+        d_varIndex.find(n);
+    if (i != d_varIndex.end())
+    {
+      out.push_back(TAG_VARIABLE);
+      writeUnsigned(out, (*i).second);
+      return true;
+    }
+    std::string name;
+    if (!d_collect || !n.getAttribute(expr::VarNameAttr(), name))
+    {
+      return false;
+    }
+    size_t index = d_vars.size();
+    d_vars.push_back(n);
+    d_varIndex[n] = index;
+    out.push_back(TAG_VARIABLE);
+    writeUnsigned(out, index);
+    writeString(out, name);
+    writeString(out, n.getType().toString());
+    return true;
+  }
+
+  bool writeConstant(TNode n, string& out)
+  {
+    out.push_back(TAG_CONSTANT);
+    writeUnsigned(out, n.getKind());
+    switch (n.getKind())
+    {
+      case kind::CONST_BOOLEAN:
+        writeUnsigned(out, n.getConst<bool>() ? 1 : 0);
+        return true;
+      case kind::CONST_RATIONAL:
+        writeString(out, n.getConst<Rational>().toString());
+        return true;
+      case kind::CONST_BITVECTOR:
+        writeUnsigned(out, n.getConst<BitVector>().getSize());
+        writeString(out, n.getConst<BitVector>().getValue().toString());
+        return true;
+      case kind::BITVECTOR_EXTRACT_OP:
+        writeUnsigned(out, n.getConst<BitVectorExtract>().high);
+        writeUnsigned(out, n.getConst<BitVectorExtract>().low);
+        return true;
+      case kind::BITVECTOR_REPEAT_OP:
+        writeUnsigned(out, unsigned(n.getConst<BitVectorRepeat>()));
+        return true;
+      case kind::BITVECTOR_ZERO_EXTEND_OP:
+        writeUnsigned(out, unsigned(n.getConst<BitVectorZeroExtend>()));
+        return true;
+      case kind::BITVECTOR_SIGN_EXTEND_OP:
+        writeUnsigned(out, unsigned(n.getConst<BitVectorSignExtend>()));
+        return true;
+      case kind::BITVECTOR_ROTATE_LEFT_OP:
+        writeUnsigned(out, unsigned(n.getConst<BitVectorRotateLeft>()));
+        return true;
+      case kind::BITVECTOR_ROTATE_RIGHT_OP:
+        writeUnsigned(out, unsigned(n.getConst<BitVectorRotateRight>()));
+        return true;
+      default: return false;
+    }
+  }
+
+  vector<Node>& d_vars;
+  bool d_collect;
+  unordered_map<TNode, size_t, TNodeHashFunction> d_varIndex;
+  unordered_map<TNode, size_t, TNodeHashFunction> d_record;
+};/* class TermWriter */
+
+bool readConstant(Kind k, Reader& r, Node& n)
+{
+  NodeManager* nm = NodeManager::currentNM();
+  uint64_t a, b;
+  string s;
+  switch (k)
+  {
+    case kind::CONST_BOOLEAN:
+      if (!r.readUnsigned(a)) return false;
+      n = nm->mkConst(a != 0);
+      return true;
+    case kind::CONST_RATIONAL:
+      if (!r.readString(s)) return false;
+      n = nm->mkConst(Rational(s));
+      return true;
+    case kind::CONST_BITVECTOR:
+      if (!r.readUnsigned(a) || !r.readString(s)) return false;
+      n = nm->mkConst(BitVector(unsigned(a), Integer(s)));
+      return true;
+    case kind::BITVECTOR_EXTRACT_OP:
+      if (!r.readUnsigned(a) || !r.readUnsigned(b)) return false;
+      n = nm->mkConst(BitVectorExtract(unsigned(a), unsigned(b)));
+      return true;
+    case kind::BITVECTOR_REPEAT_OP:
+      if (!r.readUnsigned(a)) return false;
+      n = nm->mkConst(BitVectorRepeat(unsigned(a)));
+      return true;
+    case kind::BITVECTOR_ZERO_EXTEND_OP:
+      if (!r.readUnsigned(a)) return false;
+      n = nm->mkConst(BitVectorZeroExtend(unsigned(a)));
+      return true;
+    case kind::BITVECTOR_SIGN_EXTEND_OP:
+      if (!r.readUnsigned(a)) return false;
+      n = nm->mkConst(BitVectorSignExtend(unsigned(a)));
+      return true;
+    case kind::BITVECTOR_ROTATE_LEFT_OP:
+      if (!r.readUnsigned(a)) return false;
+      n = nm->mkConst(BitVectorRotateLeft(unsigned(a)));
+      return true;
+    case kind::BITVECTOR_ROTATE_RIGHT_OP:
+      if (!r.readUnsigned(a)) return false;
+      n = nm->mkConst(BitVectorRotateRight(unsigned(a)));
+      return true;
+    default: return false;
+  }
+}
+
+/**
+ * Rebuilds a term written by a non-collecting TermWriter over the given
+ * variables.  Returns false if the data is malformed.
+ */
+bool readTerm(const char* data,
+              size_t length,
+              const vector<Node>& vars,
+              Node& result)
+{
+  Reader r(data, data + length);
+  vector<Node> records;
+  while (!r.atEnd())
+  {
+    char tag;
+    uint64_t k, index, count;
+    if (!r.readChar(tag))
+    {
+      return false;
+    }
+    if (tag == TAG_VARIABLE)
+    {
+      if (!r.readUnsigned(index) || index >= vars.size())
+      {
+        return false;
+      }
+      records.push_back(vars[index]);
+    }
+    else if (tag == TAG_CONSTANT)
+    {
+      Node n;
+      if (!r.readUnsigned(k) || k >= kind::LAST_KIND
+          || !readConstant(Kind(k), r, n))
+      {
+        return false;
+      }
+      records.push_back(n);
+    }
+    else if (tag == TAG_NODE)
+    {
+      if (!r.readUnsigned(k) || k >= kind::LAST_KIND || !r.readUnsigned(count))
+      {
+        return false;
+      }
+      NodeBuilder<> nb(static_cast<Kind>(k));
+      for (uint64_t i = 0; i < count; ++i)
+      {
+        if (!r.readUnsigned(index) || index >= records.size())
+        {
+          return false;
+        }
+        nb << records[index];
+      }
+      records.push_back(Node(nb));
+    }
+    else
+    {
+      return false;
+    }
+  }
+  if (records.empty())
+  {
+    return false;
+  }
+  result = records.back();
+  return true;
+}
+
+}/* anonymous namespace */
+
+PersistentRewriteCache::Statistics::Statistics()
+    : d_hits("theory::PersistentRewriteCache::hits", 0),
+      d_misses("theory::PersistentRewriteCache::misses", 0),
+      d_unsupported("theory::PersistentRewriteCache::unsupported", 0),
+      d_loaded("theory::PersistentRewriteCache::loaded", 0),
+      d_saved("theory::PersistentRewriteCache::saved", 0)
+{
+  smtStatisticsRegistry()->registerStat(&d_hits);
+  smtStatisticsRegistry()->registerStat(&d_misses);
+  smtStatisticsRegistry()->registerStat(&d_unsupported);
+  smtStatisticsRegistry()->registerStat(&d_loaded);
+  smtStatisticsRegistry()->registerStat(&d_saved);
+}
+
+PersistentRewriteCache::Statistics::~Statistics()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_hits);
+  smtStatisticsRegistry()->unregisterStat(&d_misses);
+  smtStatisticsRegistry()->unregisterStat(&d_unsupported);
+  smtStatisticsRegistry()->unregisterStat(&d_loaded);
+  smtStatisticsRegistry()->unregisterStat(&d_saved);
+}
+
+PersistentRewriteCache::PersistentRewriteCache(const std::string& filename,
+                                               const std::string& context)
+    : d_filename(filename),
+      d_context(context),
+      d_data(NULL),
+      d_size(0),
+      d_mapped(false),
+      d_validSize(0)
+{
+}
+
+PersistentRewriteCache::~PersistentRewriteCache() { unmap(); }
+
+std::string PersistentRewriteCache::header() const
+{
+  stringstream build;
+  build << Configuration::getVersionString();
+  if (Configuration::isGitBuild())
+  {
+    build << " [" << Configuration::getGitId() << "]";
+  }
+  build << " " << Configuration::getCompiledDateTime();
+
+  stringstream opts;
+  for (const char* const* o = s_rewriterOptions; *o != NULL; ++o)
+  {
+    opts << *o << "=" << Options::current()->getOption(*o) << "\n";
+  }
+
+  string h = s_magic;
+  writeString(h, build.str());
+  writeString(h, d_context);
+  writeString(h, opts.str());
+  return h;
+}
+
+void PersistentRewriteCache::load()
+{
+  unmap();
+  d_entries.clear();
+  d_added.clear();
+#ifndef _WIN32
+  int fd = open(d_filename.c_str(), O_RDONLY);
+  if (fd == -1)
+  {
+    Trace("rewrite-cache-file") << "no rewrite cache at " << d_filename
+                                << std::endl;
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == -1 || st.st_size == 0)
+  {
+    close(fd);
+    return;
+  }
+  void* data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    Warning() << "cannot map rewrite cache " << d_filename << std::endl;
+    return;
+  }
+  d_data = static_cast<const char*>(data);
+  d_size = st.st_size;
+  d_mapped = true;
+#else  /* _WIN32 */
+  ifstream in(d_filename.c_str(), ios::in | ios::binary);
+  if (!in)
+  {
+    return;
+  }
+  stringstream ss;
+  ss << in.rdbuf();
+  d_copy = ss.str();
+  d_data = d_copy.data();
+  d_size = d_copy.size();
+#endif /* _WIN32 */
+  parse();
+}
+
+void PersistentRewriteCache::parse()
+{
+  string h = header();
+  if (d_size < h.size() || memcmp(d_data, h.data(), h.size()) != 0)
+  {
+    Notice() << "ignoring rewrite cache " << d_filename
+             << ": written by another build, or for another logic or"
+             << " other rewriter options"
+             << std::endl;
+    d_validSize = 0;
+    return;
+  }
+  Reader r(d_data + h.size(), d_data + d_size);
+  d_validSize = h.size();
+  while (!r.atEnd())
+  {
+    Entry e;
+    uint64_t inputLength, resultLength, sum;
+    if (!r.readBytes(e.d_input, inputLength)
+        || !r.readBytes(e.d_result, resultLength) || !r.readFixed64(sum)
+        || checksum(e.d_input, inputLength, e.d_result, resultLength) != sum)
+    {
+      Notice() << "rewrite cache " << d_filename << " is damaged after "
+               << d_validSize << " bytes" << std::endl;
+      break;
+    }
+    e.d_inputLength = inputLength;
+    e.d_resultLength = resultLength;
+    d_entries[fnv1a(e.d_input, inputLength, FNV_BASIS)].push_back(e);
+    d_validSize = r.position() - d_data;
+    ++d_statistics.d_loaded;
+  }
+}
+
+void PersistentRewriteCache::unmap()
+{
+#ifndef _WIN32
+  if (d_mapped)
+  {
+    munmap(const_cast<char*>(d_data), d_size);
+  }
+#endif /* _WIN32 */
+  d_copy.clear();
+  d_data = NULL;
+  d_size = 0;
+  d_mapped = false;
+  d_validSize = 0;
+}
+
+void PersistentRewriteCache::save()
+{
+  if (d_added.empty())
+  {
+    return;
+  }
+
+  // Append to a file that is ours and intact; otherwise start it over,
+  // keeping whatever entries of it were still usable.
+  bool append = d_validSize > 0 && d_validSize == d_size;
+  string out;
+  if (!append)
+  {
+    if (d_validSize > 0)
+    {
+      out.assign(d_data, d_validSize);
+    }
+    else
+    {
+      out = header();
+    }
+  }
+  for (size_t i = 0; i < d_added.size(); ++i)
+  {
+    const string& input = d_added[i].first;
+    const string& result = d_added[i].second;
+    writeString(out, input);
+    writeString(out, result);
+    writeFixed64(out,
+                 checksum(input.data(), input.size(), result.data(),
+                          result.size()));
+  }
+
+  // The mapping must go before the file is truncated under it.
+  unmap();
+  ofstream file(d_filename.c_str(),
+                ios::out | ios::binary | (append ? ios::app : ios::trunc));
+  file.write(out.data(), out.size());
+  file.close();
+  if (!file)
+  {
+    Warning() << "cannot write rewrite cache " << d_filename << std::endl;
+  }
+  else
+  {
+    d_statistics.d_saved += d_added.size();
+  }
+
+  // Pick up the file as written (including other processes' entries).
+  load();
+}
+
+const PersistentRewriteCache::Entry* PersistentRewriteCache::find(
+    uint64_t key, const std::string& input) const
+{
+  unordered_map<uint64_t, vector<Entry> >::const_iterator i =
+      d_entries.find(key);
+  if (i == d_entries.end())
+  {
+    return NULL;
+  }
+  for (const Entry& e : (*i).second)
+  {
+    if (e.d_inputLength == input.size()
+        && memcmp(e.d_input, input.data(), input.size()) == 0)
+    {
+      return &e;
+    }
+  }
+  return NULL;
+}
+
+void PersistentRewriteCache::add(uint64_t key,
+                                 const std::string& input,
+                                 const std::string& result)
+{
+  d_added.push_back(make_pair(input, result));
+  const pair<string, string>& p = d_added.back();
+  Entry e;
+  e.d_input = p.first.data();
+  e.d_inputLength = p.first.size();
+  e.d_result = p.second.data();
+  e.d_resultLength = p.second.size();
+  d_entries[key].push_back(e);
+}
+
+Node PersistentRewriteCache::rewrite(TNode node)
+{
+  vector<Node> vars;
+  string input;
+  if (!TermWriter(vars, true).write(node, input))
+  {
+    ++d_statistics.d_unsupported;
+    return Rewriter::rewrite(node);
+  }
+  uint64_t key = fnv1a(input.data(), input.size(), FNV_BASIS);
+
+  const Entry* e = find(key, input);
+  Node result;
+  if (e != NULL && readTerm(e->d_result, e->d_resultLength, vars, result))
+  {
+    ++d_statistics.d_hits;
+    Trace("rewrite-cache-file") << "hit: " << node << " --> " << result
+                                << std::endl;
+    return result;
+  }
+
+  ++d_statistics.d_misses;
+  result = Rewriter::rewrite(node);
+  string output;
+  if (e == NULL && TermWriter(vars, false).write(result, output))
+  {
+    add(key, input, output);
+  }
+  return result;
+}
+
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
@@ -0,0 +1,156 @@
+/*********************                                                        */
+/*! \file persistent_rewrite_cache.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief An on-disk cache of rewrites of top-level assertions
+ **
+ ** Keeps the rewrites of top-level assertions in a file that survives the
+ ** process, so that closely related queries solved one after another do
+ ** not rewrite the same formulas from scratch every time.
+ **
+ ** A term is written as a postorder listing of its DAG.  Free variables
+ ** are recorded by name and type, so that the same declarations in a
+ ** later run produce the same bytes; the key of an entry is a hash of
+ ** these bytes, and a hit is confirmed by comparing them in full.  The
+ ** rewritten term is written relative to the variables of the input,
+ ** so that it can be rebuilt over the variables of the current run.
+ ** Terms that contain anything else that is not stable across runs
+ ** (skolems, bound variables, constants without a textual form here)
+ ** are not cached.
+ **
+ ** The file starts with the build it was written by, a context string
+ ** (the logic) and the values of the options the rewriters read; a file
+ ** from another build, context or option setting is ignored and
+ ** replaced.  It is memory-mapped for reading, and new entries are
+ ** appended when the cache is saved.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__PERSISTENT_REWRITE_CACHE_H
+#define __CVC4__THEORY__PERSISTENT_REWRITE_CACHE_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "expr/node.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+
+class PersistentRewriteCache {
+ public:
+  /**
+   * Create a cache backed by the given file.  Entries are only used if
+   * the file was written by this build of CVC4 with the same context.
+   */
+  PersistentRewriteCache(const std::string& filename,
+                         const std::string& context);
+  ~PersistentRewriteCache();
+
+  /**
+   * Read the file, if it exists.  A missing, foreign, or damaged file
+   * is not an error: the cache simply starts out empty (or with the
+   * entries preceding the damage).
+   */
+  void load();
+
+  /**
+   * Write the entries added since load() to the file.  I/O errors are
+   * reported as warnings.
+   */
+  void save();
+
+  /**
+   * Returns the rewrite of node, from the cache if it is there, and
+   * otherwise computed with Rewriter::rewrite() and added to the cache.
+   */
+  Node rewrite(TNode node);
+
+ private:
+  /** A cached rewrite; the bytes live in the mapping or in d_added */
+  struct Entry
+  {
+    const char* d_input;
+    size_t d_inputLength;
+    const char* d_result;
+    size_t d_resultLength;
+  };
+
+  /**
+   * Looks up the entry for the given serialized input.  Returns NULL if
+   * there is none.
+   */
+  const Entry* find(uint64_t key, const std::string& input) const;
+
+  /** Adds an entry for the given serialized input and result. */
+  void add(uint64_t key, const std::string& input, const std::string& result);
+
+  /** Parses the entries of the mapped file, stopping at any damage. */
+  void parse();
+
+  /** Releases the mapped file. */
+  void unmap();
+
+  /** The expected file header for this build and context */
+  std::string header() const;
+
+  /** The name of the backing file */
+  std::string d_filename;
+  /** The context the entries must have been produced in */
+  std::string d_context;
+
+  /** The contents of the file */
+  const char* d_data;
+  size_t d_size;
+  /** Whether d_data is a mapping (rather than pointing into d_copy) */
+  bool d_mapped;
+  /** The contents of the file where it cannot be mapped */
+  std::string d_copy;
+
+  /**
+   * The length of the valid prefix of the file: 0 if the file has to be
+   * rewritten from scratch, d_size if new entries can be appended.
+   */
+  size_t d_validSize;
+
+  /** All entries, by hash of the serialized input */
+  std::unordered_map<uint64_t, std::vector<Entry> > d_entries;
+
+  /** The inputs and results of entries added in this run */
+  std::deque<std::pair<std::string, std::string> > d_added;
+
+  class Statistics
+  {
+   public:
+    IntStat d_hits;
+    IntStat d_misses;
+    IntStat d_unsupported;
+    IntStat d_loaded;
+    IntStat d_saved;
+    Statistics();
+    ~Statistics();
+  };
+
+  Statistics d_statistics;
+
+  PersistentRewriteCache(const PersistentRewriteCache&) CVC4_UNDEFINED;
+  PersistentRewriteCache& operator=(const PersistentRewriteCache&)
+      CVC4_UNDEFINED;
+};/* class PersistentRewriteCache */
+
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__PERSISTENT_REWRITE_CACHE_H */
@@ -0,0 +1,98 @@
+/*********************                                                        */
+/*! \file rewrite_cache.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A bounded, open-addressing cache of rewrite results
+ **
+ ** A bounded, open-addressing cache of rewrite results.
+ **/
+
+#include "theory/rewrite_cache.h"
+
+#include "smt/smt_statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+
+CVC4_THREAD_LOCAL uint64_t RewriteCache::s_generation = 0;
+
+RewriteCache::Statistics::Statistics()
+    : d_hits("theory::RewriteCache::hits", 0),
+      d_misses("theory::RewriteCache::misses", 0),
+      d_evictions("theory::RewriteCache::evictions", 0)
+{
+  smtStatisticsRegistry()->registerStat(&d_hits);
+  smtStatisticsRegistry()->registerStat(&d_misses);
+  smtStatisticsRegistry()->registerStat(&d_evictions);
+}
+
+RewriteCache::Statistics::~Statistics()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_hits);
+  smtStatisticsRegistry()->unregisterStat(&d_misses);
+  smtStatisticsRegistry()->unregisterStat(&d_evictions);
+}
+
+RewriteCache::RewriteCache(size_t capacity)
+    : d_mask(0), d_shift(64), d_generation(s_generation)
+{
+  size_t size = PROBE_LIMIT;
+  while (size < capacity)
+  {
+    size <<= 1;
+  }
+  d_entries.resize(size);
+  d_mask = size - 1;
+  while ((size_t(1) << (64 - d_shift)) < size)
+  {
+    --d_shift;
+  }
+  clear();
+}
+
+RewriteCache::~RewriteCache() {}
+
+void RewriteCache::clear()
+{
+  for (Entry& e : d_entries)
+  {
+    e.d_key = 0;
+    e.d_value = TNode::null();
+  }
+  d_generation = s_generation;
+}
+
+void RewriteCache::insert(uint64_t key, TNode value)
+{
+  if (d_generation != s_generation)
+  {
+    clear();
+  }
+  size_t h = home(key);
+  for (unsigned i = 0; i < PROBE_LIMIT; ++i)
+  {
+    Entry& e = d_entries[(h + i) & d_mask];
+    if (e.d_key == key || e.d_key == 0)
+    {
+      e.d_key = key;
+      e.d_value = value;
+      return;
+    }
+  }
+  // The probe window is full: overwrite the home slot.  Slots are never
+  // emptied, so this cannot break the probe sequence of another key.
+  ++d_statistics.d_evictions;
+  Entry& e = d_entries[h & d_mask];
+  e.d_key = key;
+  e.d_value = value;
+}
+
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
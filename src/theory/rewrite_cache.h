@@ -0,0 +1,175 @@
+/*********************                                                        */
+/*! \file rewrite_cache.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A bounded, open-addressing cache of rewrite results
+ **
+ ** The Rewriter keeps its pre- and post-rewrite caches in attribute
+ ** tables, which are general-purpose hash maps keyed by (NodeValue*,
+ ** attribute id).  This class is a small direct table in front of them:
+ ** it maps (node id, theory, pre/post) to the rewritten node with a
+ ** short linear probe, and simply overwrites an entry when the probe
+ ** window is full.  The attribute tables remain the complete record, so
+ ** an evicted entry only costs a lookup there.
+ **
+ ** Entries hold TNodes and never keep a node alive: every value is also
+ ** stored in the attribute of its key, which owns it for as long as the
+ ** key lives, and keys are node ids, which are never reused, so the entry
+ ** of a reclaimed key can never be hit again.  When the attribute tables
+ ** are cleared (Rewriter::clearCaches()), every cache on the thread is
+ ** invalidated with them through clearAll().
+ **
+ ** Each SmtEngine owns one of these; its size is set with
+ ** --rewrite-cache-size.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__REWRITE_CACHE_H
+#define __CVC4__THEORY__REWRITE_CACHE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "expr/kind.h"
+#include "base/tls.h"
+#include "expr/node.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+
+class RewriteCache {
+ public:
+  /**
+   * Create a cache with at least the given number of entries (rounded
+   * up to a power of two).
+   */
+  RewriteCache(size_t capacity);
+  ~RewriteCache();
+
+  /** The cached pre-rewrite of node under theoryId, or null. */
+  TNode getPreRewrite(TheoryId theoryId, TNode node)
+  {
+    return lookup(key(theoryId, node, true));
+  }
+
+  /** The cached post-rewrite of node under theoryId, or null. */
+  TNode getPostRewrite(TheoryId theoryId, TNode node)
+  {
+    return lookup(key(theoryId, node, false));
+  }
+
+  /**
+   * Record that node pre-rewrites to result under theoryId.  The cache
+   * does not own result: it must stay alive as long as node does, as it
+   * does when it is also stored in node's rewrite attribute.
+   */
+  void setPreRewrite(TheoryId theoryId, TNode node, TNode result)
+  {
+    insert(key(theoryId, node, true), result);
+  }
+
+  /**
+   * Record that node post-rewrites to result under theoryId, under the
+   * same condition as setPreRewrite().
+   */
+  void setPostRewrite(TheoryId theoryId, TNode node, TNode result)
+  {
+    insert(key(theoryId, node, false), result);
+  }
+
+  /** Drop all entries. */
+  void clear();
+
+  /**
+   * Drop the entries of every cache of this thread before their next use,
+   * for when the attributes that own their values are deleted.
+   */
+  static void clearAll() { ++s_generation; }
+
+ private:
+  /** The number of slots inspected by a lookup or insertion. */
+  static const unsigned PROBE_LIMIT = 4;
+
+  struct Entry
+  {
+    /** The key, or 0 for an empty slot */
+    uint64_t d_key;
+    /** The rewritten node, owned by the attribute tables */
+    TNode d_value;
+  };
+
+  /**
+   * Node ids are never 0 for non-null nodes and are never reused by a
+   * NodeManager, so a key made from a dead node can never be hit again.
+   */
+  static uint64_t key(TheoryId theoryId, TNode node, bool pre)
+  {
+    static_assert(THEORY_LAST <= 32, "theory ids must fit in five bits");
+    return (node.getId() << 6) | (uint64_t(theoryId) << 1) | (pre ? 1 : 0);
+  }
+
+  size_t home(uint64_t key) const
+  {
+    return size_t((key * 0x9e3779b97f4a7c15ull) >> d_shift);
+  }
+
+  TNode lookup(uint64_t key)
+  {
+    if (d_generation != s_generation)
+    {
+      clear();
+    }
+    size_t h = home(key);
+    for (unsigned i = 0; i < PROBE_LIMIT; ++i)
+    {
+      const Entry& e = d_entries[(h + i) & d_mask];
+      if (e.d_key == key)
+      {
+        ++d_statistics.d_hits;
+        return e.d_value;
+      }
+      if (e.d_key == 0)
+      {
+        break;
+      }
+    }
+    ++d_statistics.d_misses;
+    return TNode::null();
+  }
+
+  void insert(uint64_t key, TNode value);
+
+  class Statistics
+  {
+   public:
+    IntStat d_hits;
+    IntStat d_misses;
+    IntStat d_evictions;
+    Statistics();
+    ~Statistics();
+  };
+
+  /** Incremented by clearAll() */
+  static CVC4_THREAD_LOCAL uint64_t s_generation;
+
+  std::vector<Entry> d_entries;
+  size_t d_mask;
+  unsigned d_shift;
+  /** The value of s_generation when this cache was last cleared */
+  uint64_t d_generation;
+  Statistics d_statistics;
+};/* class RewriteCache */
+
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__REWRITE_CACHE_H */
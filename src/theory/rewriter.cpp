@@ -20,6 +20,7 @@
 #include "theory/theory.h"
 #include "smt/smt_engine_scope.h"
 #include "smt/smt_statistics_registry.h"
+#include "theory/rewrite_cache.h"
 #include "theory/rewriter_tables.h"
 #include "util/resource_manager.h"
 
@@ -88,6 +89,70 @@ Node Rewriter::rewrite(TNode node) {
   return rewriteTo(theoryOf(node), node);
 }
 
+Node Rewriter::lookupPreRewrite(RewriteCache* rc,
+                                theory::TheoryId theoryId,
+                                TNode node)
+{
+  if (rc != NULL)
+  {
+    TNode cached = rc->getPreRewrite(theoryId, node);
+    if (!cached.isNull())
+    {
+      return cached;
+    }
+  }
+  Node cached = getPreRewriteCache(theoryId, node);
+  if (rc != NULL && !cached.isNull())
+  {
+    rc->setPreRewrite(theoryId, node, cached);
+  }
+  return cached;
+}
+
+Node Rewriter::lookupPostRewrite(RewriteCache* rc,
+                                 theory::TheoryId theoryId,
+                                 TNode node)
+{
+  if (rc != NULL)
+  {
+    TNode cached = rc->getPostRewrite(theoryId, node);
+    if (!cached.isNull())
+    {
+      return cached;
+    }
+  }
+  Node cached = getPostRewriteCache(theoryId, node);
+  if (rc != NULL && !cached.isNull())
+  {
+    rc->setPostRewrite(theoryId, node, cached);
+  }
+  return cached;
+}
+
+void Rewriter::storePreRewrite(RewriteCache* rc,
+                               theory::TheoryId theoryId,
+                               TNode node,
+                               TNode cache)
+{
+  setPreRewriteCache(theoryId, node, cache);
+  if (rc != NULL)
+  {
+    rc->setPreRewrite(theoryId, node, cache);
+  }
+}
+
+void Rewriter::storePostRewrite(RewriteCache* rc,
+                                theory::TheoryId theoryId,
+                                TNode node,
+                                TNode cache)
+{
+  setPostRewriteCache(theoryId, node, cache);
+  if (rc != NULL)
+  {
+    rc->setPostRewrite(theoryId, node, cache);
+  }
+}
+
 Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
 
 #ifdef CVC4_ASSERTIONS
@@ -100,8 +165,16 @@ Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
 
   Trace("rewriter") << "Rewriter::rewriteTo(" << theoryId << "," << node << ")"<< std::endl;
 
+  ResourceManager* rm = NULL;
+  RewriteCache* rc = NULL;
+  bool hasSmtEngine = smt::smtEngineInScope();
+  if (hasSmtEngine) {
+    rm = NodeManager::currentResourceManager();
+    rc = smt::currentRewriteCache();
+  }
+
   // Check if it's been cached already
-  Node cached = getPostRewriteCache(theoryId, node);
+  Node cached = lookupPostRewrite(rc, theoryId, node);
   if (!cached.isNull()) {
     return cached;
   }
@@ -110,11 +183,6 @@ Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
   vector<RewriteStackElement> rewriteStack;
   rewriteStack.push_back(RewriteStackElement(node, theoryId));
 
-  ResourceManager* rm = NULL;
-  bool hasSmtEngine = smt::smtEngineInScope();
-  if (hasSmtEngine) {
-    rm = NodeManager::currentResourceManager();
-  }
   // Rewrite until the stack is empty
   for (;;){
 
@@ -133,7 +201,7 @@ Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
     if (rewriteStackTop.nextChild == 0) {
 
       // Check if the pre-rewrite has already been done (it's in the cache)
-      Node cached = Rewriter::getPreRewriteCache((TheoryId) rewriteStackTop.theoryId, rewriteStackTop.node);
+      Node cached = lookupPreRewrite(rc, (TheoryId) rewriteStackTop.theoryId, rewriteStackTop.node);
       if (cached.isNull()) {
         // Rewrite until fix-point is reached
         for(;;) {
@@ -149,7 +217,7 @@ Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
           rewriteStackTop.theoryId = newTheory;
         }
         // Cache the rewrite
-        Rewriter::setPreRewriteCache((TheoryId) rewriteStackTop.originalTheoryId, rewriteStackTop.original, rewriteStackTop.node);
+        storePreRewrite(rc, (TheoryId) rewriteStackTop.originalTheoryId, rewriteStackTop.original, rewriteStackTop.node);
       }
       // Otherwise we're have already been pre-rewritten (in pre-rewrite cache)
       else {
@@ -161,7 +229,7 @@ Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
 
     rewriteStackTop.original =rewriteStackTop.node;
     // Now it's time to rewrite the children, check if this has already been done
-    Node cached = Rewriter::getPostRewriteCache((TheoryId) rewriteStackTop.theoryId, rewriteStackTop.node);
+    Node cached = lookupPostRewrite(rc, (TheoryId) rewriteStackTop.theoryId, rewriteStackTop.node);
     // If not, go through the children
     if(cached.isNull()) {
 
@@ -231,7 +299,7 @@ Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
 	rewriteStackTop.node = response.node;
       }
       // We're done with the post rewrite, so we add to the cache
-      Rewriter::setPostRewriteCache((TheoryId) rewriteStackTop.originalTheoryId, rewriteStackTop.original, rewriteStackTop.node);
+      storePostRewrite(rc, (TheoryId) rewriteStackTop.originalTheoryId, rewriteStackTop.original, rewriteStackTop.node);
 
     } else {
       // We were already in cache, so just remember it
@@ -260,6 +328,9 @@ void Rewriter::clearCaches() {
     s_rewriteStack = NULL;
   }
 #endif
+  // The attribute tables own the values of every RewriteCache, including
+  // those of other SmtEngines sharing this NodeManager
+  RewriteCache::clearAll();
   Rewriter::clearCachesInternal();
 }
 
@@ -49,6 +49,7 @@ struct RewriteResponse {
 };/* struct RewriteResponse */
 
 class RewriterInitializer;
+class RewriteCache;
 
 /**
  * The main rewriter class.  All functionality is static.
@@ -71,6 +72,32 @@ class Rewriter {
   static void setPostRewriteCache(theory::TheoryId theoryId,
                                   TNode node, TNode cache);
 
+  /**
+   * Returns the cached pre-rewrite of a node, looking first in the
+   * given RewriteCache (which may be null) and then in the attribute
+   * tables.  Hits in the latter are copied into the former.
+   */
+  static Node lookupPreRewrite(RewriteCache* rc,
+                               theory::TheoryId theoryId,
+                               TNode node);
+
+  /** Like lookupPreRewrite(), for post-rewrites */
+  static Node lookupPostRewrite(RewriteCache* rc,
+                                theory::TheoryId theoryId,
+                                TNode node);
+
+  /** Caches a pre-rewrite in the attribute tables and in rc (if non-null) */
+  static void storePreRewrite(RewriteCache* rc,
+                              theory::TheoryId theoryId,
+                              TNode node,
+                              TNode cache);
+
+  /** Caches a post-rewrite in the attribute tables and in rc (if non-null) */
+  static void storePostRewrite(RewriteCache* rc,
+                               theory::TheoryId theoryId,
+                               TNode node,
+                               TNode cache);
+
   // disable construction of rewriters; all functionality is static
   Rewriter() CVC4_UNDEFINED;
   Rewriter(const Rewriter&) CVC4_UNDEFINED;
@@ -35,56 +35,81 @@ using namespace std;
 namespace CVC4 {
 
 Integer::Integer(const char* s, unsigned base)
-  : d_value(s, base)
-{}
+  : d_small(0), d_big(NULL)
+{
+  mpz_class value(s, base);
+  setValue(value.get_mpz_t());
+}
 
 Integer::Integer(const std::string& s, unsigned base)
-  : d_value(s, base)
-{}
+  : d_small(0), d_big(NULL)
+{
+  mpz_class value(s, base);
+  setValue(value.get_mpz_t());
+}
 
+std::string Integer::toString(int base) const {
+  if(d_big == NULL && base == 10){
+    return std::to_string(static_cast<long long>(d_small));
+  }
+  mpz_class tmp;
+  return asMpz(tmp).get_str(base);
+}
 
 bool Integer::fitsSignedInt() const {
-  return d_value.fits_sint_p();
+  return d_big == NULL && d_small >= std::numeric_limits<int>::min()
+         && d_small <= std::numeric_limits<int>::max();
 }
 
 bool Integer::fitsUnsignedInt() const {
-  return d_value.fits_uint_p();
+  return d_big == NULL && d_small >= 0
+         && static_cast<uint64_t>(d_small)
+                <= std::numeric_limits<unsigned int>::max();
 }
 
 signed int Integer::getSignedInt() const {
   // ensure there isn't overflow
-  CheckArgument(d_value <= std::numeric_limits<int>::max(), this,
+  CheckArgument(*this <= std::numeric_limits<int>::max(), this,
                 "Overflow detected in Integer::getSignedInt().");
-  CheckArgument(d_value >= std::numeric_limits<int>::min(), this,
+  CheckArgument(*this >= std::numeric_limits<int>::min(), this,
                 "Overflow detected in Integer::getSignedInt().");
   CheckArgument(fitsSignedInt(), this,
                 "Overflow detected in Integer::getSignedInt().");
-  return (signed int) d_value.get_si();
+  return (signed int) d_small;
 }
 
 unsigned int Integer::getUnsignedInt() const {
   // ensure there isn't overflow
-  CheckArgument(d_value <= std::numeric_limits<unsigned int>::max(), this,
+  CheckArgument(*this <= std::numeric_limits<unsigned int>::max(), this,
                 "Overflow detected in Integer::getUnsignedInt()");
-  CheckArgument(d_value >= std::numeric_limits<unsigned int>::min(), this,
+  CheckArgument(*this >= std::numeric_limits<unsigned int>::min(), this,
                 "Overflow detected in Integer::getUnsignedInt()");
   CheckArgument(fitsSignedInt(), this,
                 "Overflow detected in Integer::getUnsignedInt()");
-  return (unsigned int) d_value.get_ui();
+  return (unsigned int) d_small;
 }
 
 bool Integer::fitsSignedLong() const {
-  return d_value.fits_slong_p();
+  if(d_big == NULL){
+    return d_small >= std::numeric_limits<long>::min()
+           && d_small <= std::numeric_limits<long>::max();
+  }
+  return d_big->fits_slong_p();
 }
 
 bool Integer::fitsUnsignedLong() const {
-  return d_value.fits_ulong_p();
+  if(d_big == NULL){
+    return d_small >= 0
+           && static_cast<uint64_t>(d_small)
+                  <= std::numeric_limits<unsigned long>::max();
+  }
+  return d_big->fits_ulong_p();
 }
 
 Integer Integer::oneExtend(uint32_t size, uint32_t amount) const {
   // check that the size is accurate
   DebugCheckArgument((*this) < Integer(1).multiplyByPow2(size), size);
-  mpz_class res = d_value;
+  mpz_class res = getValue();
 
   for (unsigned i = size; i < size + amount; ++i) {
     mpz_setbit(res.get_mpz_t(), i);
@@ -95,32 +120,35 @@ Integer Integer::oneExtend(uint32_t size, uint32_t amount) const {
 
 Integer Integer::exactQuotient(const Integer& y) const {
   DebugCheckArgument(y.divides(*this), y);
-  mpz_class q;
-  mpz_divexact(q.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+  if(bothSmall(y) && y.d_small != 0){
+    return fromInt64(d_small / y.d_small);
+  }
+  mpz_class t1, t2, q;
+  mpz_divexact(q.get_mpz_t(), asMpz(t1).get_mpz_t(), y.asMpz(t2).get_mpz_t());
   return Integer( q );
 }
 
 Integer Integer::modAdd(const Integer& y, const Integer& m) const
 {
-  mpz_class res;
-  mpz_add(res.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
-  mpz_mod(res.get_mpz_t(), res.get_mpz_t(), m.d_value.get_mpz_t());
+  mpz_class t1, t2, t3, res;
+  mpz_add(res.get_mpz_t(), asMpz(t1).get_mpz_t(), y.asMpz(t2).get_mpz_t());
+  mpz_mod(res.get_mpz_t(), res.get_mpz_t(), m.asMpz(t3).get_mpz_t());
   return Integer(res);
 }
 
 Integer Integer::modMultiply(const Integer& y, const Integer& m) const
 {
-  mpz_class res;
-  mpz_mul(res.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
-  mpz_mod(res.get_mpz_t(), res.get_mpz_t(), m.d_value.get_mpz_t());
+  mpz_class t1, t2, t3, res;
+  mpz_mul(res.get_mpz_t(), asMpz(t1).get_mpz_t(), y.asMpz(t2).get_mpz_t());
+  mpz_mod(res.get_mpz_t(), res.get_mpz_t(), m.asMpz(t3).get_mpz_t());
   return Integer(res);
 }
 
 Integer Integer::modInverse(const Integer& m) const
 {
   PrettyCheckArgument(m > 0, m, "m must be greater than zero");
-  mpz_class res;
-  if (mpz_invert(res.get_mpz_t(), d_value.get_mpz_t(), m.d_value.get_mpz_t())
+  mpz_class t1, t2, res;
+  if (mpz_invert(res.get_mpz_t(), asMpz(t1).get_mpz_t(), m.asMpz(t2).get_mpz_t())
       == 0)
   {
     return Integer(-1);
@@ -20,6 +20,7 @@
 #ifndef __CVC4__INTEGER_H
 #define __CVC4__INTEGER_H
 
+#include <stdint.h>
 #include <string>
 #include <iosfwd>
 #include <limits>
@@ -34,26 +35,167 @@ class Rational;
 class CVC4_PUBLIC Integer {
 private:
   /**
-   * Stores the value of the rational is stored in a C++ GMP integer class.
-   * Using this instead of mpz_t allows for easier destruction.
+   * The value.  A value v with INT64_MIN < v <= INT64_MAX is kept inline in
+   * d_small, with d_big NULL, so that arithmetic on the common small
+   * integers needs neither GMP nor the heap; any other value is kept in the
+   * GMP integer d_big points to.  The representation is canonical: every
+   * operation moves a result that fits back inline.
    */
-  mpz_class d_value;
+  int64_t d_small;
+  mpz_class* d_big;
+
+  /** Whether v can be kept inline (INT64_MIN cannot: -v must not overflow). */
+  static bool fitsSmall(int64_t v) {
+    return v != std::numeric_limits<int64_t>::min();
+  }
+  static bool fitsSmall(mpz_srcptr z) {
+    return mpz_sizeinbase(z, 2) <= 63;
+  }
+
+  /** Returns |v| (for INT64_MIN too). */
+  static uint64_t magnitude(int64_t v) {
+    return v < 0 ? uint64_t(0) - static_cast<uint64_t>(v)
+                 : static_cast<uint64_t>(v);
+  }
+
+  /** gmpz_hash() of the GMP integer with value v */
+  static size_t hashSmall(int64_t v) {
+    uint64_t m = magnitude(v);
+    if(sizeof(mp_limb_t) >= sizeof(uint64_t)){
+      return static_cast<size_t>(m);
+    }
+    size_t lo = static_cast<size_t>(m & 0xffffffffu);
+    size_t hi = static_cast<size_t>(m >> 32);
+    return hi == 0 ? lo : ((lo * 2) ^ hi);
+  }
+
+  /** length() of the integer with value v */
+  static size_t lengthSmall(int64_t v) {
+    size_t n = 1;
+    for(uint64_t m = magnitude(v) >> 1; m != 0; m >>= 1) ++n;
+    return n;
+  }
+
+  static uint64_t gcdSmall(uint64_t a, uint64_t b) {
+    while(b != 0){
+      uint64_t r = a % b;
+      a = b;
+      b = r;
+    }
+    return a;
+  }
+
+  static void setMpz(mpz_ptr z, int64_t v) {
+    if(sizeof(long) >= sizeof(int64_t)){
+      mpz_set_si(z, static_cast<long>(v));
+    }else{
+      uint64_t m = magnitude(v);
+      mpz_import(z, 1, -1, sizeof(m), 0, 0, &m);
+      if(v < 0){ mpz_neg(z, z); }
+    }
+  }
+
+  /** The value of z, which must fit inline. */
+  static int64_t getInt64(mpz_srcptr z) {
+    if(sizeof(long) >= sizeof(int64_t)){
+      return mpz_get_si(z);
+    }else{
+      uint64_t m = 0;
+      mpz_export(&m, NULL, -1, sizeof(m), 0, 0, z);
+      return mpz_sgn(z) < 0 ? -static_cast<int64_t>(m) : static_cast<int64_t>(m);
+    }
+  }
+
+  void setValue(int64_t v) {
+    if(fitsSmall(v)){
+      d_small = v;
+      delete d_big;
+      d_big = NULL;
+    }else{
+      if(d_big == NULL){ d_big = new mpz_class(); }
+      setMpz(d_big->get_mpz_t(), v);
+    }
+  }
+
+  void setValue(mpz_srcptr z) {
+    if(fitsSmall(z)){
+      d_small = getInt64(z);
+      delete d_big;
+      d_big = NULL;
+    }else if(d_big != NULL){
+      mpz_set(d_big->get_mpz_t(), z);
+    }else{
+      d_big = new mpz_class(z);
+    }
+  }
 
   /**
-   * Gets a reference to the gmp data that backs up the integer.
-   * Only accessible to friend classes.
+   * Returns a GMP integer with the value: the one backing the integer if
+   * it is large, otherwise tmp, set to the value.
    */
-  const mpz_class& get_mpz() const { return d_value; }
+  const mpz_class& asMpz(mpz_class& tmp) const {
+    if(d_big != NULL){ return *d_big; }
+    setMpz(tmp.get_mpz_t(), d_small);
+    return tmp;
+  }
+
+  /** Returns -1, 0 or 1 as this is less than, equal to or greater than y. */
+  int compare(const Integer& y) const {
+    if(d_big == NULL){
+      if(y.d_big == NULL){
+        return d_small < y.d_small ? -1 : (d_small > y.d_small ? 1 : 0);
+      }
+      // y is outside of the inline range, on the side of its sign
+      return -mpz_sgn(y.d_big->get_mpz_t());
+    }else if(y.d_big == NULL){
+      return mpz_sgn(d_big->get_mpz_t());
+    }
+    int c = mpz_cmp(d_big->get_mpz_t(), y.d_big->get_mpz_t());
+    return c < 0 ? -1 : (c > 0 ? 1 : 0);
+  }
+
+  /** Whether both integers are kept inline */
+  bool bothSmall(const Integer& y) const {
+    return d_big == NULL && y.d_big == NULL;
+  }
+
+  static Integer fromInt64(int64_t v) {
+    Integer res;
+    res.setValue(v);
+    return res;
+  }
 
   /**
    * Constructs an Integer by copying a GMP C++ primitive.
    */
-  Integer(const mpz_class& val) : d_value(val) {}
+  Integer(const mpz_class& val) : d_small(0), d_big(NULL) {
+    setValue(val.get_mpz_t());
+  }
+
+  /** Computes a ceiling quotient and remainder for x divided by y. */
+  static void ceilingQR(Integer& q, Integer& r, const Integer& x, const Integer& y) {
+    if(x.bothSmall(y) && y.d_small != 0){
+      int64_t qs = x.d_small / y.d_small;
+      int64_t rs = x.d_small % y.d_small;
+      if(rs != 0 && ((rs > 0) == (y.d_small > 0))){
+        ++qs;
+        rs -= y.d_small;
+      }
+      q.setValue(qs);
+      r.setValue(rs);
+      return;
+    }
+    mpz_class t1, t2, qz, rz;
+    mpz_cdiv_qr(qz.get_mpz_t(), rz.get_mpz_t(),
+                x.asMpz(t1).get_mpz_t(), y.asMpz(t2).get_mpz_t());
+    q.setValue(qz.get_mpz_t());
+    r.setValue(rz.get_mpz_t());
+  }
 
 public:
 
   /** Constructs a rational with the value 0. */
-  Integer() : d_value(0){}
+  Integer() : d_small(0), d_big(NULL) {}
 
   /**
    * Constructs a Integer from a C string.
@@ -64,110 +206,206 @@ public:
   explicit Integer(const char* s, unsigned base = 10);
   explicit Integer(const std::string& s, unsigned base = 10);
 
-  Integer(const Integer& q) : d_value(q.d_value) {}
+  Integer(const Integer& q)
+    : d_small(q.d_small),
+      d_big(q.d_big == NULL ? NULL : new mpz_class(*q.d_big))
+  {}
+
+  Integer(Integer&& q) : d_small(q.d_small), d_big(q.d_big) {
+    q.d_small = 0;
+    q.d_big = NULL;
+  }
 
-  Integer(  signed int z) : d_value(z) {}
-  Integer(unsigned int z) : d_value(z) {}
-  Integer(  signed long int z) : d_value(z) {}
-  Integer(unsigned long int z) : d_value(z) {}
+  Integer(  signed int z) : d_small(z), d_big(NULL) {}
+  Integer(unsigned int z) : d_small(z), d_big(NULL) {}
+  Integer(  signed long int z) : d_small(0), d_big(NULL) {
+    setValue(static_cast<int64_t>(z));
+  }
+  Integer(unsigned long int z) : d_small(0), d_big(NULL) {
+    if(static_cast<uint64_t>(z) <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())){
+      d_small = static_cast<int64_t>(z);
+    }else{
+      d_big = new mpz_class(z);
+    }
+  }
 
 #ifdef CVC4_NEED_INT64_T_OVERLOADS
-  Integer( int64_t z) : d_value(static_cast<long>(z)) {}
-  Integer(uint64_t z) : d_value(static_cast<unsigned long>(z)) {}
+  Integer( int64_t z) : d_small(0), d_big(NULL) { setValue(z); }
+  Integer(uint64_t z) : d_small(0), d_big(NULL) {
+    if(z <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())){
+      d_small = static_cast<int64_t>(z);
+    }else{
+      d_big = new mpz_class();
+      mpz_import(d_big->get_mpz_t(), 1, -1, sizeof(z), 0, 0, &z);
+    }
+  }
 #endif /* CVC4_NEED_INT64_T_OVERLOADS */
 
-  ~Integer() {}
+  ~Integer() { delete d_big; }
 
   /**
-   * Returns a copy of d_value to enable public access of GMP data.
+   * Returns a copy of the value as a GMP integer.
    */
   mpz_class getValue() const
   {
-    return d_value;
+    mpz_class tmp;
+    return asMpz(tmp);
   }
 
   Integer& operator=(const Integer& x){
     if(this == &x) return *this;
-    d_value = x.d_value;
+    if(x.d_big == NULL){
+      delete d_big;
+      d_big = NULL;
+      d_small = x.d_small;
+    }else if(d_big != NULL){
+      *d_big = *x.d_big;
+    }else{
+      d_big = new mpz_class(*x.d_big);
+    }
+    return *this;
+  }
+
+  Integer& operator=(Integer&& x){
+    if(this == &x) return *this;
+    delete d_big;
+    d_small = x.d_small;
+    d_big = x.d_big;
+    x.d_small = 0;
+    x.d_big = NULL;
     return *this;
   }
 
   bool operator==(const Integer& y) const {
-    return d_value == y.d_value;
+    if(d_big == NULL){
+      return y.d_big == NULL && d_small == y.d_small;
+    }
+    return y.d_big != NULL && *d_big == *y.d_big;
   }
 
   Integer operator-() const {
-    return Integer(-(d_value));
+    if(d_big == NULL){
+      return fromInt64(-d_small);
+    }
+    return Integer(mpz_class(-(*d_big)));
   }
 
 
   bool operator!=(const Integer& y) const {
-    return d_value != y.d_value;
+    return !(*this == y);
   }
 
   bool operator< (const Integer& y) const {
-    return d_value < y.d_value;
+    return compare(y) < 0;
   }
 
   bool operator<=(const Integer& y) const {
-    return d_value <= y.d_value;
+    return compare(y) <= 0;
   }
 
   bool operator> (const Integer& y) const {
-    return d_value > y.d_value;
+    return compare(y) > 0;
   }
 
   bool operator>=(const Integer& y) const {
-    return d_value >= y.d_value;
+    return compare(y) >= 0;
   }
 
 
   Integer operator+(const Integer& y) const {
-    return Integer( d_value + y.d_value );
+    int64_t res;
+    if(bothSmall(y) && !__builtin_add_overflow(d_small, y.d_small, &res)){
+      return fromInt64(res);
+    }
+    mpz_class t1, t2;
+    return Integer( asMpz(t1) + y.asMpz(t2) );
   }
   Integer& operator+=(const Integer& y) {
-    d_value += y.d_value;
+    int64_t res;
+    if(bothSmall(y) && !__builtin_add_overflow(d_small, y.d_small, &res)){
+      setValue(res);
+    }else{
+      mpz_class t1, t2;
+      mpz_class sum = asMpz(t1) + y.asMpz(t2);
+      setValue(sum.get_mpz_t());
+    }
     return *this;
   }
 
   Integer operator-(const Integer& y) const {
-    return Integer( d_value - y.d_value );
+    int64_t res;
+    if(bothSmall(y) && !__builtin_sub_overflow(d_small, y.d_small, &res)){
+      return fromInt64(res);
+    }
+    mpz_class t1, t2;
+    return Integer( asMpz(t1) - y.asMpz(t2) );
   }
   Integer& operator-=(const Integer& y) {
-    d_value -= y.d_value;
+    int64_t res;
+    if(bothSmall(y) && !__builtin_sub_overflow(d_small, y.d_small, &res)){
+      setValue(res);
+    }else{
+      mpz_class t1, t2;
+      mpz_class diff = asMpz(t1) - y.asMpz(t2);
+      setValue(diff.get_mpz_t());
+    }
     return *this;
   }
 
   Integer operator*(const Integer& y) const {
-    return Integer( d_value * y.d_value );
+    int64_t res;
+    if(bothSmall(y) && !__builtin_mul_overflow(d_small, y.d_small, &res)){
+      return fromInt64(res);
+    }
+    mpz_class t1, t2;
+    return Integer( asMpz(t1) * y.asMpz(t2) );
   }
   Integer& operator*=(const Integer& y) {
-    d_value *= y.d_value;
+    int64_t res;
+    if(bothSmall(y) && !__builtin_mul_overflow(d_small, y.d_small, &res)){
+      setValue(res);
+    }else{
+      mpz_class t1, t2;
+      mpz_class prod = asMpz(t1) * y.asMpz(t2);
+      setValue(prod.get_mpz_t());
+    }
     return *this;
   }
 
 
   Integer bitwiseOr(const Integer& y) const {
-    mpz_class result;
-    mpz_ior(result.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    if(bothSmall(y)){
+      return fromInt64(d_small | y.d_small);
+    }
+    mpz_class t1, t2, result;
+    mpz_ior(result.get_mpz_t(), asMpz(t1).get_mpz_t(), y.asMpz(t2).get_mpz_t());
     return Integer(result);
   }
 
   Integer bitwiseAnd(const Integer& y) const {
-    mpz_class result;
-    mpz_and(result.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    if(bothSmall(y)){
+      return fromInt64(d_small & y.d_small);
+    }
+    mpz_class t1, t2, result;
+    mpz_and(result.get_mpz_t(), asMpz(t1).get_mpz_t(), y.asMpz(t2).get_mpz_t());
     return Integer(result);
   }
 
   Integer bitwiseXor(const Integer& y) const {
-    mpz_class result;
-    mpz_xor(result.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    if(bothSmall(y)){
+      return fromInt64(d_small ^ y.d_small);
+    }
+    mpz_class t1, t2, result;
+    mpz_xor(result.get_mpz_t(), asMpz(t1).get_mpz_t(), y.asMpz(t2).get_mpz_t());
     return Integer(result);
   }
 
   Integer bitwiseNot() const {
+    if(d_big == NULL){
+      return fromInt64(~d_small);
+    }
     mpz_class result;
-    mpz_com(result.get_mpz_t(), d_value.get_mpz_t());
+    mpz_com(result.get_mpz_t(), d_big->get_mpz_t());
     return Integer(result);
   }
 
@@ -175,8 +413,12 @@ public:
    * Return this*(2^pow).
    */
   Integer multiplyByPow2(uint32_t pow) const{
-    mpz_class result;
-    mpz_mul_2exp(result.get_mpz_t(), d_value.get_mpz_t(), pow);
+    if(d_big == NULL && pow < 63 &&
+       magnitude(d_small) <= (uint64_t(std::numeric_limits<int64_t>::max()) >> pow)){
+      return fromInt64(d_small * (int64_t(1) << pow));
+    }
+    mpz_class tmp, result;
+    mpz_mul_2exp(result.get_mpz_t(), asMpz(tmp).get_mpz_t(), pow);
     return Integer( result );
   }
 
@@ -185,7 +427,11 @@ public:
    * current Integer to 1.
    */
   Integer setBit(uint32_t i) const {
-    mpz_class res = d_value;
+    if(d_big == NULL && i < 62){
+      return fromInt64(d_small | (int64_t(1) << i));
+    }
+    mpz_class tmp;
+    mpz_class res = asMpz(tmp);
     mpz_setbit(res.get_mpz_t(), i);
     return Integer(res);
   }
@@ -201,7 +447,10 @@ public:
   Integer oneExtend(uint32_t size, uint32_t amount) const;
 
   uint32_t toUnsignedInt() const {
-    return  mpz_get_ui(d_value.get_mpz_t());
+    if(d_big == NULL){
+      return static_cast<uint32_t>(magnitude(d_small));
+    }
+    return  mpz_get_ui(d_big->get_mpz_t());
   }
 
   /** See GMP Documentation. */
@@ -209,54 +458,65 @@ public:
     // bitCount = high-low+1
     uint32_t high = low + bitCount-1;
     //— Function: void mpz_fdiv_r_2exp (mpz_t r, mpz_t n, mp_bitcnt_t b)
-    mpz_class rem, div;
-    mpz_fdiv_r_2exp(rem.get_mpz_t(), d_value.get_mpz_t(), high+1);
-    mpz_fdiv_q_2exp(div.get_mpz_t(), rem.get_mpz_t(), low);
-
-    return Integer(div);
+    return modByPow2(high+1).divByPow2(low);
   }
 
   /**
    * Returns the floor(this / y)
    */
   Integer floorDivideQuotient(const Integer& y) const {
-    mpz_class q;
-    mpz_fdiv_q(q.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
-    return Integer( q );
+    Integer q, r;
+    floorQR(q, r, *this, y);
+    return q;
   }
 
   /**
    * Returns r == this - floor(this/y)*y
    */
   Integer floorDivideRemainder(const Integer& y) const {
-    mpz_class r;
-    mpz_fdiv_r(r.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
-    return Integer( r );
+    Integer q, r;
+    floorQR(q, r, *this, y);
+    return r;
   }
 
   /**
    * Computes a floor quotient and remainder for x divided by y.
    */
   static void floorQR(Integer& q, Integer& r, const Integer& x, const Integer& y) {
-    mpz_fdiv_qr(q.d_value.get_mpz_t(), r.d_value.get_mpz_t(), x.d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    if(x.bothSmall(y) && y.d_small != 0){
+      int64_t qs = x.d_small / y.d_small;
+      int64_t rs = x.d_small % y.d_small;
+      if(rs != 0 && ((rs < 0) != (y.d_small < 0))){
+        --qs;
+        rs += y.d_small;
+      }
+      q.setValue(qs);
+      r.setValue(rs);
+      return;
+    }
+    mpz_class t1, t2, qz, rz;
+    mpz_fdiv_qr(qz.get_mpz_t(), rz.get_mpz_t(),
+                x.asMpz(t1).get_mpz_t(), y.asMpz(t2).get_mpz_t());
+    q.setValue(qz.get_mpz_t());
+    r.setValue(rz.get_mpz_t());
   }
 
   /**
    * Returns the ceil(this / y)
    */
   Integer ceilingDivideQuotient(const Integer& y) const {
-    mpz_class q;
-    mpz_cdiv_q(q.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
-    return Integer( q );
+    Integer q, r;
+    ceilingQR(q, r, *this, y);
+    return q;
   }
 
   /**
    * Returns the ceil(this / y)
    */
   Integer ceilingDivideRemainder(const Integer& y) const {
-    mpz_class r;
-    mpz_cdiv_r(r.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
-    return Integer( r );
+    Integer q, r;
+    ceilingQR(q, r, *this, y);
+    return r;
   }
 
   /**
@@ -324,8 +584,16 @@ public:
    * Returns y mod 2^exp
    */
   Integer modByPow2(uint32_t exp) const {
-    mpz_class res;
-    mpz_fdiv_r_2exp(res.get_mpz_t(), d_value.get_mpz_t(), exp);
+    if(d_big == NULL){
+      if(exp < 63){
+        return fromInt64(static_cast<int64_t>(static_cast<uint64_t>(d_small)
+                                              & ((uint64_t(1) << exp) - 1)));
+      }else if(d_small >= 0){
+        return *this;
+      }
+    }
+    mpz_class tmp, res;
+    mpz_fdiv_r_2exp(res.get_mpz_t(), asMpz(tmp).get_mpz_t(), exp);
     return Integer(res);
   }
 
@@ -333,14 +601,24 @@ public:
    * Returns y / 2^exp
    */
   Integer divByPow2(uint32_t exp) const {
+    if(d_big == NULL){
+      if(exp >= 63){
+        return Integer(d_small < 0 ? -1 : 0);
+      }
+      // rounds towards negative infinity, as mpz_fdiv_q_2exp
+      return fromInt64(d_small >= 0 ? d_small >> exp : ~((~d_small) >> exp));
+    }
     mpz_class res;
-    mpz_fdiv_q_2exp(res.get_mpz_t(), d_value.get_mpz_t(), exp);
+    mpz_fdiv_q_2exp(res.get_mpz_t(), d_big->get_mpz_t(), exp);
     return Integer(res);
   }
 
 
   int sgn() const {
-    return mpz_sgn(d_value.get_mpz_t());
+    if(d_big == NULL){
+      return (d_small > 0) - (d_small < 0);
+    }
+    return mpz_sgn(d_big->get_mpz_t());
   }
 
   inline bool strictlyPositive() const {
@@ -356,11 +634,11 @@ public:
   }
 
   bool isOne() const {
-    return mpz_cmp_si(d_value.get_mpz_t(), 1) == 0;
+    return d_big == NULL && d_small == 1;
   }
 
   bool isNegativeOne() const {
-    return mpz_cmp_si(d_value.get_mpz_t(), -1) == 0;
+    return d_big == NULL && d_small == -1;
   }
 
   /**
@@ -369,8 +647,8 @@ public:
    * @param exp the exponent
    */
   Integer pow(unsigned long int exp) const {
-    mpz_class result;
-    mpz_pow_ui(result.get_mpz_t(), d_value.get_mpz_t(), exp);
+    mpz_class tmp, result;
+    mpz_pow_ui(result.get_mpz_t(), asMpz(tmp).get_mpz_t(), exp);
     return Integer(result);
   }
 
@@ -378,8 +656,11 @@ public:
    * Return the greatest common divisor of this integer with another.
    */
   Integer gcd(const Integer& y) const {
-    mpz_class result;
-    mpz_gcd(result.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    if(bothSmall(y)){
+      return fromInt64(gcdSmall(magnitude(d_small), magnitude(y.d_small)));
+    }
+    mpz_class t1, t2, result;
+    mpz_gcd(result.get_mpz_t(), asMpz(t1).get_mpz_t(), y.asMpz(t2).get_mpz_t());
     return Integer(result);
   }
 
@@ -387,8 +668,19 @@ public:
    * Return the least common multiple of this integer with another.
    */
   Integer lcm(const Integer& y) const {
-    mpz_class result;
-    mpz_lcm(result.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    if(bothSmall(y)){
+      if(d_small == 0 || y.d_small == 0){
+        return Integer();
+      }
+      uint64_t a = magnitude(d_small), b = magnitude(y.d_small);
+      int64_t res;
+      if(!__builtin_mul_overflow(static_cast<int64_t>(a / gcdSmall(a, b)),
+                                 static_cast<int64_t>(b), &res)){
+        return fromInt64(res);
+      }
+    }
+    mpz_class t1, t2, result;
+    mpz_lcm(result.get_mpz_t(), asMpz(t1).get_mpz_t(), y.asMpz(t2).get_mpz_t());
     return Integer(result);
   }
 
@@ -421,7 +713,11 @@ public:
    * ! zero.divides(zero)
    */
   bool divides(const Integer& y) const {
-    int res = mpz_divisible_p(y.d_value.get_mpz_t(), d_value.get_mpz_t());
+    if(bothSmall(y)){
+      return d_small == 0 ? y.d_small == 0 : y.d_small % d_small == 0;
+    }
+    mpz_class t1, t2;
+    int res = mpz_divisible_p(y.asMpz(t2).get_mpz_t(), asMpz(t1).get_mpz_t());
     return res != 0;
   }
 
@@ -429,12 +725,10 @@ public:
    * Return the absolute value of this integer.
    */
   Integer abs() const {
-    return d_value >= 0 ? *this : -*this;
+    return sgn() >= 0 ? *this : -*this;
   }
 
-  std::string toString(int base = 10) const{
-    return d_value.get_str(base);
-  }
+  std::string toString(int base = 10) const;
 
   bool fitsSignedInt() const;
 
@@ -449,17 +743,29 @@ public:
   bool fitsUnsignedLong() const;
 
   long getLong() const {
-    long si = d_value.get_si();
+    if(d_big == NULL && d_small >= std::numeric_limits<long>::min()
+       && d_small <= std::numeric_limits<long>::max()){
+      return static_cast<long>(d_small);
+    }
+    mpz_class tmp;
+    const mpz_class& value = asMpz(tmp);
+    long si = value.get_si();
     // ensure there wasn't overflow
-    CheckArgument(mpz_cmp_si(d_value.get_mpz_t(), si) == 0, this,
+    CheckArgument(mpz_cmp_si(value.get_mpz_t(), si) == 0, this,
                  "Overflow detected in Integer::getLong().");
     return si;
   }
 
   unsigned long getUnsignedLong() const {
-    unsigned long ui = d_value.get_ui();
+    if(d_big == NULL && d_small >= 0 &&
+       static_cast<uint64_t>(d_small) <= std::numeric_limits<unsigned long>::max()){
+      return static_cast<unsigned long>(d_small);
+    }
+    mpz_class tmp;
+    const mpz_class& value = asMpz(tmp);
+    unsigned long ui = value.get_ui();
     // ensure there wasn't overflow
-    CheckArgument(mpz_cmp_ui(d_value.get_mpz_t(), ui) == 0, this,
+    CheckArgument(mpz_cmp_ui(value.get_mpz_t(), ui) == 0, this,
                   "Overflow detected in Integer::getUnsignedLong().");
     return ui;
   }
@@ -469,7 +775,10 @@ public:
    * numerator, the denominator.
    */
   size_t hash() const {
-    return gmpz_hash(d_value.get_mpz_t());
+    if(d_big != NULL){
+      return gmpz_hash(d_big->get_mpz_t());
+    }
+    return hashSmall(d_small);
   }
 
   /**
@@ -479,7 +788,11 @@ public:
    * @return true if bit n is set in this integer; false otherwise
    */
   bool testBit(unsigned n) const {
-    return mpz_tstbit(d_value.get_mpz_t(), n);
+    if(d_big == NULL){
+      return n >= 63 ? d_small < 0
+                     : ((static_cast<uint64_t>(d_small) >> n) & 1) != 0;
+    }
+    return mpz_tstbit(d_big->get_mpz_t(), n);
   }
 
   /**
@@ -487,11 +800,17 @@ public:
    * @return k if the integer is equal to 2^(k-1) and 0 otherwise
    */
   unsigned isPow2() const {
-    if (d_value <= 0) return 0;
+    if (sgn() <= 0) return 0;
+    if (d_big == NULL) {
+      if ((d_small & (d_small - 1)) != 0) return 0;
+      unsigned k = 1;
+      for (int64_t v = d_small; v > 1; v >>= 1) ++k;
+      return k;
+    }
     // check that the number of ones in the binary representation is 1
-    if (mpz_popcount(d_value.get_mpz_t()) == 1) {
+    if (mpz_popcount(d_big->get_mpz_t()) == 1) {
       // return the index of the first one plus 1
-      return mpz_scan1(d_value.get_mpz_t(), 0) + 1;
+      return mpz_scan1(d_big->get_mpz_t(), 0) + 1;
     }
     return 0; 
   }
@@ -502,17 +821,21 @@ public:
    * If x == 0, returns 1.
    */
   size_t length() const {
-    if(sgn() == 0){
-      return 1;
+    if(d_big == NULL){
+      return lengthSmall(d_small);
     }else{
-      return mpz_sizeinbase(d_value.get_mpz_t(),2);
+      return mpz_sizeinbase(d_big->get_mpz_t(),2);
     }
   }
 
   static void extendedGcd(Integer& g, Integer& s, Integer& t, const Integer& a, const Integer& b){
     //see the documentation for:
     //mpz_gcdext (mpz_t g, mpz_t s, mpz_t t, mpz_t a, mpz_t b);
-    mpz_gcdext (g.d_value.get_mpz_t(), s.d_value.get_mpz_t(), t.d_value.get_mpz_t(), a.d_value.get_mpz_t(), b.d_value.get_mpz_t());
+    mpz_class ta, tb, gz, sz, tz;
+    mpz_gcdext (gz.get_mpz_t(), sz.get_mpz_t(), tz.get_mpz_t(), a.asMpz(ta).get_mpz_t(), b.asMpz(tb).get_mpz_t());
+    g.setValue(gz.get_mpz_t());
+    s.setValue(sz.get_mpz_t());
+    t.setValue(tz.get_mpz_t());
   }
 
   /** Returns a reference to the minimum of two integers. */
@@ -0,0 +1,156 @@
+/*********************                                                        */
+/*! \file lock_free_channel.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A bounded, lock-free, multi-producer/multi-consumer channel
+ **
+ ** A SharedChannel backed by a fixed ring of slots, each carrying a
+ ** sequence number that tells producers and consumers whether the slot
+ ** is free or holds an element (D. Vyukov's bounded MPMC queue).  Neither
+ ** push() nor pop() takes a lock or blocks: push() fails when the channel
+ ** is full, and pop() must only be called once empty() has returned
+ ** false (or through tryPop()).
+ **/
+
+#include "cvc4_public.h"
+
+#ifndef __CVC4__LOCK_FREE_CHANNEL_H
+#define __CVC4__LOCK_FREE_CHANNEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "util/channel.h"
+
+namespace CVC4 {
+
+template <typename T>
+class CVC4_PUBLIC LockFreeSharedChannel : public SharedChannel<T> {
+public:
+  /** Creates a channel holding at least capacity elements. */
+  explicit LockFreeSharedChannel(size_t capacity)
+      : d_mask(roundUpToPowerOfTwo(capacity) - 1),
+        d_cells(d_mask + 1),
+        d_enqueuePos(0),
+        d_dequeuePos(0) {
+    for(size_t i = 0; i <= d_mask; ++i) {
+      d_cells[i].d_sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /* Adds an element, or returns false if the channel is full. */
+  bool push(const T& item) {
+    size_t pos = d_enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for(;;) {
+      cell = &d_cells[pos & d_mask];
+      size_t seq = cell->d_sequence.load(std::memory_order_acquire);
+      std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+      if(diff == 0) {
+        if(d_enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed)) {
+          break;
+        }
+      } else if(diff < 0) {
+        return false;
+      } else {
+        pos = d_enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+    cell->d_data = item;
+    cell->d_sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /* Removes an element, or returns false if there is none ready. */
+  bool tryPop(T& item) {
+    size_t pos = d_dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for(;;) {
+      cell = &d_cells[pos & d_mask];
+      size_t seq = cell->d_sequence.load(std::memory_order_acquire);
+      std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos + 1);
+      if(diff == 0) {
+        if(d_dequeuePos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed)) {
+          break;
+        }
+      } else if(diff < 0) {
+        return false;
+      } else {
+        pos = d_dequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+    item = cell->d_data;
+    cell->d_data = T();
+    cell->d_sequence.store(pos + d_mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*
+   * Removes an element.  With a single consumer, an element is always
+   * available if empty() returned false; otherwise T() is returned when
+   * another consumer got there first.
+   */
+  T pop() {
+    T item;
+    tryPop(item);
+    return item;
+  }
+
+  /* Whether the next element to pop is not (yet) available */
+  bool empty() {
+    size_t pos = d_dequeuePos.load(std::memory_order_relaxed);
+    const Cell& cell = d_cells[pos & d_mask];
+    return cell.d_sequence.load(std::memory_order_acquire) != pos + 1;
+  }
+
+  /* Whether the next push would fail */
+  bool full() {
+    size_t pos = d_enqueuePos.load(std::memory_order_relaxed);
+    const Cell& cell = d_cells[pos & d_mask];
+    return cell.d_sequence.load(std::memory_order_acquire) != pos;
+  }
+
+private:
+  LockFreeSharedChannel(const LockFreeSharedChannel&) CVC4_UNDEFINED;
+  LockFreeSharedChannel& operator=(const LockFreeSharedChannel&) CVC4_UNDEFINED;
+
+  struct Cell {
+    std::atomic<size_t> d_sequence;
+    T d_data;
+
+    Cell() : d_sequence(0), d_data() {}
+    Cell(const Cell& c)
+        : d_sequence(c.d_sequence.load(std::memory_order_relaxed)),
+          d_data(c.d_data) {}
+  };/* struct LockFreeSharedChannel<T>::Cell */
+
+  static size_t roundUpToPowerOfTwo(size_t n) {
+    size_t p = 2;
+    while(p < n) {
+      p <<= 1;
+    }
+    return p;
+  }
+
+  const size_t d_mask;
+  std::vector<Cell> d_cells;
+  /* The producer and consumer positions live on separate cache lines */
+  char d_pad0[64];
+  std::atomic<size_t> d_enqueuePos;
+  char d_pad1[64];
+  std::atomic<size_t> d_dequeuePos;
+};/* class LockFreeSharedChannel<T> */
+
+}/* CVC4 namespace */
+
+#endif /* __CVC4__LOCK_FREE_CHANNEL_H */
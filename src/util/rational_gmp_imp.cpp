@@ -33,6 +33,19 @@ std::ostream& operator<<(std::ostream& os, const Rational& q){
   return os << q.toString();
 }
 
+std::string Rational::toString(int base) const {
+  if(d_big == NULL && base == 10){
+    std::string res = std::to_string(static_cast<long long>(d_num));
+    if(d_den != 1){
+      res += '/';
+      res += std::to_string(static_cast<long long>(d_den));
+    }
+    return res;
+  }
+  mpq_class tmp;
+  return asMpq(tmp).get_str(base);
+}
+
 
 /* Computes a rational given a decimal string. The rational
  * version of <code>xxx.yyy</code> is <code>xxxyyy/(10^3)</code>.
@@ -91,9 +104,9 @@ Maybe<Rational> Rational::fromDouble(double d)
 {
   using namespace std;
   if(isfinite(d)){
-    Rational q;
-    mpq_set_d(q.d_value.get_mpq_t(), d);
-    return q;
+    mpq_class q;
+    mpq_set_d(q.get_mpq_t(), d);
+    return Rational(q);
   }
   return Maybe<Rational>();
 }
@@ -28,6 +28,8 @@
 #include <cstddef>
 
 #include <gmp.h>
+#include <limits>
+#include <stdint.h>
 #include <string>
 
 #include "base/exception.h"
@@ -54,10 +56,144 @@ namespace CVC4 {
 class CVC4_PUBLIC Rational {
 private:
   /**
-   * Stores the value of the rational is stored in a C++ GMP rational class.
-   * Using this instead of mpq_t allows for easier destruction.
+   * The value.  If its numerator and denominator could both be kept inline
+   * by an Integer (INT64_MIN < n, d <= INT64_MAX), the value is kept inline
+   * as d_num/d_den with d_big NULL and arithmetic is done on machine words,
+   * falling back to GMP when an intermediate result overflows.  Any other
+   * value is kept in the GMP rational d_big points to.  Either way it is in
+   * canonical form, and a value that fits inline always is.
    */
-  mpq_class d_value;
+  int64_t d_num;
+  int64_t d_den;
+  mpq_class* d_big;
+
+  /** Sets the value to n/d, which is canonical and fits inline. */
+  void setSmall(int64_t n, int64_t d) {
+    d_num = n;
+    d_den = d;
+    delete d_big;
+    d_big = NULL;
+  }
+
+  /** Sets the value to q, which is canonical. */
+  void setValue(mpq_srcptr q) {
+    if(Integer::fitsSmall(mpq_numref(q)) && Integer::fitsSmall(mpq_denref(q))){
+      setSmall(Integer::getInt64(mpq_numref(q)), Integer::getInt64(mpq_denref(q)));
+    }else if(d_big != NULL){
+      mpq_set(d_big->get_mpq_t(), q);
+    }else{
+      d_big = new mpq_class(q);
+    }
+  }
+
+  /** Sets the value to n/d in lowest terms; d must not be 0. */
+  void setFraction(mpz_srcptr n, mpz_srcptr d) {
+    mpq_class q;
+    mpz_set(mpq_numref(q.get_mpq_t()), n);
+    mpz_set(mpq_denref(q.get_mpq_t()), d);
+    q.canonicalize();
+    setValue(q.get_mpq_t());
+  }
+
+  /** Sets the value to n/d in lowest terms; d must not be 0. */
+  void setFraction(int64_t n, int64_t d) {
+    if(Integer::fitsSmall(n) && Integer::fitsSmall(d) && d != 0){
+      if(d < 0){
+        n = -n;
+        d = -d;
+      }
+      int64_t g = Integer::gcdSmall(Integer::magnitude(n), d);
+      setSmall(n / g, d / g);
+    }else{
+      mpz_class nz, dz;
+      Integer::setMpz(nz.get_mpz_t(), n);
+      Integer::setMpz(dz.get_mpz_t(), d);
+      setFraction(nz.get_mpz_t(), dz.get_mpz_t());
+    }
+  }
+
+  void setFraction(uint64_t n, uint64_t d) {
+    const uint64_t max = std::numeric_limits<int64_t>::max();
+    if(n <= max && d <= max){
+      setFraction(static_cast<int64_t>(n), static_cast<int64_t>(d));
+    }else{
+      mpz_class nz, dz;
+      mpz_import(nz.get_mpz_t(), 1, -1, sizeof(n), 0, 0, &n);
+      mpz_import(dz.get_mpz_t(), 1, -1, sizeof(d), 0, 0, &d);
+      setFraction(nz.get_mpz_t(), dz.get_mpz_t());
+    }
+  }
+
+  /**
+   * Returns a GMP rational with the value: the one backing the rational if
+   * it is large, otherwise tmp, set to the value.
+   */
+  const mpq_class& asMpq(mpq_class& tmp) const {
+    if(d_big != NULL){ return *d_big; }
+    Integer::setMpz(mpq_numref(tmp.get_mpq_t()), d_num);
+    Integer::setMpz(mpq_denref(tmp.get_mpq_t()), d_den);
+    return tmp;
+  }
+
+  int cmpGmp(const Rational& x) const {
+    //Don't use mpq_class's cmp() function.
+    //The name ends up conflicting with this function.
+    mpq_class t1, t2;
+    return mpq_cmp(asMpq(t1).get_mpq_t(), x.asMpq(t2).get_mpq_t());
+  }
+
+  /** Whether both rationals are kept inline */
+  bool bothSmall(const Rational& y) const {
+    return d_big == NULL && y.d_big == NULL;
+  }
+
+  /**
+   * Sets n/m to a/b + c/d (all inline, in canonical form) and returns
+   * true, or returns false if a machine word overflowed on the way.
+   */
+  static bool addSmall(int64_t a, int64_t b, int64_t c, int64_t d,
+                       int64_t& n, int64_t& m) {
+    int64_t t;
+    if(b == d){
+      if(__builtin_add_overflow(a, c, &t)){ return false; }
+      int64_t g = Integer::gcdSmall(Integer::magnitude(t), b);
+      n = t / g;
+      m = b / g;
+    }else{
+      // Knuth's method: with g = gcd(b, d), the result is
+      // (a*(d/g) + c*(b/g)) / (b*(d/g)), reduced by a divisor of g only
+      int64_t g = Integer::gcdSmall(b, d);
+      int64_t ad, cb;
+      if(__builtin_mul_overflow(a, d / g, &ad) ||
+         __builtin_mul_overflow(c, b / g, &cb) ||
+         __builtin_add_overflow(ad, cb, &t)){
+        return false;
+      }
+      if(t == 0){
+        n = 0;
+        m = 1;
+        return true;
+      }
+      int64_t g2 = g == 1 ? 1 : Integer::gcdSmall(Integer::magnitude(t), g);
+      if(__builtin_mul_overflow(b / g, d / g2, &m)){ return false; }
+      n = t / g2;
+    }
+    return Integer::fitsSmall(n);
+  }
+
+  /** As addSmall(), for a/b * c/d. */
+  static bool mulSmall(int64_t a, int64_t b, int64_t c, int64_t d,
+                       int64_t& n, int64_t& m) {
+    // cross-cancel first so that the result is in lowest terms
+    int64_t g1 = Integer::gcdSmall(Integer::magnitude(a), d);
+    int64_t g2 = Integer::gcdSmall(Integer::magnitude(c), b);
+    if(g1 == 0 || g2 == 0){ return false; }
+    if(__builtin_mul_overflow(a / g1, c / g2, &n) ||
+       __builtin_mul_overflow(b / g2, d / g1, &m)){
+      return false;
+    }
+    return Integer::fitsSmall(n) && Integer::fitsSmall(m);
+  }
 
   /**
    * Constructs a Rational from a mpq_class object.
@@ -65,7 +201,17 @@ private:
    * Assumes that the value is in canonical form, and thus does not
    * have to call canonicalize() on the value.
    */
-  Rational(const mpq_class& val) : d_value(val) {  }
+  Rational(const mpq_class& val) : d_num(0), d_den(1), d_big(NULL) {
+    setValue(val.get_mpq_t());
+  }
+
+  /** Constructs the rational n/m, which is canonical and fits inline. */
+  static Rational fromSmall(int64_t n, int64_t m) {
+    Rational res;
+    res.d_num = n;
+    res.d_den = m;
+    return res;
+  }
 
 public:
 
@@ -78,9 +224,7 @@ public:
   static Rational fromDecimal(const std::string& dec);
 
   /** Constructs a rational with the value 0/1. */
-  Rational() : d_value(0){
-    d_value.canonicalize();
-  }
+  Rational() : d_num(0), d_den(1), d_big(NULL) {}
 
   /**
    * Constructs a Rational from a C string in a given base (defaults to 10).
@@ -89,88 +233,109 @@ public:
    * For more information about what is a valid rational string,
    * see GMP's documentation for mpq_set_str().
    */
-  explicit Rational(const char* s, unsigned base = 10): d_value(s, base) {
-    d_value.canonicalize();
+  explicit Rational(const char* s, unsigned base = 10)
+    : d_num(0), d_den(1), d_big(NULL)
+  {
+    mpq_class q(s, base);
+    q.canonicalize();
+    setValue(q.get_mpq_t());
   }
-  Rational(const std::string& s, unsigned base = 10) : d_value(s, base) {
-    d_value.canonicalize();
+  Rational(const std::string& s, unsigned base = 10)
+    : d_num(0), d_den(1), d_big(NULL)
+  {
+    mpq_class q(s, base);
+    q.canonicalize();
+    setValue(q.get_mpq_t());
   }
 
   /**
    * Creates a Rational from another Rational, q, by performing a deep copy.
    */
-  Rational(const Rational& q) : d_value(q.d_value) {
-    d_value.canonicalize();
+  Rational(const Rational& q)
+    : d_num(q.d_num), d_den(q.d_den),
+      d_big(q.d_big == NULL ? NULL : new mpq_class(*q.d_big))
+  {}
+
+  Rational(Rational&& q) : d_num(q.d_num), d_den(q.d_den), d_big(q.d_big) {
+    q.d_num = 0;
+    q.d_den = 1;
+    q.d_big = NULL;
   }
 
   /**
    * Constructs a canonical Rational from a numerator.
    */
-  Rational(signed int n) : d_value(n,1) {
-    d_value.canonicalize();
+  Rational(signed int n) : d_num(n), d_den(1), d_big(NULL) {}
+  Rational(unsigned int n) : d_num(n), d_den(1), d_big(NULL) {}
+  Rational(signed long int n) : d_num(0), d_den(1), d_big(NULL) {
+    setFraction(static_cast<int64_t>(n), int64_t(1));
   }
-  Rational(unsigned int n) : d_value(n,1) {
-    d_value.canonicalize();
-  }
-  Rational(signed long int n) : d_value(n,1) {
-    d_value.canonicalize();
-  }
-  Rational(unsigned long int n) : d_value(n,1) {
-    d_value.canonicalize();
+  Rational(unsigned long int n) : d_num(0), d_den(1), d_big(NULL) {
+    setFraction(static_cast<uint64_t>(n), uint64_t(1));
   }
 
 #ifdef CVC4_NEED_INT64_T_OVERLOADS
-  Rational(int64_t n) : d_value(static_cast<long>(n), 1) {
-    d_value.canonicalize();
+  Rational(int64_t n) : d_num(0), d_den(1), d_big(NULL) {
+    setFraction(n, int64_t(1));
   }
-  Rational(uint64_t n) : d_value(static_cast<unsigned long>(n), 1) {
-    d_value.canonicalize();
+  Rational(uint64_t n) : d_num(0), d_den(1), d_big(NULL) {
+    setFraction(n, uint64_t(1));
   }
 #endif /* CVC4_NEED_INT64_T_OVERLOADS */
 
   /**
    * Constructs a canonical Rational from a numerator and denominator.
    */
-  Rational(signed int n, signed int d) : d_value(n,d) {
-    d_value.canonicalize();
+  Rational(signed int n, signed int d) : d_num(0), d_den(1), d_big(NULL) {
+    setFraction(int64_t(n), int64_t(d));
   }
-  Rational(unsigned int n, unsigned int d) : d_value(n,d) {
-    d_value.canonicalize();
+  Rational(unsigned int n, unsigned int d) : d_num(0), d_den(1), d_big(NULL) {
+    setFraction(int64_t(n), int64_t(d));
   }
-  Rational(signed long int n, signed long int d) : d_value(n,d) {
-    d_value.canonicalize();
+  Rational(signed long int n, signed long int d)
+    : d_num(0), d_den(1), d_big(NULL)
+  {
+    setFraction(static_cast<int64_t>(n), static_cast<int64_t>(d));
   }
-  Rational(unsigned long int n, unsigned long int d) : d_value(n,d) {
-    d_value.canonicalize();
+  Rational(unsigned long int n, unsigned long int d)
+    : d_num(0), d_den(1), d_big(NULL)
+  {
+    setFraction(static_cast<uint64_t>(n), static_cast<uint64_t>(d));
   }
 
 #ifdef CVC4_NEED_INT64_T_OVERLOADS
-  Rational(int64_t n, int64_t d) : d_value(static_cast<long>(n), static_cast<long>(d)) {
-    d_value.canonicalize();
+  Rational(int64_t n, int64_t d) : d_num(0), d_den(1), d_big(NULL) {
+    setFraction(n, d);
   }
-  Rational(uint64_t n, uint64_t d) : d_value(static_cast<unsigned long>(n), static_cast<unsigned long>(d)) {
-    d_value.canonicalize();
+  Rational(uint64_t n, uint64_t d) : d_num(0), d_den(1), d_big(NULL) {
+    setFraction(n, d);
   }
 #endif /* CVC4_NEED_INT64_T_OVERLOADS */
 
-  Rational(const Integer& n, const Integer& d) :
-    d_value(n.get_mpz(), d.get_mpz())
+  Rational(const Integer& n, const Integer& d)
+    : d_num(0), d_den(1), d_big(NULL)
   {
-    d_value.canonicalize();
+    if(n.bothSmall(d)){
+      setFraction(n.d_small, d.d_small);
+    }else{
+      mpz_class t1, t2;
+      setFraction(n.asMpz(t1).get_mpz_t(), d.asMpz(t2).get_mpz_t());
+    }
   }
-  Rational(const Integer& n) :
-    d_value(n.get_mpz())
-  {
-    d_value.canonicalize();
+  Rational(const Integer& n) : d_num(n.d_small), d_den(1), d_big(NULL) {
+    if(n.d_big != NULL){
+      d_big = new mpq_class(*n.d_big);
+    }
   }
-  ~Rational() {}
+  ~Rational() { delete d_big; }
 
   /**
-   * Returns a copy of d_value to enable public access of GMP data.
+   * Returns a copy of the value as a GMP rational.
    */
   mpq_class getValue() const
   {
-    return d_value;
+    mpq_class tmp;
+    return asMpq(tmp);
   }
 
   /**
@@ -178,7 +343,10 @@ public:
    * Note that this makes a deep copy of the numerator.
    */
   Integer getNumerator() const {
-    return Integer(d_value.get_num());
+    if(d_big == NULL){
+      return Integer::fromInt64(d_num);
+    }
+    return Integer(d_big->get_num());
   }
 
   /**
@@ -186,7 +354,10 @@ public:
    * Note that this makes a deep copy of the denominator.
    */
   Integer getDenominator() const {
-    return Integer(d_value.get_den());
+    if(d_big == NULL){
+      return Integer::fromInt64(d_den);
+    }
+    return Integer(d_big->get_den());
   }
 
   static Maybe<Rational> fromDouble(double d);
@@ -197,21 +368,39 @@ public:
    * infinity, and underflow may result in zero.
    */
   double getDouble() const {
-    return d_value.get_d();
+    if(d_big == NULL){
+      return static_cast<double>(d_num) / static_cast<double>(d_den);
+    }
+    return d_big->get_d();
   }
 
   Rational inverse() const {
+    if(d_big == NULL && d_num != 0){
+      return d_num > 0 ? fromSmall(d_den, d_num) : fromSmall(-d_den, -d_num);
+    }
     return Rational(getDenominator(), getNumerator());
   }
 
   int cmp(const Rational& x) const {
-    //Don't use mpq_class's cmp() function.
-    //The name ends up conflicting with this function.
-    return mpq_cmp(d_value.get_mpq_t(), x.d_value.get_mpq_t());
+    if(bothSmall(x)){
+      int64_t l, r;
+      if(d_den == x.d_den){
+        l = d_num;
+        r = x.d_num;
+      }else if(__builtin_mul_overflow(d_num, x.d_den, &l) ||
+               __builtin_mul_overflow(x.d_num, d_den, &r)){
+        return cmpGmp(x);
+      }
+      return l < r ? -1 : (l > r ? 1 : 0);
+    }
+    return cmpGmp(x);
   }
 
   int sgn() const {
-    return mpq_sgn(d_value.get_mpq_t());
+    if(d_big == NULL){
+      return (d_num > 0) - (d_num < 0);
+    }
+    return mpq_sgn(d_big->get_mpq_t());
   }
 
   bool isZero() const {
@@ -219,11 +408,11 @@ public:
   }
 
   bool isOne() const {
-    return mpq_cmp_si(d_value.get_mpq_t(), 1, 1) == 0;
+    return d_big == NULL && d_num == 1 && d_den == 1;
   }
 
   bool isNegativeOne() const {
-    return mpq_cmp_si(d_value.get_mpq_t(), -1, 1) == 0;
+    return d_big == NULL && d_num == -1 && d_den == 1;
   }
 
   Rational abs() const {
@@ -235,14 +424,24 @@ public:
   }
 
   Integer floor() const {
+    if(d_big == NULL){
+      int64_t q = d_num / d_den;
+      if(d_num % d_den != 0 && d_num < 0){ --q; }
+      return Integer::fromInt64(q);
+    }
     mpz_class q;
-    mpz_fdiv_q(q.get_mpz_t(), d_value.get_num_mpz_t(), d_value.get_den_mpz_t());
+    mpz_fdiv_q(q.get_mpz_t(), d_big->get_num_mpz_t(), d_big->get_den_mpz_t());
     return Integer(q);
   }
 
   Integer ceiling() const {
+    if(d_big == NULL){
+      int64_t q = d_num / d_den;
+      if(d_num % d_den != 0 && d_num > 0){ ++q; }
+      return Integer::fromInt64(q);
+    }
     mpz_class q;
-    mpz_cdiv_q(q.get_mpz_t(), d_value.get_num_mpz_t(), d_value.get_den_mpz_t());
+    mpz_cdiv_q(q.get_mpz_t(), d_big->get_num_mpz_t(), d_big->get_den_mpz_t());
     return Integer(q);
   }
 
@@ -252,92 +451,142 @@ public:
 
   Rational& operator=(const Rational& x){
     if(this == &x) return *this;
-    d_value = x.d_value;
+    if(x.d_big == NULL){
+      setSmall(x.d_num, x.d_den);
+    }else if(d_big != NULL){
+      *d_big = *x.d_big;
+    }else{
+      d_big = new mpq_class(*x.d_big);
+    }
+    return *this;
+  }
+
+  Rational& operator=(Rational&& x){
+    if(this == &x) return *this;
+    delete d_big;
+    d_num = x.d_num;
+    d_den = x.d_den;
+    d_big = x.d_big;
+    x.d_num = 0;
+    x.d_den = 1;
+    x.d_big = NULL;
     return *this;
   }
 
   Rational operator-() const{
-    return Rational(-(d_value));
+    if(d_big == NULL){
+      return fromSmall(-d_num, d_den);
+    }
+    return Rational(mpq_class(-(*d_big)));
   }
 
   bool operator==(const Rational& y) const {
-    return d_value == y.d_value;
+    if(d_big == NULL){
+      return y.d_big == NULL && d_num == y.d_num && d_den == y.d_den;
+    }
+    return y.d_big != NULL && *d_big == *y.d_big;
   }
 
   bool operator!=(const Rational& y) const {
-    return d_value != y.d_value;
+    return !(*this == y);
   }
 
   bool operator< (const Rational& y) const {
-    return d_value < y.d_value;
+    return cmp(y) < 0;
   }
 
   bool operator<=(const Rational& y) const {
-    return d_value <= y.d_value;
+    return cmp(y) <= 0;
   }
 
   bool operator> (const Rational& y) const {
-    return d_value > y.d_value;
+    return cmp(y) > 0;
   }
 
   bool operator>=(const Rational& y) const {
-    return d_value >= y.d_value;
+    return cmp(y) >= 0;
   }
 
   Rational operator+(const Rational& y) const{
-    return Rational( d_value + y.d_value );
+    int64_t n, m;
+    if(bothSmall(y) && addSmall(d_num, d_den, y.d_num, y.d_den, n, m)){
+      return fromSmall(n, m);
+    }
+    mpq_class t1, t2;
+    return Rational( asMpq(t1) + y.asMpq(t2) );
   }
   Rational operator-(const Rational& y) const {
-    return Rational( d_value - y.d_value );
+    int64_t n, m;
+    if(bothSmall(y) && addSmall(d_num, d_den, -y.d_num, y.d_den, n, m)){
+      return fromSmall(n, m);
+    }
+    mpq_class t1, t2;
+    return Rational( asMpq(t1) - y.asMpq(t2) );
   }
 
   Rational operator*(const Rational& y) const {
-    return Rational( d_value * y.d_value );
+    int64_t n, m;
+    if(bothSmall(y) && mulSmall(d_num, d_den, y.d_num, y.d_den, n, m)){
+      return fromSmall(n, m);
+    }
+    mpq_class t1, t2;
+    return Rational( asMpq(t1) * y.asMpq(t2) );
   }
   Rational operator/(const Rational& y) const {
-    return Rational( d_value / y.d_value );
+    int64_t n, m;
+    if(bothSmall(y) && y.d_num != 0 &&
+       mulSmall(d_num, d_den,
+                y.d_num > 0 ? y.d_den : -y.d_den,
+                y.d_num > 0 ? y.d_num : -y.d_num, n, m)){
+      return fromSmall(n, m);
+    }
+    mpq_class t1, t2;
+    return Rational( asMpq(t1) / y.asMpq(t2) );
   }
 
   Rational& operator+=(const Rational& y){
-    d_value += y.d_value;
-    return (*this);
+    return *this = *this + y;
   }
   Rational& operator-=(const Rational& y){
-    d_value -= y.d_value;
-    return (*this);
+    return *this = *this - y;
   }
 
   Rational& operator*=(const Rational& y){
-    d_value *= y.d_value;
-    return (*this);
+    return *this = *this * y;
   }
 
   Rational& operator/=(const Rational& y){
-    d_value /= y.d_value;
-    return (*this);
+    return *this = *this / y;
   }
 
   bool isIntegral() const{
-    return getDenominator() == 1;
+    if(d_big == NULL){
+      return d_den == 1;
+    }
+    return mpz_cmp_ui(d_big->get_den_mpz_t(), 1) == 0;
   }
 
   /** Returns a string representing the rational in the given base. */
-  std::string toString(int base = 10) const {
-    return d_value.get_str(base);
-  }
+  std::string toString(int base = 10) const;
 
   /**
    * Computes the hash of the rational from hashes of the numerator and the
    * denominator.
    */
   size_t hash() const {
-    size_t numeratorHash = gmpz_hash(d_value.get_num_mpz_t());
-    size_t denominatorHash = gmpz_hash(d_value.get_den_mpz_t());
+    if(d_big == NULL){
+      return Integer::hashSmall(d_num) xor Integer::hashSmall(d_den);
+    }
+    size_t numeratorHash = gmpz_hash(d_big->get_num_mpz_t());
+    size_t denominatorHash = gmpz_hash(d_big->get_den_mpz_t());
 
     return numeratorHash xor denominatorHash;
   }
 
   uint32_t complexity() const {
+    if(d_big == NULL){
+      return Integer::lengthSmall(d_num) + Integer::lengthSmall(d_den);
+    }
     uint32_t numLen = getNumerator().length();
     uint32_t denLen = getDenominator().length();
     return  numLen + denLen;
@@ -120,6 +120,7 @@ ResourceManager::ResourceManager()
   , d_spendResourceCalls(0)
   , d_hardListeners()
   , d_softListeners()
+  , d_safePointListeners()
 {}
 
 
@@ -177,6 +178,10 @@ void ResourceManager::spendResource(unsigned amount)
 {
   ++d_spendResourceCalls;
   d_cumulativeResourceUsed += amount;
+  if (!d_safePointListeners.empty())
+  {
+    d_safePointListeners.notify();
+  }
   if (!d_on) return;
 
   Debug("limit") << "ResourceManager::spendResource()" << std::endl;
@@ -297,4 +302,10 @@ ListenerCollection::Registration* ResourceManager::registerSoftListener(
   return d_softListeners.registerListener(listener);
 }
 
+ListenerCollection::Registration* ResourceManager::registerSafePointListener(
+    Listener* listener)
+{
+  return d_safePointListeners.registerListener(listener);
+}
+
 } /* namespace CVC4 */
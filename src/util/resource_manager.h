@@ -116,6 +116,9 @@ class CVC4_PUBLIC ResourceManager {
   /** Receives a notification on reaching a hard limit. */
   ListenerCollection d_softListeners;
 
+  /** Receives a notification on every call to spendResource(). */
+  ListenerCollection d_safePointListeners;
+
   /**
    * ResourceManagers cannot be copied as they are given an explicit
    * list of Listeners to respond to.
@@ -192,6 +195,18 @@ public:
    */
   ListenerCollection::Registration* registerSoftListener(Listener* listener);
 
+  /**
+   * Registers a listener that is notified on every call to
+   * spendResource().  Those calls are made at points where the caller
+   * is prepared to be interrupted, so they are also safe points for
+   * amortized housekeeping such as incremental garbage collection.
+   *
+   * This Registration must be destroyed by the user before this
+   * ResourceManager.
+   */
+  ListenerCollection::Registration* registerSafePointListener(
+      Listener* listener);
+
 };/* class ResourceManager */
 
 
@@ -0,0 +1,192 @@
+/*********************                                                        */
+/*! \file statistics_export.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Machine-readable export of statistics
+ **
+ ** Machine-readable export of statistics.
+ **/
+
+#include "util/statistics_export.h"
+
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+#include "util/statistics.h"
+
+namespace CVC4 {
+
+void StatisticsExporter::add(const StatisticsBase& stats,
+                             const std::string& prefix) {
+  for(StatisticsBase::const_iterator i = stats.begin(); i != stats.end(); ++i) {
+    if(prefix.empty()) {
+      d_stats.push_back(*i);
+    } else {
+      d_stats.push_back(std::make_pair(
+          prefix + "::" + (*i).first, (*i).second));
+    }
+  }
+}
+
+void StatisticsExporter::add(const std::string& name, const SExpr& value) {
+  d_stats.push_back(std::make_pair(name, value));
+}
+
+void StatisticsExporter::write(std::ostream& out,
+                               StatisticsExportFormat format) const {
+  switch(format) {
+  case STATS_EXPORT_JSON:
+    writeJson(out);
+    out << std::endl;
+    break;
+  case STATS_EXPORT_BINARY:
+    writeBinaryMagic(out);
+    writeBinary(out);
+    break;
+  }
+}
+
+void StatisticsExporter::writeJson(std::ostream& out) const {
+  out << "{";
+  for(size_t i = 0; i < d_stats.size(); ++i) {
+    if(i > 0) {
+      out << ", ";
+    }
+    writeJsonString(out, d_stats[i].first);
+    out << ": ";
+    writeJsonValue(out, d_stats[i].second);
+  }
+  out << "}";
+}
+
+void StatisticsExporter::writeJsonString(std::ostream& out,
+                                         const std::string& s) {
+  out << '"';
+  for(std::string::const_iterator i = s.begin(); i != s.end(); ++i) {
+    unsigned char c = *i;
+    switch(c) {
+    case '"': out << "\\\""; break;
+    case '\\': out << "\\\\"; break;
+    case '\n': out << "\\n"; break;
+    case '\t': out << "\\t"; break;
+    default:
+      if(c < 0x20) {
+        std::ios_base::fmtflags flags = out.flags();
+        out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+            << unsigned(c);
+        out.flags(flags);
+      } else {
+        out << c;
+      }
+    }
+  }
+  out << '"';
+}
+
+void StatisticsExporter::writeJsonValue(std::ostream& out,
+                                        const SExpr& value) {
+  if(value.isInteger()) {
+    out << value.getIntegerValue();
+  } else if(value.isRational()) {
+    // JSON has no number for a rational out of the range of a double, so
+    // that one is written exactly, as a string
+    double d = value.getRationalValue().getDouble();
+    if(std::isfinite(d)) {
+      std::stringstream ss;
+      ss << std::setprecision(17) << d;
+      out << ss.str();
+    } else {
+      writeJsonString(out, value.getRationalValue().toString());
+    }
+  } else if(value.isKeyword()) {
+    std::string k = value.getValue();
+    if(k == "true" || k == "false") {
+      out << k;
+    } else {
+      writeJsonString(out, k);
+    }
+  } else if(value.isString()) {
+    writeJsonString(out, value.getValue());
+  } else {
+    const std::vector<SExpr>& children = value.getChildren();
+    out << "[";
+    for(size_t i = 0; i < children.size(); ++i) {
+      if(i > 0) {
+        out << ", ";
+      }
+      writeJsonValue(out, children[i]);
+    }
+    out << "]";
+  }
+}
+
+void StatisticsExporter::writeBinaryMagic(std::ostream& out) {
+  out.write("CVC4STB1", 8);
+}
+
+void StatisticsExporter::writeBinary(std::ostream& out) const {
+  writeBinaryUnsigned(out, d_stats.size());
+  for(size_t i = 0; i < d_stats.size(); ++i) {
+    writeBinaryString(out, d_stats[i].first);
+    writeBinaryValue(out, d_stats[i].second);
+  }
+}
+
+void StatisticsExporter::writeBinaryUnsigned(std::ostream& out,
+                                             uint64_t value) {
+  while(value >= 0x80) {
+    out.put(char((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.put(char(value));
+}
+
+void StatisticsExporter::writeBinaryString(std::ostream& out,
+                                           const std::string& s) {
+  writeBinaryUnsigned(out, s.size());
+  out.write(s.data(), s.size());
+}
+
+void StatisticsExporter::writeBinaryValue(std::ostream& out,
+                                          const SExpr& value) {
+  if(value.isInteger()) {
+    const Integer& i = value.getIntegerValue();
+    if(!i.fitsSignedLong()) {
+      out.put('I');
+      writeBinaryString(out, i.toString());
+    } else if(i.getLong() < 0) {
+      out.put('n');
+      writeBinaryUnsigned(out, -uint64_t(i.getLong()));
+    } else {
+      out.put('i');
+      writeBinaryUnsigned(out, uint64_t(i.getLong()));
+    }
+  } else if(value.isRational()) {
+    out.put('r');
+    writeBinaryString(out, value.getRationalValue().toString());
+  } else if(value.isKeyword()) {
+    out.put('k');
+    writeBinaryString(out, value.getValue());
+  } else if(value.isString()) {
+    out.put('s');
+    writeBinaryString(out, value.getValue());
+  } else {
+    const std::vector<SExpr>& children = value.getChildren();
+    out.put('l');
+    writeBinaryUnsigned(out, children.size());
+    for(size_t i = 0; i < children.size(); ++i) {
+      writeBinaryValue(out, children[i]);
+    }
+  }
+}
+
+}/* CVC4 namespace */
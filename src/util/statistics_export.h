@@ -0,0 +1,107 @@
+/*********************                                                        */
+/*! \file statistics_export.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Machine-readable export of statistics
+ **
+ ** Writes the values of one or more sets of statistics as a JSON object
+ ** or in a compact binary encoding, for consumption by tools rather
+ ** than people.
+ **
+ ** A binary file starts with the bytes "CVC4STB1", followed by one or
+ ** more records.  A record is a count followed by (name, value) pairs.
+ ** Counts, lengths and non-negative integers are LEB128 varints, negative
+ ** integers are stored as the varint of their absolute value, and strings
+ ** are length-prefixed.  Each value starts with a tag byte:
+ **
+ **   'i' integer (varint)     'I' integer too large for 64 bits (string)
+ **   'n' negative integer     'r' rational (string "p/q")
+ **   's' string (string)      'k' keyword (string)
+ **   'l' list (count, then that many values)
+ **/
+
+#include "cvc4_private_library.h"
+
+#ifndef __CVC4__STATISTICS_EXPORT_H
+#define __CVC4__STATISTICS_EXPORT_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "util/sexpr.h"
+
+namespace CVC4 {
+
+class StatisticsBase;
+
+/** The formats statistics can be exported in */
+enum StatisticsExportFormat
+{
+  STATS_EXPORT_JSON,
+  STATS_EXPORT_BINARY
+};/* enum StatisticsExportFormat */
+
+class CVC4_PUBLIC StatisticsExporter {
+ public:
+  /**
+   * Add all statistics in stats, with their names prefixed by
+   * "prefix::" if prefix is non-empty.
+   */
+  void add(const StatisticsBase& stats, const std::string& prefix = "");
+
+  /** Add a single named value. */
+  void add(const std::string& name, const SExpr& value);
+
+  /** Remove everything added so far. */
+  void clear() { d_stats.clear(); }
+
+  /**
+   * Write the statistics in the given format, as a complete file (that
+   * is, with the magic in the binary case).
+   */
+  void write(std::ostream& out, StatisticsExportFormat format) const;
+
+  /** Write the statistics as a JSON object mapping names to values. */
+  void writeJson(std::ostream& out) const;
+
+  /**
+   * Write the statistics as one binary record.  A file of such records
+   * starts with writeBinaryMagic().
+   */
+  void writeBinary(std::ostream& out) const;
+
+  /** Write the bytes a file of binary statistics records starts with. */
+  static void writeBinaryMagic(std::ostream& out);
+
+  /** Write an s-expression as a JSON value. */
+  static void writeJsonValue(std::ostream& out, const SExpr& value);
+
+  /** Write a string as a quoted JSON string. */
+  static void writeJsonString(std::ostream& out, const std::string& s);
+
+  /** Write an s-expression in the binary encoding. */
+  static void writeBinaryValue(std::ostream& out, const SExpr& value);
+
+  /** Write a varint of the binary encoding. */
+  static void writeBinaryUnsigned(std::ostream& out, uint64_t value);
+
+  /** Write a length-prefixed string of the binary encoding. */
+  static void writeBinaryString(std::ostream& out, const std::string& s);
+
+ private:
+  std::vector<std::pair<std::string, SExpr> > d_stats;
+};/* class StatisticsExporter */
+
+}/* CVC4 namespace */
+
+#endif /* __CVC4__STATISTICS_EXPORT_H */
@@ -0,0 +1,44 @@
+; REQUIRES: statistics
+; COMMAND-LINE: --incremental --arith-compact-tableau --stats
+; ERROR-SCRUBBER: sed -n -e 's/.*theory::arith::tableauCompactions, [1-9][0-9]*$/compacted/p' -e '/^compacted$/q'
+; EXPECT-ERROR: compacted
+; EXPECT: sat
+; EXPECT: unsat
+; The tableau has more than the 64 entries a compaction waits for, and
+; simplex has to pivot, so the rows are compacted in the solver itself
+(set-logic QF_LRA)
+(declare-fun x0 () Real)
+(declare-fun x1 () Real)
+(declare-fun x2 () Real)
+(declare-fun x3 () Real)
+(declare-fun x4 () Real)
+(declare-fun x5 () Real)
+(declare-fun x6 () Real)
+(declare-fun x7 () Real)
+(declare-fun x8 () Real)
+(declare-fun x9 () Real)
+(declare-fun x10 () Real)
+(declare-fun x11 () Real)
+(declare-fun x12 () Real)
+(declare-fun x13 () Real)
+(declare-fun x14 () Real)
+(declare-fun x15 () Real)
+(assert (>= (+ (* 2 x2) (* (- 1) x6) (* (- 7) x14) (* 7 x1) (* 3 x3) (* (- 6) x12)) (- 53)))
+(assert (<= (+ (* (- 7) x1) (* 2 x9) (* 7 x14) (* (- 5) x6) (* (- 3) x0) (* (- 1) x3)) (- 37)))
+(assert (>= (+ (* (- 6) x3) (* 3 x9) (* 3 x4) (* 4 x8) (* (- 4) x10) (* (- 2) x2)) (- 79)))
+(assert (<= (+ (* 4 x2) (* 2 x9) (* (- 1) x0) (* 6 x14) (* (- 2) x3) (* 1 x7)) (- 12)))
+(assert (>= (+ (* (- 6) x11) (* 3 x4) (* (- 3) x3) (* 2 x12) (* 1 x2) (* (- 2) x13)) 10))
+(assert (<= (+ (* (- 5) x9) (* 6 x15) (* (- 2) x1) (* (- 5) x13) (* 1 x8) (* (- 1) x6)) (- 51)))
+(assert (>= (+ (* 5 x2) (* (- 2) x12) (* 3 x8) (* 1 x9) (* 3 x5) (* 6 x11)) (- 70)))
+(assert (<= (+ (* (- 6) x2) (* (- 7) x13) (* 5 x1) (* 5 x4) (* (- 3) x7) (* 4 x10)) (- 57)))
+(assert (>= (+ (* 1 x9) (* (- 2) x11) (* (- 5) x6) (* 3 x10) (* (- 6) x5) (* 1 x0)) 6))
+(assert (<= (+ (* (- 1) x6) (* (- 1) x12) (* 7 x4) (* 1 x2) (* (- 6) x11) (* (- 5) x3)) (- 43)))
+(assert (>= (+ (* (- 3) x12) (* 5 x8) (* (- 1) x4) (* (- 2) x2) (* 4 x6) (* (- 1) x14)) (- 11)))
+(assert (<= (+ (* (- 4) x4) (* (- 7) x1) (* 1 x2) (* 7 x13) (* 3 x3) (* (- 5) x10)) 60))
+(assert (>= (+ (* 3 x9) (* 3 x0) (* (- 2) x2) (* (- 5) x6) (* 5 x8) (* 7 x5)) (- 90)))
+(assert (<= (+ (* (- 1) x14) (* (- 1) x15) (* (- 1) x13) (* (- 1) x12) (* (- 6) x10) (* 1 x8)) (- 30)))
+(check-sat)
+(push 1)
+(assert (< (+ (* 2 x2) (* (- 1) x6) (* (- 7) x14) (* 7 x1) (* 3 x3) (* (- 6) x12)) (- 53)))
+(check-sat)
+(pop 1)
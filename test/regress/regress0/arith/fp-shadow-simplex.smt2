@@ -0,0 +1,24 @@
+; REQUIRES: statistics
+; COMMAND-LINE: --fp-shadow-simplex --incremental --stats
+; ERROR-SCRUBBER: sed -n -e 's/.*fpShadow::decided, [1-9][0-9]*$/fpShadow decided/p' -e '/^fpShadow decided$/q'
+; EXPECT-ERROR: fpShadow decided
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+(set-logic QF_LRA)
+(declare-fun x () Real)
+(declare-fun y () Real)
+(declare-fun z () Real)
+(assert (>= (+ x y z) 10))
+(assert (<= (- x y) 1))
+(assert (>= (+ (* 3 y) (* (/ 1 3) z)) 7))
+(assert (< (+ x (* 2 z)) 5))
+(assert (> z (- 1)))
+(check-sat)
+(push 1)
+(assert (< y 2))
+(assert (< z 0))
+(check-sat)
+(pop 1)
+(assert (= (+ (* 7 x) (* 11 y)) (/ 100 3)))
+(check-sat)
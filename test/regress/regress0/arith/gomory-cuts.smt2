@@ -0,0 +1,16 @@
+; COMMAND-LINE: --arith-gomory-cuts=20 --incremental
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+(set-logic QF_LIA)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (>= (- (* (- 5) x) (* 3 y)) 2))
+(assert (>= (+ (* 5 x) y) (- 3)))
+(check-sat)
+(push 1)
+(assert (>= (+ (* (- 2) x) (* 3 y)) (- 1)))
+(check-sat)
+(pop 1)
+(assert (<= (+ x y) (- 1)))
+(check-sat)
@@ -0,0 +1,29 @@
+; REQUIRES: statistics
+; COMMAND-LINE: --arith-watched-prop=50 --incremental --stats
+; ERROR-SCRUBBER: sed -n -e 's/.*watchedProp::successes, [1-9][0-9]*$/watchedProp succeeded/p' -e '/^watchedProp succeeded$/q'
+; EXPECT-ERROR: watchedProp succeeded
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+(set-logic QF_LIA)
+(declare-fun s1 () Int)
+(declare-fun s2 () Int)
+(declare-fun s3 () Int)
+(declare-fun s4 () Int)
+(declare-fun T () Int)
+(assert (>= s1 0))
+(assert (>= (- s2 s1) 3))
+(assert (>= (- s3 s2) 2))
+(assert (or (>= (- s4 s3) 1) (>= (- s4 s1) 7)))
+(assert (<= (+ s3 4) T))
+(assert (<= (+ s4 2) T))
+(assert (or (>= s3 5) (>= s4 5)))
+; s2 >= 3 follows from the row of s2 - s1 once s1 >= 0 is asserted
+(assert (or (>= s2 3) (>= T 100)))
+(check-sat)
+(push 1)
+(assert (<= T 8))
+(check-sat)
+(pop 1)
+(assert (<= T 9))
+(check-sat)
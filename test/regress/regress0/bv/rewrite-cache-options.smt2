@@ -0,0 +1,30 @@
+; REQUIRES: statistics
+; COMMAND-LINE: --rewrite-cache-file=/tmp/cvc4-regress-rewrite-cache-options.cache --stats
+; ERROR-SCRUBBER: sed -n -e 's/.*PersistentRewriteCache::hits, [1-9][0-9]*$/rewrite cache hit/p' -e '/^rewrite cache hit$/q'
+; EXPECT-ERROR: rewrite cache hit
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: unsat
+; The first engine writes the cache without --bv-div-zero-const, the
+; second must not replay its rewrite of division by zero, and the third,
+; with the options of the second, loads the cache the second wrote and
+; reuses its entries.  The cache lives outside the source tree, and
+; whatever an earlier run left in it is dropped by the first two engines,
+; whose options differ.
+(set-option :bv-div-zero-const false)
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(assert (not (= (bvudiv x (_ bv0 8)) (_ bv255 8))))
+(check-sat)
+(reset)
+(set-option :bv-div-zero-const true)
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(assert (not (= (bvudiv x (_ bv0 8)) (_ bv255 8))))
+(check-sat)
+(reset)
+(set-option :bv-div-zero-const true)
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 8))
+(assert (not (= (bvudiv x (_ bv0 8)) (_ bv255 8))))
+(check-sat)
@@ -0,0 +1,23 @@
+; REQUIRES: portfolio
+; COMMAND-LINE: --threads=2 --cube-and-conquer
+; COMMAND-LINE: --threads=2 --cube-and-conquer --cube-depth=1 --cube-budget=1
+; COMMAND-LINE: --threads=2 --cube-and-conquer --cube-budget=1 --rlimit-per=100000000
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+(set-logic QF_LIA)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(assert (or (> x 5) (< x 0)))
+(assert (or (> y 3) (< y (- 2))))
+(assert (or (= z (+ x y)) (= z (- x y))))
+(assert (or (> z 10) (< z (- 10))))
+(check-sat)
+(push 1)
+(assert (< x 6))
+(assert (> x (- 1)))
+(check-sat)
+(pop 1)
+(assert (< y 0))
+(check-sat)
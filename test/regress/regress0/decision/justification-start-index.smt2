@@ -0,0 +1,117 @@
+; COMMAND-LINE: --decision=justification
+; COMMAND-LINE: --decision=justification --no-unconstrained
+; COMMAND-LINE: --decision=justification-stoponly
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; Deep and/or/ite structure, solved incrementally so that the start
+; indices of the justification heuristic are restored on pop
+(set-option :incremental true)
+(set-logic QF_LIA)
+(declare-fun a () Bool)
+(declare-fun b () Bool)
+(declare-fun c () Bool)
+(declare-fun d () Bool)
+(declare-fun e () Bool)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun p0 () Bool)
+(declare-fun p1 () Bool)
+(declare-fun p2 () Bool)
+(declare-fun p3 () Bool)
+(declare-fun p4 () Bool)
+(declare-fun p5 () Bool)
+(declare-fun p6 () Bool)
+(declare-fun p7 () Bool)
+(declare-fun p8 () Bool)
+(declare-fun p9 () Bool)
+(declare-fun p10 () Bool)
+(declare-fun p11 () Bool)
+(declare-fun p12 () Bool)
+(declare-fun p13 () Bool)
+(declare-fun p14 () Bool)
+(declare-fun p15 () Bool)
+(declare-fun p16 () Bool)
+(declare-fun p17 () Bool)
+(declare-fun p18 () Bool)
+(declare-fun p19 () Bool)
+(declare-fun p20 () Bool)
+(declare-fun p21 () Bool)
+(declare-fun p22 () Bool)
+(declare-fun p23 () Bool)
+(declare-fun p24 () Bool)
+(declare-fun p25 () Bool)
+(declare-fun p26 () Bool)
+(declare-fun p27 () Bool)
+(declare-fun p28 () Bool)
+(declare-fun p29 () Bool)
+(declare-fun p30 () Bool)
+(declare-fun p31 () Bool)
+(declare-fun p32 () Bool)
+(declare-fun p33 () Bool)
+(declare-fun p34 () Bool)
+(declare-fun p35 () Bool)
+(declare-fun p36 () Bool)
+(declare-fun p37 () Bool)
+(declare-fun p38 () Bool)
+(declare-fun p39 () Bool)
+(assert (or (and a (> x 3)) (and b (< x 0)) (and c (= x 1)) (and d (= (ite e x y) 7))))
+(assert (and (or a b c d) (or (not a) (> y x)) (or (not b) (< y x)) (= (ite a x (ite b y (ite c (+ x y) 5))) 5)))
+(check-sat)
+(push 1)
+(assert (not a))
+(assert (not c))
+(assert (not d))
+(check-sat)
+(pop 1)
+(assert (not a))
+(assert (not b))
+(check-sat)
+(push 1)
+(assert (not c))
+(assert (not d))
+(check-sat)
+(pop 1)
+(assert (or (and p0 (> x 0)) (and p1 (> x 1)) (and p2 (> x 2)) (and p3 (> x 3)) (and p4 (> x 4)) (and p5 (> x 5)) (and p6 (> x 6)) (and p7 (> x 7)) (and p8 (> x 8)) (and p9 (> x 9)) (and p10 (> x 10)) (and p11 (> x 11)) (and p12 (> x 12)) (and p13 (> x 13)) (and p14 (> x 14)) (and p15 (> x 15)) (and p16 (> x 16)) (and p17 (> x 17)) (and p18 (> x 18)) (and p19 (> x 19)) (and p20 (> x 20)) (and p21 (> x 21)) (and p22 (> x 22)) (and p23 (> x 23)) (and p24 (> x 24)) (and p25 (> x 25)) (and p26 (> x 26)) (and p27 (> x 27)) (and p28 (> x 28)) (and p29 (> x 29)) (and p30 (> x 30)) (and p31 (> x 31)) (and p32 (> x 32)) (and p33 (> x 33)) (and p34 (> x 34)) (and p35 (> x 35)) (and p36 (> x 36)) (and p37 (> x 37)) (and p38 (> x 38)) (and p39 (> x 39))))
+(assert (not p0))
+(assert (not p1))
+(assert (not p2))
+(assert (not p3))
+(assert (not p4))
+(assert (not p5))
+(assert (not p6))
+(assert (not p7))
+(assert (not p8))
+(assert (not p9))
+(assert (not p10))
+(assert (not p11))
+(assert (not p12))
+(assert (not p13))
+(assert (not p14))
+(assert (not p15))
+(assert (not p16))
+(assert (not p17))
+(assert (not p18))
+(assert (not p19))
+(assert (not p20))
+(assert (not p21))
+(assert (not p22))
+(assert (not p23))
+(assert (not p24))
+(assert (not p25))
+(assert (not p26))
+(assert (not p27))
+(assert (not p28))
+(assert (not p29))
+(assert (not p30))
+(assert (not p31))
+(assert (not p32))
+(assert (not p33))
+(assert (not p34))
+(assert (not p35))
+(assert (not p36))
+(assert (not p37))
+(assert (not p38))
+(check-sat)
@@ -0,0 +1,38 @@
+; COMMAND-LINE: --incremental --chrono-backtrack=0
+; COMMAND-LINE: --incremental --chrono-backtrack=2
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; Chronological backtracking across user levels: the unsat answer under
+; the push must not leave assignments behind for the checks after the pop
+(set-logic QF_UFLIA)
+(declare-fun f (Int) Int)
+(declare-fun p1 () Int)
+(declare-fun p2 () Int)
+(declare-fun p3 () Int)
+(declare-fun p4 () Int)
+(declare-fun p5 () Int)
+(declare-fun p6 () Int)
+(assert (and (<= 1 p1) (<= p1 5)))
+(assert (and (<= 1 p2) (<= p2 5)))
+(assert (and (<= 1 p3) (<= p3 5)))
+(assert (and (<= 1 p4) (<= p4 5)))
+(assert (and (<= 1 p5) (<= p5 5)))
+(assert (and (<= 1 p6) (<= p6 5)))
+(assert (distinct (f p1) (f p2) (f p3) (f p4) (f p5)))
+(check-sat)
+(push 1)
+(assert (distinct (f p1) (f p2) (f p3) (f p4) (f p5) (f p6)))
+(assert (= (f p1) p1))
+(assert (= (f p2) p2))
+(assert (= (f p3) p3))
+(assert (= (f p4) p4))
+(assert (= (f p5) p5))
+(assert (= (f p6) p6))
+(check-sat)
+(pop 1)
+(assert (= (+ p1 p2) 9))
+(check-sat)
+(assert (> p3 (+ p1 1)))
+(check-sat)
@@ -0,0 +1,39 @@
+; COMMAND-LINE: --incremental --cnf-polarity
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: unsat
+; (and p q) is first translated with its positive half only.  Later
+; assertions reach it again negatively, and as the condition of a term
+; ITE, which needs both halves: the missing clauses must be added then,
+; at the level of the assertion that needs them
+(set-logic QF_UF)
+(declare-sort U 0)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+(declare-fun p () Bool)
+(declare-fun q () Bool)
+(declare-fun r () Bool)
+(declare-fun s () Bool)
+(assert (or (and p q) r))
+(check-sat)
+(push 1)
+(assert (or (not (and p q)) s))
+(assert p)
+(assert q)
+(assert (not s))
+(check-sat)
+(pop 1)
+(assert p)
+(assert q)
+(assert (or (not (and p q)) s))
+(check-sat)
+(push 1)
+(assert (= a (ite (and p q) b c)))
+(assert (not (= a b)))
+(check-sat)
+(pop 1)
+(assert (not s))
+(check-sat)
@@ -0,0 +1,37 @@
+; COMMAND-LINE: --incremental --cnf-reuse
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; Kept translations across nested user levels: the variables freed by the
+; inner pop come up again in the outer one and must not be handed out twice
+(set-logic QF_UF)
+(declare-fun a () Bool)
+(declare-fun b () Bool)
+(declare-fun c () Bool)
+(declare-fun d () Bool)
+(declare-fun e () Bool)
+(assert (or a b))
+(check-sat)
+(push 1)
+(assert (and (or (not a) c) (or (not b) c)))
+(push 1)
+(assert (xor c d))
+(assert (or d (and e (not c))))
+(check-sat)
+(pop 1)
+(assert (= d (not e)))
+(check-sat)
+(push 1)
+(assert (xor c d))
+(assert (not e))
+(check-sat)
+(pop 1)
+(pop 1)
+(assert (not c))
+(assert (xor c d))
+(check-sat)
+(assert (and (not a) (not b)))
+(check-sat)
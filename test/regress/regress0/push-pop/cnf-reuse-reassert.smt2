@@ -0,0 +1,45 @@
+; COMMAND-LINE: --incremental --cnf-reuse
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: sat
+; EXPECT: unsat
+; The same formula asserted again after each pop, at the same level and
+; at other ones, reuses its kept translation
+(set-logic QF_LIA)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(assert (and (<= 0 x) (<= x 10) (<= 0 y) (<= y 10)))
+(push 1)
+(assert (or (and (> x 5) (< y 3)) (and (< x 2) (> y 8))))
+(assert (= (+ x y) 20))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (or (and (> x 5) (< y 3)) (and (< x 2) (> y 8))))
+(assert (= (+ x y) 9))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (or (and (> x 5) (< y 3)) (and (< x 2) (> y 8))))
+(push 1)
+(assert (= (+ x y) 20))
+(check-sat)
+(pop 1)
+(assert (= (+ x y) 10))
+(check-sat)
+(push 1)
+(assert (= (+ x y) 20))
+(check-sat)
+(pop 1)
+(pop 1)
+(assert (or (and (> x 5) (< y 3)) (and (< x 2) (> y 8))))
+(assert (> y 8))
+(check-sat)
+(assert (> x 0))
+(check-sat)
+(assert (> x 1))
+(check-sat)
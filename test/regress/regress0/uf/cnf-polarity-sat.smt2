@@ -0,0 +1,19 @@
+; COMMAND-LINE: --cnf-polarity
+; EXPECT: sat
+; Subformulas under OR, NOT and the antecedent of => are only defined in
+; the polarities they occur in
+(set-logic QF_UF)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+(declare-fun p () Bool)
+(declare-fun q () Bool)
+(declare-fun r () Bool)
+(declare-fun s () Bool)
+(assert (or (and p (= a b)) (and q (= b c))))
+(assert (or (not (and p q)) (= (f a) (f c))))
+(assert (=> (or r s) (not (= a c))))
+(assert (or r (and (not p) s)))
+(check-sat)
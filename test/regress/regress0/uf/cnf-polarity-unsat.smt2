@@ -0,0 +1,20 @@
+; COMMAND-LINE: --cnf-polarity
+; EXPECT: unsat
+; (and p (= a b)) occurs under an OR in both polarities: the second
+; occurrence needs the half of the definition the first one left out
+(set-logic QF_UF)
+(declare-sort U 0)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+(declare-fun p () Bool)
+(declare-fun q () Bool)
+(declare-fun r () Bool)
+(declare-fun s () Bool)
+(assert (or (and p (= a b)) (and q (= b c))))
+(assert (or s (not (and p (= a b)))))
+(assert (not s))
+(assert (=> q (= a c)))
+(assert (or s (not (and (= a c) r))))
+(assert r)
+(check-sat)
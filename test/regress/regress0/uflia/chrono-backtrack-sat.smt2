@@ -0,0 +1,18 @@
+; COMMAND-LINE: --chrono-backtrack=0
+; COMMAND-LINE: --chrono-backtrack=2
+; EXPECT: sat
+; Satisfiable permutation problem whose disequalities the arithmetic
+; solver splits on, solved with chronological backtracking
+(set-logic QF_UFLIA)
+(declare-fun h (Int) Int)
+(assert (and (<= 1 (h 1)) (<= (h 1) 6)))
+(assert (and (<= 1 (h 2)) (<= (h 2) 6)))
+(assert (and (<= 1 (h 3)) (<= (h 3) 6)))
+(assert (and (<= 1 (h 4)) (<= (h 4) 6)))
+(assert (and (<= 1 (h 5)) (<= (h 5) 6)))
+(assert (and (<= 1 (h 6)) (<= (h 6) 6)))
+(assert (distinct (h 1) (h 2) (h 3) (h 4) (h 5) (h 6)))
+(assert (= (+ (h 1) (h 2)) (h 3)))
+(assert (> (h 4) (+ (h 5) 2)))
+(assert (or (< (h 6) (h 1)) (> (h 6) (h 4)) (= (h 6) 5)))
+(check-sat)
@@ -0,0 +1,13 @@
+; REQUIRES: cadical
+; COMMAND-LINE: --dpll-cadical --rlimit=100000
+; COMMAND-LINE: --dpll-cadical --rlimit-per=100000
+; COMMAND-LINE: --dpll-cadical --incremental
+; SCRUBBER: sed -n -e 's/.*CaDiCaL as the DPLL(T) solver does not support.*/not supported/p'
+; EXPECT: not supported
+; EXIT: 1
+; Resource limits and incremental mode are rejected before solving, not
+; left to abort in the middle of a search
+(set-logic QF_UFLIA)
+(declare-fun h (Int) Int)
+(assert (distinct (h 1) (h 2)))
+(check-sat)
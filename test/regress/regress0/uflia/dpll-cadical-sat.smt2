@@ -0,0 +1,18 @@
+; REQUIRES: cadical
+; COMMAND-LINE: --dpll-cadical
+; EXPECT: sat
+; Four pigeons in four holes, with the holes of two of them tied together
+; through an uninterpreted function: each propositional model CaDiCaL
+; finds is refined by theory lemmas until one holds in the theories
+(set-logic QF_UFLIA)
+(declare-fun h (Int) Int)
+(declare-fun g (Int) Int)
+(assert (and (<= 1 (h 1)) (<= (h 1) 4)))
+(assert (and (<= 1 (h 2)) (<= (h 2) 4)))
+(assert (and (<= 1 (h 3)) (<= (h 3) 4)))
+(assert (and (<= 1 (h 4)) (<= (h 4) 4)))
+(assert (distinct (h 1) (h 2) (h 3) (h 4)))
+(assert (or (= (g (h 1)) (h 3)) (= (g (h 2)) (h 3))))
+(assert (= (g (h 1)) (+ (h 1) 1)))
+(assert (= (g (h 2)) (+ (h 2) 2)))
+(check-sat)
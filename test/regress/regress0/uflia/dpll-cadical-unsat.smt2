@@ -0,0 +1,14 @@
+; REQUIRES: cadical
+; COMMAND-LINE: --dpll-cadical --no-check-proofs --no-check-unsat-cores
+; EXPECT: unsat
+; Five pigeons in four holes: CaDiCaL's models are refuted one theory
+; conflict at a time until the clauses alone are unsatisfiable
+(set-logic QF_UFLIA)
+(declare-fun h (Int) Int)
+(assert (and (<= 1 (h 1)) (<= (h 1) 4)))
+(assert (and (<= 1 (h 2)) (<= (h 2) 4)))
+(assert (and (<= 1 (h 3)) (<= (h 3) 4)))
+(assert (and (<= 1 (h 4)) (<= (h 4) 4)))
+(assert (and (<= 1 (h 5)) (<= (h 5) 4)))
+(assert (distinct (h 1) (h 2) (h 3) (h 4) (h 5)))
+(check-sat)
@@ -0,0 +1,14 @@
+; COMMAND-LINE: --sat-inprocess --no-check-proofs --no-check-unsat-cores
+; COMMAND-LINE: --sat-inprocess --sat-inprocess-interval=1 --restart-int-base=2 --no-check-proofs --no-check-unsat-cores
+; EXPECT: unsat
+; Five pigeons in four holes, with an inprocessing round after almost
+; every restart
+(set-logic QF_UFLIA)
+(declare-fun h (Int) Int)
+(assert (and (<= 1 (h 1)) (<= (h 1) 4)))
+(assert (and (<= 1 (h 2)) (<= (h 2) 4)))
+(assert (and (<= 1 (h 3)) (<= (h 3) 4)))
+(assert (and (<= 1 (h 4)) (<= (h 4) 4)))
+(assert (and (<= 1 (h 5)) (<= (h 5) 4)))
+(assert (distinct (h 1) (h 2) (h 3) (h 4) (h 5)))
+(check-sat)
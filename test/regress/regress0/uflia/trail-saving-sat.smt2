@@ -0,0 +1,17 @@
+; COMMAND-LINE: --trail-saving
+; COMMAND-LINE: --trail-saving --restart-int-base=1
+; EXPECT: sat
+; Satisfiable permutation problem solved with trail saving
+(set-logic QF_UFLIA)
+(declare-fun h (Int) Int)
+(assert (and (<= 1 (h 1)) (<= (h 1) 6)))
+(assert (and (<= 1 (h 2)) (<= (h 2) 6)))
+(assert (and (<= 1 (h 3)) (<= (h 3) 6)))
+(assert (and (<= 1 (h 4)) (<= (h 4) 6)))
+(assert (and (<= 1 (h 5)) (<= (h 5) 6)))
+(assert (and (<= 1 (h 6)) (<= (h 6) 6)))
+(assert (distinct (h 1) (h 2) (h 3) (h 4) (h 5) (h 6)))
+(assert (= (+ (h 1) (h 2)) (h 3)))
+(assert (> (h 4) (+ (h 5) 2)))
+(assert (or (< (h 6) (h 1)) (> (h 6) (h 4)) (= (h 6) 5)))
+(check-sat)
@@ -0,0 +1,15 @@
+; COMMAND-LINE: --trail-saving --no-check-proofs --no-check-unsat-cores
+; COMMAND-LINE: --trail-saving --restart-int-base=1 --no-check-proofs --no-check-unsat-cores
+; EXPECT: unsat
+; Five pigeons in four holes: the theory lemmas splitting the
+; disequalities arrive between backjumps, and with --restart-int-base=1
+; restarts come often, both while assignments are saved
+(set-logic QF_UFLIA)
+(declare-fun h (Int) Int)
+(assert (and (<= 1 (h 1)) (<= (h 1) 4)))
+(assert (and (<= 1 (h 2)) (<= (h 2) 4)))
+(assert (and (<= 1 (h 3)) (<= (h 3) 4)))
+(assert (and (<= 1 (h 4)) (<= (h 4) 4)))
+(assert (and (<= 1 (h 5)) (<= (h 5) 4)))
+(assert (distinct (h 1) (h 2) (h 3) (h 4) (h 5)))
+(check-sat)
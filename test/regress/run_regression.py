@@ -71,6 +71,10 @@ def get_cvc4_features(cvc4_binary):
             if value == 'yes':
                 features.append(key)
 
+    # Thread options are only accepted by the portfolio binary
+    if cvc4_binary.endswith('pcvc4'):
+        features.append('portfolio')
+
     return features
 
 
@@ -49,6 +49,78 @@ public:
     TS_ASSERT_EQUALS(n.getId(), m.getId());
   }
 
+  void testPoolHashConsing() {
+    TypeNode boolType = d_nm->booleanType();
+    std::vector<Node> vars;
+    for(unsigned i = 0; i < 64; ++i) {
+      vars.push_back(d_nm->mkSkolem("b", boolType));
+    }
+    size_t before = d_nm->poolSize();
+    std::vector<Node> ands;
+    for(unsigned i = 0; i + 1 < vars.size(); ++i) {
+      ands.push_back(d_nm->mkNode(kind::AND, vars[i], vars[i + 1]));
+    }
+    TS_ASSERT_EQUALS(d_nm->poolSize(), before + ands.size());
+    for(unsigned i = 0; i + 1 < vars.size(); ++i) {
+      Node n = d_nm->mkNode(kind::AND, vars[i], vars[i + 1]);
+      TS_ASSERT_EQUALS(n.getId(), ands[i].getId());
+    }
+    TS_ASSERT_EQUALS(d_nm->poolSize(), before + ands.size());
+  }
+
+  void testPoolInsertLosesRace() {
+    TypeNode boolType = d_nm->booleanType();
+    Node a = d_nm->mkSkolem("a", boolType);
+    Node b = d_nm->mkSkolem("b", boolType);
+    Node winner = d_nm->mkNode(kind::AND, a, b);
+    size_t before = d_nm->poolSize();
+    unsigned rcA = a.d_nv->getRefCount();
+
+    // An equal NodeValue, as built by a thread whose poolLookup()
+    // missed before winner was pooled
+    NodeValue* loser = d_nm->allocateNodeValue(2);
+    loser->d_nchildren = 2;
+    loser->d_kind = kind::AND;
+    loser->d_id = d_nm->next_id++;
+    loser->d_rc = 0;
+    loser->d_children[0] = a.d_nv;
+    loser->d_children[1] = b.d_nv;
+    a.d_nv->inc();
+    b.d_nv->inc();
+
+    TS_ASSERT_EQUALS(d_nm->poolInsert(loser), winner.d_nv);
+    TS_ASSERT_EQUALS(d_nm->poolSize(), before);
+    TS_ASSERT_EQUALS(a.d_nv->getRefCount(), rcA);
+  }
+
+  void testIncrementalZombieReclamation() {
+    const size_t budget = 100;
+    d_nm->d_gcIncrementalBudget = budget;
+
+    // each of these constants dies as soon as it is built; past 5000
+    // zombies every new one triggers a pass of at most budget frees
+    for(unsigned i = 0; i < 6000; ++i) {
+      d_nm->mkConst(Rational(i + 1000000));
+    }
+    TS_ASSERT(d_nm->d_zombies.size() <= 5001);
+    TS_ASSERT(d_nm->d_zombies.size() > 5001 - budget);
+
+    // the safe-point hook frees the rest a batch at a time
+    unsigned passes = 0;
+    while(!d_nm->d_zombies.empty()) {
+      size_t before = d_nm->d_zombies.size();
+      d_nm->reclaimZombiesIncrementally();
+      size_t after = d_nm->d_zombies.size();
+      if(after >= before) {
+        TS_FAIL("an incremental pass freed nothing");
+        break;
+      }
+      TS_ASSERT(before - after <= budget);
+      ++passes;
+    }
+    TS_ASSERT(passes >= 5000 / budget);
+  }
+
   void testOversizedNodeBuilder() {
     NodeBuilder<> nb;
 
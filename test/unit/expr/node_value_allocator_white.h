@@ -0,0 +1,119 @@
+/*********************                                                        */
+/*! \file node_value_allocator_white.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of CVC4::expr::NodeValueAllocator.
+ **
+ ** White box testing of CVC4::expr::NodeValueAllocator.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "expr/node_value_allocator.h"
+#include "util/statistics_registry.h"
+
+using namespace CVC4;
+using namespace CVC4::expr;
+using namespace std;
+
+class NodeValueAllocatorWhite : public CxxTest::TestSuite {
+
+  StatisticsRegistry* d_registry;
+  NodeValueAllocator* d_allocator;
+
+public:
+
+  void setUp() {
+    d_registry = new StatisticsRegistry();
+    d_allocator = new NodeValueAllocator(d_registry);
+  }
+
+  void tearDown() {
+    delete d_allocator;
+    delete d_registry;
+  }
+
+  void testEverySizeClass() {
+    const size_t granule = NodeValueAllocator::GRANULE;
+    vector<unsigned char*> blocks;
+    vector<size_t> sizes;
+    for(size_t size = 1; size <= NodeValueAllocator::MAX_SMALL_SIZE; size += 3) {
+      unsigned char* p = static_cast<unsigned char*>(d_allocator->allocate(size));
+      TS_ASSERT_EQUALS(reinterpret_cast<uintptr_t>(p) % granule, 0u);
+      memset(p, int(size & 0xff), size);
+      blocks.push_back(p);
+      sizes.push_back(size);
+    }
+    // no block was handed out twice or overlaps another
+    for(size_t i = 0; i < blocks.size(); ++i) {
+      for(size_t j = 0; j < sizes[i]; ++j) {
+        TS_ASSERT_EQUALS(blocks[i][j], (unsigned char)(sizes[i] & 0xff));
+      }
+    }
+    TS_ASSERT_EQUALS(d_allocator->d_statistics.d_smallAllocations.getData(),
+                     (int64_t)blocks.size());
+    TS_ASSERT_EQUALS(d_allocator->d_statistics.d_largeAllocations.getData(), 0);
+    for(size_t i = 0; i < blocks.size(); ++i) {
+      d_allocator->deallocate(blocks[i], sizes[i]);
+    }
+  }
+
+  void testReuseAfterFree() {
+    void* a = d_allocator->allocate(40);
+    void* b = d_allocator->allocate(40);
+    void* c = d_allocator->allocate(64);
+    TS_ASSERT_DIFFERS(a, b);
+
+    // freed blocks come back from their own size class, last in first out
+    d_allocator->deallocate(a, 40);
+    d_allocator->deallocate(b, 40);
+    TS_ASSERT_EQUALS(d_allocator->allocate(33), b);
+    TS_ASSERT_EQUALS(d_allocator->allocate(40), a);
+    TS_ASSERT_EQUALS(d_allocator->d_statistics.d_freeListHits.getData(), 2);
+
+    // a different size class does not see them
+    d_allocator->deallocate(c, 64);
+    void* d = d_allocator->allocate(48);
+    TS_ASSERT_DIFFERS(d, c);
+    TS_ASSERT_EQUALS(d_allocator->allocate(64), c);
+    TS_ASSERT_EQUALS(d_allocator->d_statistics.d_freeListHits.getData(), 3);
+  }
+
+  void testLargeAndChunkBoundary() {
+    const size_t large = NodeValueAllocator::MAX_SMALL_SIZE + 1;
+    void* big = d_allocator->allocate(large);
+    memset(big, 0x5a, large);
+    TS_ASSERT_EQUALS(d_allocator->d_statistics.d_largeAllocations.getData(), 1);
+    d_allocator->deallocate(big, large);
+
+    // fill more than one chunk; the tail of the first goes to a free list
+    const size_t size = 200;
+    size_t n = 2 * NodeValueAllocator::CHUNK_SIZE / size;
+    vector<void*> blocks;
+    for(size_t i = 0; i < n; ++i) {
+      blocks.push_back(d_allocator->allocate(size));
+    }
+    TS_ASSERT_EQUALS(d_allocator->d_chunks.size(), 3u);
+    TS_ASSERT_EQUALS(d_allocator->d_statistics.d_chunkBytes.getData(),
+                     (int64_t)(3 * NodeValueAllocator::CHUNK_SIZE));
+    size_t tail = NodeValueAllocator::CHUNK_SIZE % size;
+    void* fromTail = d_allocator->allocate(tail);
+    TS_ASSERT_EQUALS(d_allocator->d_statistics.d_freeListHits.getData(), 1);
+    d_allocator->deallocate(fromTail, tail);
+    for(size_t i = 0; i < blocks.size(); ++i) {
+      d_allocator->deallocate(blocks[i], size);
+    }
+  }
+
+};/* class NodeValueAllocatorWhite */
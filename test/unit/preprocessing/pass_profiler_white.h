@@ -0,0 +1,245 @@
+/*********************                                                        */
+/*! \file pass_profiler_white.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of CVC4::preprocessing::PassProfiler.
+ **
+ ** White box testing of CVC4::preprocessing::PassProfiler and of the
+ ** read-only scan of an AssertionPipeline it is built on.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <cctype>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "expr/node.h"
+#include "expr/node_manager.h"
+#include "preprocessing/pass_profiler.h"
+#include "preprocessing/preprocessing_pass.h"
+#include "smt/smt_engine.h"
+#include "smt/smt_engine_scope.h"
+
+using namespace CVC4;
+using namespace CVC4::kind;
+using namespace CVC4::preprocessing;
+using namespace CVC4::smt;
+using namespace std;
+
+/* A recursive-descent check that s[i..] starts with one JSON value */
+static bool skipJsonValue(const string& s, size_t& i);
+
+static void skipSpace(const string& s, size_t& i) {
+  while(i < s.size() && isspace(s[i])) {
+    ++i;
+  }
+}
+
+static bool skipJsonString(const string& s, size_t& i) {
+  if(i >= s.size() || s[i] != '"') {
+    return false;
+  }
+  for(++i; i < s.size() && s[i] != '"'; ++i) {
+    if(s[i] == '\\') {
+      ++i;
+    }
+  }
+  return i++ < s.size();
+}
+
+static bool skipJsonSequence(const string& s, size_t& i, char close,
+                             bool members) {
+  ++i;
+  skipSpace(s, i);
+  if(i < s.size() && s[i] == close) {
+    ++i;
+    return true;
+  }
+  for(;;) {
+    skipSpace(s, i);
+    if(members) {
+      if(!skipJsonString(s, i)) {
+        return false;
+      }
+      skipSpace(s, i);
+      if(i >= s.size() || s[i++] != ':') {
+        return false;
+      }
+    }
+    if(!skipJsonValue(s, i)) {
+      return false;
+    }
+    skipSpace(s, i);
+    if(i >= s.size()) {
+      return false;
+    }
+    if(s[i] == close) {
+      ++i;
+      return true;
+    }
+    if(s[i++] != ',') {
+      return false;
+    }
+  }
+}
+
+static bool skipJsonValue(const string& s, size_t& i) {
+  skipSpace(s, i);
+  if(i >= s.size()) {
+    return false;
+  }
+  switch(s[i]) {
+    case '{': return skipJsonSequence(s, i, '}', true);
+    case '[': return skipJsonSequence(s, i, ']', false);
+    case '"': return skipJsonString(s, i);
+    default: {
+      size_t start = i;
+      while(i < s.size() && (isalnum(s[i]) || s[i] == '-' || s[i] == '+'
+                             || s[i] == '.')) {
+        ++i;
+      }
+      return i > start;
+    }
+  }
+}
+
+static bool isJson(const string& s) {
+  size_t i = 0;
+  if(!skipJsonValue(s, i)) {
+    return false;
+  }
+  skipSpace(s, i);
+  return i == s.size();
+}
+
+class PassProfilerWhite : public CxxTest::TestSuite {
+
+  ExprManager* d_em;
+  NodeManager* d_nm;
+  SmtEngine* d_smt;
+  SmtScope* d_scope;
+
+  /* (= (f x_i) (f x_i+1)) for i < n, sharing f, the x_i and the (f x_i) */
+  void mkChain(AssertionPipeline& assertions, unsigned n) {
+    TypeNode intType = d_nm->integerType();
+    Node f = d_nm->mkSkolem("f", d_nm->mkFunctionType(intType, intType));
+    Node prev = d_nm->mkNode(APPLY_UF, f, d_nm->mkSkolem("x", intType));
+    for(unsigned i = 0; i < n; ++i) {
+      Node next = d_nm->mkNode(APPLY_UF, f, d_nm->mkSkolem("x", intType));
+      assertions.push_back(d_nm->mkNode(EQUAL, prev, next));
+      prev = next;
+    }
+  }
+
+public:
+
+  void setUp() {
+    d_em = new ExprManager();
+    d_nm = NodeManager::fromExprManager(d_em);
+    d_smt = new SmtEngine(d_em);
+    d_scope = new SmtScope(d_smt);
+  }
+
+  void tearDown() {
+    delete d_scope;
+    delete d_smt;
+    delete d_em;
+  }
+
+  void testScanVisitsEachAssertionOnce() {
+    AssertionPipeline assertions;
+    mkChain(assertions, 1000);
+    const unsigned numWorkers = 4;
+    vector<size_t> visits(numWorkers, 0);
+    assertions.scanAssertions(
+        [&visits](unsigned w, TNode a) {
+          // no TS_ASSERT here, the workers run outside the test's thread
+          if(a.getKind() == EQUAL) {
+            ++visits[w];
+          }
+        },
+        numWorkers);
+    size_t total = 0;
+    for(unsigned w = 0; w < numWorkers; ++w) {
+      total += visits[w];
+    }
+    TS_ASSERT_EQUALS(total, assertions.size());
+  }
+
+  void testScanWorkersMayNotHoldNodes() {
+#if defined(CVC4_ASSERTIONS) && defined(CVC4_PORTFOLIO)
+    AssertionPipeline assertions;
+    mkChain(assertions, 100);
+    // a Node reference on a worker changes a reference count
+    TS_ASSERT_THROWS(assertions.scanAssertions(
+                         [](unsigned w, TNode a) { Node n = a; },
+                         4),
+                     AssertionException);
+    // the calling thread is not marked
+    TS_ASSERT_THROWS_NOTHING(Node n = assertions[0]);
+#endif /* CVC4_ASSERTIONS && CVC4_PORTFOLIO */
+  }
+
+  void testDagSize() {
+    AssertionPipeline assertions;
+    TS_ASSERT_EQUALS(PassProfiler::dagSize(assertions, 4), 0u);
+
+    // f, 101 x_i, 101 (f x_i) and 100 equalities
+    mkChain(assertions, 100);
+    TS_ASSERT_EQUALS(PassProfiler::dagSize(assertions, 1), 303u);
+    TS_ASSERT_EQUALS(PassProfiler::dagSize(assertions, 4), 303u);
+    TS_ASSERT_EQUALS(PassProfiler::dagSize(assertions, 1000), 303u);
+  }
+
+  void testReportIsWellFormed() {
+    PassProfiler profiler("", 2);
+    stringstream empty;
+    profiler.writeReport(empty);
+    TS_ASSERT(isJson(empty.str()));
+
+    AssertionPipeline assertions;
+    mkChain(assertions, 10);
+    {
+      PassProfiler::Scope scope(&profiler, "first", assertions);
+      assertions[0] = d_nm->mkConst(true);
+    }
+    {
+      PassProfiler::Scope scope(&profiler, "second", assertions);
+    }
+    {
+      PassProfiler::Scope scope(&profiler, "first", assertions);
+      assertions.push_back(d_nm->mkConst(false));
+    }
+    // a null profiler records nothing
+    {
+      PassProfiler::Scope scope(nullptr, "third", assertions);
+    }
+
+    stringstream report;
+    profiler.writeReport(report);
+    string json = report.str();
+    TS_ASSERT(isJson(json));
+    TS_ASSERT(json.find("\"name\": \"first\", \"invocations\": 2")
+              != string::npos);
+    TS_ASSERT(json.find("\"name\": \"second\", \"invocations\": 1")
+              != string::npos);
+    TS_ASSERT(json.find("third") == string::npos);
+    TS_ASSERT(json.find("\"assertions-before\": 20, "
+                        "\"assertions-after\": 21")
+              != string::npos);
+    TS_ASSERT(json.find("\"assertions-changed\": 2}") != string::npos);
+    TS_ASSERT(json.find("\"assertions-changed\": 0}") != string::npos);
+    // passes are listed in the order they first ran
+    TS_ASSERT(json.find("first") < json.find("second"));
+  }
+
+};/* class PassProfilerWhite */
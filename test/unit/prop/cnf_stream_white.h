@@ -45,9 +45,21 @@ using namespace std;
 class FakeSatSolver : public SatSolver {
   SatVariable d_nextVar;
   bool d_addClauseCalled;
+  unsigned d_numClauses;
+  unsigned d_numRevived;
+  unsigned d_numRetained;
+  unsigned d_numDefinitions;
 
  public:
-  FakeSatSolver() : d_nextVar(0), d_addClauseCalled(false) {}
+  FakeSatSolver()
+      : d_nextVar(0),
+        d_addClauseCalled(false),
+        d_numClauses(0),
+        d_numRevived(0),
+        d_numRetained(0),
+        d_numDefinitions(0)
+  {
+  }
 
   SatVariable newVar(bool theoryAtom, bool preRegister, bool canErase) {
     return d_nextVar++;
@@ -59,9 +71,21 @@ class FakeSatSolver : public SatSolver {
 
   ClauseId addClause(SatClause& c, bool lemma) {
     d_addClauseCalled = true;
+    ++d_numClauses;
     return ClauseIdUndef;
   }
 
+  ClauseId addDefinitionClause(SatClause& c) {
+    ++d_numDefinitions;
+    return addClause(c, false);
+  }
+
+  void retainVar(SatVariable var) { ++d_numRetained; }
+
+  void reviveVar(SatVariable var, bool theoryAtom, bool preRegister) {
+    ++d_numRevived;
+  }
+
   ClauseId addXorClause(SatClause& clause, bool rhs, bool removable) {
     d_addClauseCalled = true;
     return ClauseIdUndef;
@@ -73,6 +97,16 @@ class FakeSatSolver : public SatSolver {
 
   unsigned int addClauseCalled() { return d_addClauseCalled; }
 
+  unsigned numClauses() const { return d_numClauses; }
+
+  unsigned numVars() const { return d_nextVar; }
+
+  unsigned numRevived() const { return d_numRevived; }
+
+  unsigned numRetained() const { return d_numRetained; }
+
+  unsigned numDefinitions() const { return d_numDefinitions; }
+
   unsigned getAssertionLevel() const { return 0; }
 
   bool isDecision(Node) const { return false; }
@@ -282,4 +316,116 @@ class CnfStreamWhite : public CxxTest::TestSuite {
     TS_ASSERT(d_satSolver->addClauseCalled());
     TS_ASSERT(d_cnfStream->hasLiteral(a_and_b));
   }
+
+  void testPolarityAware() {
+    NodeManagerScope nms(d_nodeManager);
+    Node a = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node b = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node c = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node d = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node a_and_b = d_nodeManager->mkNode(kind::AND, a, b);
+    Node c_and_d = d_nodeManager->mkNode(kind::AND, c, d);
+    Node formula = d_nodeManager->mkNode(kind::OR, a_and_b, c_and_d);
+
+    // Full Tseitin: three clauses per conjunction, plus the disjunction
+    d_cnfStream->convertAndAssert(formula, false, false, RULE_INVALID,
+                                  Node::null());
+    TS_ASSERT_EQUALS(d_satSolver->numClauses(), 7u);
+
+    FakeSatSolver satSolver;
+    Context context;
+    TseitinCnfStream cnfStream(&satSolver, d_cnfRegistrar, &context, false,
+                               "", true);
+    // The conjunctions only occur positively: l -> (a & b) is enough
+    cnfStream.convertAndAssert(formula, false, false, RULE_INVALID,
+                               Node::null());
+    TS_ASSERT_EQUALS(satSolver.numClauses(), 5u);
+    // Asking for the literal adds the other half of its definition
+    cnfStream.ensureLiteral(a_and_b);
+    TS_ASSERT_EQUALS(satSolver.numClauses(), 6u);
+    cnfStream.ensureLiteral(a_and_b);
+    TS_ASSERT_EQUALS(satSolver.numClauses(), 6u);
+    // Asserting the negation needs (a & b) -> l, which is already there
+    cnfStream.convertAndAssert(d_nodeManager->mkNode(kind::OR, a_and_b.notNode(),
+                                                     c_and_d.notNode()),
+                               false, false, RULE_INVALID, Node::null());
+    TS_ASSERT_EQUALS(satSolver.numClauses(), 8u);
+  }
+
+  void testReuse() {
+    NodeManagerScope nms(d_nodeManager);
+    Node a = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node b = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node c = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node d = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node a_and_b = d_nodeManager->mkNode(kind::AND, a, b);
+    Node c_and_d = d_nodeManager->mkNode(kind::AND, c, d);
+    Node formula = d_nodeManager->mkNode(kind::OR, a_and_b, c_and_d);
+
+    FakeSatSolver satSolver;
+    Context context;
+    TseitinCnfStream cnfStream(&satSolver, d_cnfRegistrar, &context, false,
+                               "", false, true);
+    context.push();
+    cnfStream.convertAndAssert(formula, false, false, RULE_GIVEN,
+                               Node::null());
+    TS_ASSERT_EQUALS(satSolver.numClauses(), 7u);
+    // the variables and definitions of the conjunctions, but not the
+    // top-level clause
+    TS_ASSERT_EQUALS(satSolver.numRetained(), 6u);
+    TS_ASSERT_EQUALS(satSolver.numDefinitions(), 6u);
+    unsigned numVars = satSolver.numVars();
+    context.pop();
+    TS_ASSERT(!cnfStream.hasLiteral(a_and_b));
+
+    // Asserted again, only the top-level clause is new
+    context.push();
+    cnfStream.convertAndAssert(formula, false, false, RULE_GIVEN,
+                               Node::null());
+    TS_ASSERT_EQUALS(satSolver.numClauses(), 8u);
+    TS_ASSERT_EQUALS(satSolver.numVars(), numVars);
+    TS_ASSERT_EQUALS(satSolver.numRevived(), 6u);
+    TS_ASSERT(cnfStream.hasLiteral(a_and_b));
+    context.pop();
+
+    // A lemma translating the conjunction does not replace the kept one
+    context.push();
+    cnfStream.convertAndAssert(c_and_d.notNode(), false, false, RULE_INVALID,
+                               Node::null());
+    context.pop();
+    context.push();
+    cnfStream.convertAndAssert(formula, false, false, RULE_GIVEN,
+                               Node::null());
+    TS_ASSERT_EQUALS(satSolver.numRevived(), 12u);
+    TS_ASSERT_EQUALS(satSolver.numRetained(), 6u);
+    TS_ASSERT_EQUALS(satSolver.numDefinitions(), 6u);
+    context.pop();
+  }
+
+  void testReuseOnlyKeepsRetained() {
+    NodeManagerScope nms(d_nodeManager);
+    Node a = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node b = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node c = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node d = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node a_and_b = d_nodeManager->mkNode(kind::AND, a, b);
+    Node a_and_c = d_nodeManager->mkNode(kind::AND, a, c);
+
+    FakeSatSolver satSolver;
+    Context context;
+    TseitinCnfStream cnfStream(&satSolver, d_cnfRegistrar, &context, false,
+                               "", false, true);
+    context.push();
+    // a gets its literal from a lemma, so it is not kept
+    cnfStream.convertAndAssert(a_and_b.notNode(), false, false, RULE_INVALID,
+                               Node::null());
+    TS_ASSERT_EQUALS(satSolver.numRetained(), 0u);
+
+    // Nor is a conjunction over it, whose definition stays at this level
+    cnfStream.convertAndAssert(d_nodeManager->mkNode(kind::OR, a_and_c, d),
+                               false, false, RULE_GIVEN, Node::null());
+    TS_ASSERT_EQUALS(satSolver.numRetained(), 2u);
+    TS_ASSERT_EQUALS(satSolver.numDefinitions(), 0u);
+    context.pop();
+  }
 };
@@ -0,0 +1,159 @@
+/*********************                                                        */
+/*! \file minisat_reduce_db_white.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of the tiered clause reduction of Minisat.
+ **
+ ** White box testing of Minisat::Solver::reduceDBTiered(): which learnt
+ ** clauses each tier keeps, and that the used and protect marks only
+ ** last until the next reduction.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <set>
+
+#include "context/context.h"
+#include "prop/minisat/core/Solver.h"
+#include "smt/smt_engine.h"
+#include "smt/smt_engine_scope.h"
+
+using namespace CVC4;
+using namespace CVC4::context;
+using namespace CVC4::smt;
+using namespace std;
+
+class MinisatReduceDBWhite : public CxxTest::TestSuite {
+
+  ExprManager* d_em;
+  SmtEngine* d_smt;
+  SmtScope* d_scope;
+  Context* d_context;
+  Minisat::Solver* d_solver;
+
+  /*
+   * Adds a removable clause of the given size and LBD whose first literal
+   * is a fresh variable, which names the clause; returns that variable
+   */
+  Minisat::Var addClause(int size, unsigned lbd) {
+    Minisat::vec<Minisat::Lit> lits;
+    Minisat::Var tag = d_solver->newVar();
+    lits.push(Minisat::mkLit(tag));
+    for(int i = 1; i < size; ++i) {
+      lits.push(Minisat::mkLit(d_solver->newVar()));
+    }
+    Minisat::CRef cr = d_solver->ca.alloc(0, lits, true);
+    d_solver->ca[cr].lbd(lbd);
+    d_solver->clauses_removable.push(cr);
+    d_solver->attachClause(cr);
+    return tag;
+  }
+
+  Minisat::Clause& clauseOf(Minisat::Var tag) {
+    for(int i = 0; i < d_solver->clauses_removable.size(); ++i) {
+      Minisat::Clause& c = d_solver->ca[d_solver->clauses_removable[i]];
+      if(Minisat::var(c[0]) == tag) {
+        return c;
+      }
+    }
+    TS_FAIL("no clause with that tag");
+    return d_solver->ca[d_solver->clauses_removable[0]];
+  }
+
+  /* The tags of the clauses that are still there */
+  set<Minisat::Var> kept() {
+    set<Minisat::Var> tags;
+    for(int i = 0; i < d_solver->clauses_removable.size(); ++i) {
+      tags.insert(Minisat::var(d_solver->ca[d_solver->clauses_removable[i]][0]));
+    }
+    return tags;
+  }
+
+public:
+
+  void setUp() {
+    d_em = new ExprManager();
+    d_smt = new SmtEngine(d_em);
+    d_scope = new SmtScope(d_smt);
+    d_context = new Context();
+    d_solver = new Minisat::Solver(NULL, d_context, false);
+    d_solver->lbd_tiers = true;
+    d_solver->lbd_core = 2;
+    d_solver->lbd_tier2 = 6;
+  }
+
+  void tearDown() {
+    delete d_solver;
+    delete d_context;
+    delete d_scope;
+    delete d_smt;
+    delete d_em;
+  }
+
+  void testTiers() {
+    Minisat::Var binary = addClause(2, 2);
+    Minisat::Var core = addClause(5, 2);
+    Minisat::Var usedTier2 = addClause(5, 5);
+    Minisat::Var unusedTier2 = addClause(5, 5);
+    Minisat::Var protectedLocal = addClause(30, 20);
+    Minisat::Var local10 = addClause(12, 10);
+    Minisat::Var local12 = addClause(14, 12);
+    Minisat::Var local14 = addClause(16, 14);
+    clauseOf(usedTier2).used(true);
+    clauseOf(protectedLocal).protect(true);
+
+    // the unused tier-2 clause and the three local ones compete; the
+    // worse half by LBD goes
+    d_solver->reduceDBTiered();
+    set<Minisat::Var> first = kept();
+    TS_ASSERT_EQUALS(first.size(), 6u);
+    TS_ASSERT(first.count(binary));
+    TS_ASSERT(first.count(core));
+    TS_ASSERT(first.count(usedTier2));
+    TS_ASSERT(first.count(unusedTier2));
+    TS_ASSERT(first.count(protectedLocal));
+    TS_ASSERT(first.count(local10));
+    TS_ASSERT(!first.count(local12));
+    TS_ASSERT(!first.count(local14));
+    TS_ASSERT(!clauseOf(usedTier2).used());
+    TS_ASSERT(!clauseOf(protectedLocal).protect());
+
+    // without new conflicts, the used mark and the protection are spent
+    d_solver->reduceDBTiered();
+    set<Minisat::Var> second = kept();
+    TS_ASSERT_EQUALS(second.size(), 4u);
+    TS_ASSERT(second.count(binary));
+    TS_ASSERT(second.count(core));
+    TS_ASSERT(second.count(usedTier2));
+    TS_ASSERT(second.count(unusedTier2));
+  }
+
+  void testLockedClausesStay() {
+    Minisat::Var reason = addClause(10, 9);
+    Minisat::Var other = addClause(10, 8);
+
+    // make the worse clause the reason of its first literal
+    Minisat::Clause& c = clauseOf(reason);
+    Minisat::CRef cr = d_solver->clauses_removable[0];
+    d_solver->newDecisionLevel();
+    for(int i = 1; i < c.size(); ++i) {
+      d_solver->uncheckedEnqueue(~c[i]);
+    }
+    d_solver->uncheckedEnqueue(c[0], cr);
+    TS_ASSERT(d_solver->locked(c));
+
+    d_solver->reduceDBTiered();
+    set<Minisat::Var> tags = kept();
+    TS_ASSERT(tags.count(reason));
+    TS_ASSERT(tags.count(other));
+    d_solver->cancelUntil(0);
+  }
+
+};/* class MinisatReduceDBWhite */
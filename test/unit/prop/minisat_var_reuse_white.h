@@ -0,0 +1,166 @@
+/*********************                                                        */
+/*! \file minisat_var_reuse_white.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of the variable reuse of Minisat across user
+ ** pops.
+ **
+ ** White box testing of Minisat::Solver::pop() with kept variables
+ ** (--cnf-reuse): which variables are kept, which slots are freed, and
+ ** that nested pops never hand out a slot twice.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <set>
+
+#include "context/context.h"
+#include "prop/minisat/core/Solver.h"
+#include "smt/smt_engine.h"
+#include "smt/smt_engine_scope.h"
+
+using namespace CVC4;
+using namespace CVC4::context;
+using namespace CVC4::smt;
+using namespace std;
+
+class MinisatVarReuseWhite : public CxxTest::TestSuite {
+
+  ExprManager* d_em;
+  SmtEngine* d_smt;
+  SmtScope* d_scope;
+  Context* d_context;
+  Minisat::Solver* d_solver;
+
+  Minisat::Var newRetainedVar() {
+    Minisat::Var v = d_solver->newVar();
+    d_solver->retainVar(v);
+    return v;
+  }
+
+  /* Whether the free slots are all distinct and flagged as free */
+  bool freeVarsConsistent() {
+    set<Minisat::Var> slots;
+    for(int i = 0; i < d_solver->free_vars.size(); ++i) {
+      Minisat::Var v = d_solver->free_vars[i];
+      if(v >= d_solver->nVars() || !d_solver->freed[v]
+         || !slots.insert(v).second) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+public:
+
+  void setUp() {
+    d_em = new ExprManager();
+    d_smt = new SmtEngine(d_em);
+    d_scope = new SmtScope(d_smt);
+    d_context = new Context();
+    d_solver = new Minisat::Solver(NULL, d_context, true);
+    d_solver->retain_vars = true;
+  }
+
+  void tearDown() {
+    delete d_solver;
+    delete d_context;
+    delete d_scope;
+    delete d_smt;
+    delete d_em;
+  }
+
+  void testPopKeepsRetained() {
+    Minisat::Var a = d_solver->newVar();
+    d_solver->push();
+    Minisat::Var b = d_solver->newVar();
+    Minisat::Var kept = newRetainedVar();
+    Minisat::Var c = d_solver->newVar();
+    d_solver->pop();
+
+    // b sits below a kept variable and is freed, c is deleted
+    TS_ASSERT_EQUALS(d_solver->nVars(), kept + 1);
+    TS_ASSERT_EQUALS(d_solver->free_vars.size(), 1);
+    TS_ASSERT_EQUALS(d_solver->free_vars[0], b);
+    TS_ASSERT(!d_solver->decision[kept]);
+    TS_ASSERT(!d_solver->decision[b]);
+    TS_ASSERT(d_solver->decision[a]);
+    TS_ASSERT(freeVarsConsistent());
+
+    // the free slot goes first, then the solver grows again
+    TS_ASSERT_EQUALS(d_solver->newVar(), b);
+    TS_ASSERT_EQUALS(d_solver->newVar(), c);
+    TS_ASSERT_EQUALS(d_solver->free_vars.size(), 0);
+  }
+
+  void testNestedPopsFreeOnce() {
+    d_solver->push();
+    Minisat::Var b = d_solver->newVar();
+    d_solver->push();
+    Minisat::Var c = d_solver->newVar();
+    Minisat::Var kept = newRetainedVar();
+    d_solver->newVar();
+    d_solver->pop();
+    TS_ASSERT_EQUALS(d_solver->free_vars.size(), 1);
+    TS_ASSERT(freeVarsConsistent());
+
+    // c is free and above the outer level's start, so the outer pop comes
+    // across it again
+    d_solver->pop();
+    TS_ASSERT_EQUALS(d_solver->nVars(), kept + 1);
+    TS_ASSERT_EQUALS(d_solver->free_vars.size(), 2);
+    TS_ASSERT(freeVarsConsistent());
+    Minisat::Var first = d_solver->newVar();
+    Minisat::Var second = d_solver->newVar();
+    TS_ASSERT(first != second);
+    TS_ASSERT((first == b && second == c) || (first == c && second == b));
+  }
+
+  void testSlotReusedAtOuterLevel() {
+    d_solver->push();
+    d_solver->push();
+    Minisat::Var c = d_solver->newVar();
+    Minisat::Var kept = newRetainedVar();
+    d_solver->pop();
+
+    // c is reused at the outer level, where it is both a variable of that
+    // level and one of its reused slots
+    Minisat::Var reused = d_solver->newVar();
+    TS_ASSERT_EQUALS(reused, c);
+    Minisat::Var fresh = d_solver->newVar();
+    TS_ASSERT_EQUALS(fresh, kept + 1);
+    d_solver->pop();
+
+    TS_ASSERT_EQUALS(d_solver->nVars(), kept + 1);
+    TS_ASSERT_EQUALS(d_solver->free_vars.size(), 1);
+    TS_ASSERT(freeVarsConsistent());
+    TS_ASSERT_EQUALS(d_solver->newVar(), c);
+    TS_ASSERT_EQUALS(d_solver->newVar(), fresh);
+  }
+
+  void testReviveAfterPops() {
+    d_solver->push();
+    Minisat::Var kept = newRetainedVar();
+    d_solver->pop();
+    TS_ASSERT(!d_solver->decision[kept]);
+
+    // the kept variable comes back for a formula asserted again
+    d_solver->push();
+    d_solver->reviveVar(kept, false, false);
+    TS_ASSERT(d_solver->decision[kept]);
+    Minisat::Var other = d_solver->newVar();
+    d_solver->pop();
+    TS_ASSERT(!d_solver->decision[kept]);
+    TS_ASSERT_EQUALS(d_solver->nVars(), kept + 1);
+    TS_ASSERT(other > kept);
+    TS_ASSERT(freeVarsConsistent());
+  }
+
+};/* class MinisatVarReuseWhite */
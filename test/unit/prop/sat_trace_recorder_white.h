@@ -0,0 +1,258 @@
+/*********************                                                        */
+/*! \file sat_trace_recorder_white.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of CVC4::prop::SatTraceRecorder.
+ **
+ ** White box testing of CVC4::prop::SatTraceRecorder, on its own and
+ ** through the --sat-trace option.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "expr/expr_manager.h"
+#include "prop/sat_trace_recorder.h"
+#include "smt/smt_engine.h"
+#include "util/sexpr.h"
+
+using namespace CVC4;
+using namespace CVC4::prop;
+using namespace std;
+
+/*
+ * Whether the rest of the line is a list of nonzero DIMACS literals
+ * ended by 0
+ */
+static bool isLiteralList(istream& in) {
+  int lit;
+  while(in >> lit) {
+    if(lit == 0) {
+      string rest;
+      return !(in >> rest);
+    }
+  }
+  return false;
+}
+
+/*
+ * Whether trace is well-formed iCNF, as the recorder writes it: the
+ * header, then clauses, assumption lines and comments; counts the
+ * assumption lines, one per check-sat
+ */
+static bool isIcnf(const string& trace, unsigned& solves) {
+  istringstream lines(trace);
+  string line;
+  if(!getline(lines, line) || line != "p inccnf") {
+    return false;
+  }
+  solves = 0;
+  while(getline(lines, line)) {
+    istringstream in(line);
+    if(line.compare(0, 2, "c ") == 0) {
+      in.ignore(2);
+      string tag;
+      in >> tag;
+      if((tag == "l" && !isLiteralList(in)) || (tag == "d" && !(in >> tag))) {
+        return false;
+      }
+    } else if(line.compare(0, 2, "a ") == 0) {
+      in.ignore(2);
+      if(!isLiteralList(in)) {
+        return false;
+      }
+      ++solves;
+    } else if(!isLiteralList(in)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Whether the clauses are satisfiable under the assumptions, by brute force */
+static bool isSatisfiable(const vector<vector<int> >& clauses,
+                          const vector<int>& assumptions, int numVars) {
+  for(unsigned long m = 0; m < (1ul << numVars); ++m) {
+    // literal l is true if bit |l| - 1 of m matches its sign
+    auto isTrue = [m](int l) {
+      return (((m >> (abs(l) - 1)) & 1) != 0) == (l > 0);
+    };
+    bool sat = true;
+    for(int l : assumptions) {
+      sat = sat && isTrue(l);
+    }
+    for(unsigned i = 0; sat && i < clauses.size(); ++i) {
+      bool clauseSat = false;
+      for(int l : clauses[i]) {
+        clauseSat = clauseSat || isTrue(l);
+      }
+      sat = clauseSat;
+    }
+    if(sat) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Whether each query of a small trace (at most 20 variables) has the
+ * result the solver recorded for it
+ */
+static bool queriesMatchResults(const string& trace) {
+  istringstream lines(trace);
+  string line;
+  getline(lines, line);
+  vector<vector<int> > clauses;
+  int numVars = 0;
+  string result;
+  while(getline(lines, line)) {
+    istringstream in(line);
+    vector<int> lits;
+    if(line.compare(0, 4, "c s ") == 0) {
+      result = line.substr(4);
+      continue;
+    } else if(line.compare(0, 1, "c") == 0) {
+      continue;
+    } else if(line.compare(0, 2, "a ") == 0) {
+      in.ignore(2);
+    }
+    int lit;
+    while(in >> lit && lit != 0) {
+      lits.push_back(lit);
+      numVars = max(numVars, abs(lit));
+    }
+    if(line.compare(0, 2, "a ") != 0) {
+      clauses.push_back(lits);
+    } else if(numVars > 20) {
+      return false;
+    } else if(result != "unknown"
+              && isSatisfiable(clauses, lits, numVars) != (result == "sat")) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class SatTraceRecorderWhite : public CxxTest::TestSuite {
+
+  string d_filename;
+
+  string readTrace() {
+    ifstream in(d_filename.c_str());
+    stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+  }
+
+public:
+
+  void setUp() {
+    char* filename = strdup("/tmp/sattrace.XXXXXX");
+    int fd = mkstemp(filename);
+    TS_ASSERT(fd != -1);
+    close(fd);
+    d_filename = filename;
+    free(filename);
+  }
+
+  void tearDown() {
+    remove(d_filename.c_str());
+  }
+
+  void testEvents() {
+    {
+      SatTraceRecorder recorder(d_filename);
+      recorder.beginClause(false);
+      recorder.literal(0, false);
+      recorder.literal(1, true);
+      recorder.endClause(0);
+      recorder.decision(2, true);
+      recorder.beginClause(true);
+      recorder.literal(0, true);
+      recorder.literal(2, false);
+      recorder.endClause(0);
+      recorder.restart();
+      // a clause of user level 1, with its activation literal
+      recorder.push();
+      recorder.beginClause(false);
+      recorder.literal(5, false);
+      recorder.endClause(1);
+      recorder.solved(SAT_VALUE_FALSE);
+      recorder.pop();
+      // the slot of a variable the pop deleted, reused
+      recorder.newVariable(5);
+      recorder.beginClause(false);
+      recorder.literal(5, true);
+      recorder.endClause(0);
+      // the empty clause
+      recorder.beginClause(false);
+      recorder.endClause(0);
+      recorder.solved(SAT_VALUE_FALSE);
+    }
+    string trace = readTrace();
+    TS_ASSERT_EQUALS(trace,
+                     "p inccnf\n"
+                     "1 -2 0\n"
+                     "c d -3\n"
+                     "c l -1 3 0\n"
+                     "c r\n"
+                     "c push 4\n"
+                     "5 -4 0\n"
+                     "c s unsat\n"
+                     "a 4 0\n"
+                     "c pop\n"
+                     "-6 0\n"
+                     "0\n"
+                     "c s unsat\n"
+                     "a 0\n");
+    unsigned solves;
+    TS_ASSERT(isIcnf(trace, solves));
+    TS_ASSERT_EQUALS(solves, 2u);
+  }
+
+  void testSatTraceOption() {
+    {
+      ExprManager em;
+      SmtEngine smt(&em);
+      smt.setOption("incremental", SExpr(true));
+      smt.setOption("sat-trace", SExpr(d_filename));
+      Expr a = em.mkVar("a", em.booleanType());
+      Expr b = em.mkVar("b", em.booleanType());
+      Expr c = em.mkVar("c", em.booleanType());
+      smt.assertFormula(em.mkExpr(kind::OR, a, em.mkExpr(kind::AND, b, c)));
+      smt.push();
+      smt.assertFormula(em.mkExpr(kind::NOT, a));
+      smt.assertFormula(em.mkExpr(kind::NOT, b));
+      TS_ASSERT_EQUALS(smt.checkSat().isSat(), Result::UNSAT);
+      smt.pop();
+      TS_ASSERT_EQUALS(smt.checkSat().isSat(), Result::SAT);
+    }
+    string trace = readTrace();
+    unsigned solves;
+    TS_ASSERT(isIcnf(trace, solves));
+    TS_ASSERT_EQUALS(solves, 2u);
+    TS_ASSERT(trace.find("c s unsat\n") < trace.find("c pop\n"));
+    TS_ASSERT(trace.find("c pop\n") < trace.find("c s sat\n"));
+    // the clauses of the popped level are not active in the second query
+    TS_ASSERT(queriesMatchResults(trace));
+  }
+
+};/* class SatTraceRecorderWhite */
@@ -0,0 +1,177 @@
+/*********************                                                        */
+/*! \file rewrite_cache_white.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of CVC4::theory::RewriteCache.
+ **
+ ** White box testing of CVC4::theory::RewriteCache: hits, the key
+ ** layout, eviction when a probe window is full, invalidation, that its
+ ** entries do not keep nodes alive, and its use by the Rewriter through
+ ** smt::currentRewriteCache().
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <vector>
+
+#include "expr/node.h"
+#include "expr/node_manager.h"
+#include "smt/smt_engine.h"
+#include "smt/smt_engine_scope.h"
+#include "theory/rewrite_cache.h"
+#include "theory/rewriter.h"
+#include "theory/theory.h"
+
+using namespace CVC4;
+using namespace CVC4::theory;
+using namespace CVC4::kind;
+using namespace CVC4::smt;
+using namespace std;
+
+class RewriteCacheWhite : public CxxTest::TestSuite {
+
+  ExprManager* d_em;
+  NodeManager* d_nm;
+  SmtEngine* d_smt;
+  SmtScope* d_scope;
+
+public:
+
+  void setUp() {
+    d_em = new ExprManager();
+    d_nm = NodeManager::fromExprManager(d_em);
+    d_smt = new SmtEngine(d_em);
+    d_scope = new SmtScope(d_smt);
+  }
+
+  void tearDown() {
+    delete d_scope;
+    delete d_smt;
+    delete d_em;
+  }
+
+  void testHitsAndKeys() {
+    RewriteCache rc(64);
+    Node x = d_nm->mkSkolem("x", d_nm->integerType());
+    Node y = d_nm->mkSkolem("y", d_nm->integerType());
+    Node sum = d_nm->mkNode(PLUS, x, y);
+
+    TS_ASSERT(rc.getPostRewrite(THEORY_ARITH, sum).isNull());
+    rc.setPostRewrite(THEORY_ARITH, sum, x);
+    TS_ASSERT_EQUALS(rc.getPostRewrite(THEORY_ARITH, sum), x);
+
+    // the key covers the theory and pre/post as well as the node
+    TS_ASSERT(rc.getPreRewrite(THEORY_ARITH, sum).isNull());
+    TS_ASSERT(rc.getPostRewrite(THEORY_UF, sum).isNull());
+    rc.setPreRewrite(THEORY_ARITH, sum, y);
+    TS_ASSERT_EQUALS(rc.getPreRewrite(THEORY_ARITH, sum), y);
+    TS_ASSERT_EQUALS(rc.getPostRewrite(THEORY_ARITH, sum), x);
+
+    // setting a key again overwrites it in place
+    rc.setPostRewrite(THEORY_ARITH, sum, y);
+    TS_ASSERT_EQUALS(rc.getPostRewrite(THEORY_ARITH, sum), y);
+
+    TS_ASSERT_EQUALS(rc.d_statistics.d_hits.getData(), 4);
+    TS_ASSERT_EQUALS(rc.d_statistics.d_misses.getData(), 3);
+    TS_ASSERT_EQUALS(rc.d_statistics.d_evictions.getData(), 0);
+
+    rc.clear();
+    TS_ASSERT(rc.getPostRewrite(THEORY_ARITH, sum).isNull());
+    TS_ASSERT(rc.getPreRewrite(THEORY_ARITH, sum).isNull());
+  }
+
+  void testEvictionUnderCollisions() {
+    // the smallest cache is a single probe window, so every insertion
+    // past the fourth collides with the others
+    RewriteCache rc(1);
+    TS_ASSERT_EQUALS(rc.d_entries.size(), 4u);
+
+    TypeNode boolType = d_nm->booleanType();
+    vector<Node> keys, values;
+    for (unsigned i = 0; i < 64; ++i)
+    {
+      keys.push_back(d_nm->mkSkolem("k", boolType));
+      values.push_back(d_nm->mkSkolem("v", boolType));
+      rc.setPostRewrite(THEORY_BOOL, keys.back(), values.back());
+      // the latest insertion is always found
+      TS_ASSERT_EQUALS(rc.getPostRewrite(THEORY_BOOL, keys.back()),
+                       values.back());
+    }
+    TS_ASSERT_EQUALS(rc.d_statistics.d_evictions.getData(), 60);
+
+    // an evicted key misses, it never returns another key's value
+    unsigned present = 0;
+    for (unsigned i = 0; i < keys.size(); ++i)
+    {
+      Node cached = rc.getPostRewrite(THEORY_BOOL, keys[i]);
+      TS_ASSERT(cached.isNull() || cached == values[i]);
+      present += cached.isNull() ? 0 : 1;
+    }
+    TS_ASSERT(present > 0);
+    TS_ASSERT(present <= 4);
+  }
+
+  void testClearAll() {
+    RewriteCache first(64), second(64);
+    Node x = d_nm->mkSkolem("x", d_nm->integerType());
+    Node y = d_nm->mkSkolem("y", d_nm->integerType());
+    first.setPostRewrite(THEORY_ARITH, x, y);
+    second.setPostRewrite(THEORY_ARITH, x, y);
+
+    // both caches drop their entries, not just the one cleared by the
+    // Rewriter's own SmtEngine
+    RewriteCache::clearAll();
+    TS_ASSERT(first.getPostRewrite(THEORY_ARITH, x).isNull());
+    TS_ASSERT(second.getPostRewrite(THEORY_ARITH, x).isNull());
+    second.setPostRewrite(THEORY_ARITH, x, y);
+    TS_ASSERT_EQUALS(second.getPostRewrite(THEORY_ARITH, x), y);
+  }
+
+  void testEntriesDoNotPinNodes() {
+    d_smt->finalOptionsAreSet();
+    RewriteCache* rc = currentRewriteCache();
+    Node x = d_nm->mkSkolem("x", d_nm->integerType());
+    Node y = d_nm->mkSkolem("y", d_nm->integerType());
+
+    uint64_t resultId;
+    {
+      Node n = d_nm->mkNode(PLUS, d_nm->mkNode(PLUS, x, y), x);
+      Node r = Rewriter::rewrite(n);
+      TS_ASSERT(r != n);
+      TS_ASSERT_EQUALS(rc->getPostRewrite(Theory::theoryOf(n), n), r);
+      resultId = r.getId();
+    }
+    d_nm->reclaimZombies();
+
+    // once its key is gone, nothing holds the old result: rewriting the
+    // same term again builds it anew, with a fresh id
+    Node n = d_nm->mkNode(PLUS, d_nm->mkNode(PLUS, x, y), x);
+    Node r = Rewriter::rewrite(n);
+    TS_ASSERT(r.getId() != resultId);
+    TS_ASSERT_EQUALS(rc->getPostRewrite(Theory::theoryOf(n), n), r);
+  }
+
+  void testRewriterUsesCurrentCache() {
+    d_smt->finalOptionsAreSet();
+    RewriteCache* rc = currentRewriteCache();
+    TS_ASSERT(rc != NULL);
+
+    Node x = d_nm->mkSkolem("x", d_nm->integerType());
+    Node y = d_nm->mkSkolem("y", d_nm->integerType());
+    Node n = d_nm->mkNode(PLUS, d_nm->mkNode(PLUS, x, y), x);
+    Node r = Rewriter::rewrite(n);
+
+    int64_t hits = rc->d_statistics.d_hits.getData();
+    TS_ASSERT_EQUALS(Rewriter::rewrite(n), r);
+    TS_ASSERT(rc->d_statistics.d_hits.getData() > hits);
+    TS_ASSERT_EQUALS(rc->getPostRewrite(Theory::theoryOf(n), n), r);
+  }
+
+};/* class RewriteCacheWhite */
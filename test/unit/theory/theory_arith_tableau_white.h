@@ -0,0 +1,267 @@
+/*********************                                                        */
+/*! \file theory_arith_tableau_white.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **   agent
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2017 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of the compact layout of the arithmetic Tableau
+ **
+ ** Pivot sequences in the format of Trace("arith::pivot-log") are replayed
+ ** on a Tableau with and without the compact layout, which must agree
+ ** entry for entry and in iteration order.  contrib/tableau-replay.cpp
+ ** times the two layouts on such logs.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "theory/arith/tableau.h"
+#include "util/rational.h"
+
+using namespace CVC4;
+using namespace CVC4::theory::arith;
+using namespace std;
+
+class TheoryArithTableauWhite : public CxxTest::TestSuite {
+
+  /** A deterministic generator, so that failures reproduce */
+  uint32_t d_seed;
+
+  uint32_t next(uint32_t bound)
+  {
+    d_seed = d_seed * 1103515245u + 12345u;
+    return (d_seed >> 8) % bound;
+  }
+
+  static void ensureColumns(Tableau& t, ArithVar v)
+  {
+    t.increaseSizeTo(v + 1);
+  }
+
+  /** Applies one line of a pivot log to t. */
+  static void replayLine(Tableau& t, const string& line)
+  {
+    NoEffectCCCB noEffect;
+    istringstream in(line);
+    string op;
+    in >> op;
+    if (op == "row")
+    {
+      ArithVar basic;
+      in >> basic;
+      ensureColumns(t, basic);
+      vector<ArithVar> variables;
+      vector<Rational> coefficients;
+      ArithVar v;
+      string c;
+      while (in >> v >> c)
+      {
+        ensureColumns(t, v);
+        variables.push_back(v);
+        coefficients.push_back(Rational(c));
+      }
+      t.addRow(basic, coefficients, variables);
+    }
+    else if (op == "pivot")
+    {
+      ArithVar oldBasic, newBasic;
+      in >> oldBasic >> newBasic;
+      t.pivot(oldBasic, newBasic, noEffect);
+    }
+    else if (op == "substitute")
+    {
+      ArithVar to, from;
+      string mult;
+      in >> to >> from >> mult;
+      t.substitutePlusTimesConstant(to, from, Rational(mult), noEffect);
+    }
+    else if (op == "add")
+    {
+      ArithVar row, col;
+      string mult;
+      in >> row >> col >> mult;
+      ensureColumns(t, col);
+      t.directlyAddToCoefficient(row, col, Rational(mult), noEffect);
+    }
+    else if (op == "remove")
+    {
+      ArithVar basic;
+      in >> basic;
+      t.removeBasicRow(basic);
+    }
+  }
+
+  static void replay(Tableau& t, const vector<string>& log)
+  {
+    for (size_t i = 0; i < log.size(); ++i)
+    {
+      replayLine(t, log[i]);
+    }
+  }
+
+  /** Adds a random row for basic over the variables below numVars. */
+  void randomRow(Tableau& t, ArithVar basic, ArithVar numVars,
+                 vector<string>& log)
+  {
+    ostringstream line;
+    line << "row " << basic;
+    vector<bool> used(numVars, false);
+    for (unsigned k = 0, K = 2 + next(5); k < K; ++k)
+    {
+      ArithVar v = next(numVars);
+      if (v == basic || used[v] || t.isBasic(v))
+      {
+        continue;
+      }
+      used[v] = true;
+      int c = int(next(19)) - 9;
+      line << " " << v << " " << (c == 0 ? 1 : c);
+    }
+    log.push_back(line.str());
+    replayLine(t, log.back());
+  }
+
+  /**
+   * Builds numRows rows over numVars variables and records numPivots
+   * random pivots, with the occasional row removed and added back.
+   */
+  vector<string> randomLog(unsigned numRows, unsigned numVars,
+                           unsigned numPivots)
+  {
+    Tableau t;
+    vector<string> log;
+    vector<ArithVar> basics;
+    for (unsigned r = 0; r < numRows; ++r)
+    {
+      basics.push_back(numVars + r);
+      randomRow(t, numVars + r, numVars, log);
+    }
+    for (unsigned p = 0; p < numPivots; ++p)
+    {
+      unsigned which = next(basics.size());
+      ArithVar b = basics[which];
+      if (next(20) == 0)
+      {
+        ostringstream line;
+        line << "remove " << b;
+        log.push_back(line.str());
+        replayLine(t, log.back());
+        randomRow(t, b, numVars, log);
+        continue;
+      }
+      vector<ArithVar> candidates;
+      for (Tableau::RowIterator i = t.basicRowIterator(b); !i.atEnd(); ++i)
+      {
+        if ((*i).getColVar() != b)
+        {
+          candidates.push_back((*i).getColVar());
+        }
+      }
+      if (candidates.empty())
+      {
+        continue;
+      }
+      ArithVar e = candidates[next(candidates.size())];
+      ostringstream line;
+      line << "pivot " << b << " " << e;
+      log.push_back(line.str());
+      replayLine(t, log.back());
+      basics[which] = e;
+    }
+    return log;
+  }
+
+  /** Whether a and b have the same rows and columns, in the same order. */
+  static bool sameTableau(const Tableau& a, const Tableau& b)
+  {
+    if (a.getNumColumns() != b.getNumColumns() || a.size() != b.size())
+    {
+      return false;
+    }
+    for (Tableau::BasicIterator i = a.beginBasic(); i != a.endBasic(); ++i)
+    {
+      ArithVar basic = *i;
+      if (!b.isBasic(basic))
+      {
+        return false;
+      }
+      Tableau::RowIterator ai = a.basicRowIterator(basic);
+      Tableau::RowIterator bi = b.basicRowIterator(basic);
+      for (; !ai.atEnd() && !bi.atEnd(); ++ai, ++bi)
+      {
+        if ((*ai).getColVar() != (*bi).getColVar()
+            || (*ai).getCoefficient() != (*bi).getCoefficient())
+        {
+          return false;
+        }
+      }
+      if (!ai.atEnd() || !bi.atEnd())
+      {
+        return false;
+      }
+    }
+    for (ArithVar v = 0; v < a.getNumColumns(); ++v)
+    {
+      Tableau::ColIterator ai = a.colIterator(v);
+      Tableau::ColIterator bi = b.colIterator(v);
+      for (; !ai.atEnd() && !bi.atEnd(); ++ai, ++bi)
+      {
+        if (a.rowIndexToBasic((*ai).getRowIndex())
+            != b.rowIndexToBasic((*bi).getRowIndex()))
+        {
+          return false;
+        }
+      }
+      if (!ai.atEnd() || !bi.atEnd())
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ public:
+  void setUp() { d_seed = 42; }
+
+  void testCompactKeepsOrder()
+  {
+    vector<string> log = randomLog(30, 50, 400);
+    Tableau plain, compact;
+    compact.setCompactLayout(true);
+    for (size_t i = 0; i < log.size(); ++i)
+    {
+      replayLine(plain, log[i]);
+      replayLine(compact, log[i]);
+      TS_ASSERT(sameTableau(plain, compact));
+    }
+    TS_ASSERT(compact.getNumCompactions() > 0);
+    TS_ASSERT_EQUALS(plain.getNumCompactions(), 0u);
+  }
+
+  void testCompactIsContiguous()
+  {
+    vector<string> log = randomLog(20, 40, 200);
+    Tableau t;
+    replay(t, log);
+    Tableau copy = t;
+    t.compact();
+    TS_ASSERT(sameTableau(t, copy));
+    for (Tableau::BasicIterator i = t.beginBasic(); i != t.endBasic(); ++i)
+    {
+      Tableau::RowIterator ri = t.basicRowIterator(*i);
+      EntryID expected = ri.getID();
+      for (; !ri.atEnd(); ++ri, ++expected)
+      {
+        TS_ASSERT_EQUALS(ri.getID(), expected);
+      }
+    }
+  }
+};
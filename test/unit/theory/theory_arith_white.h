@@ -24,7 +24,9 @@
 #include "expr/node_manager.h"
 #include "smt/smt_engine.h"
 #include "smt/smt_engine_scope.h"
+#include "theory/arith/gomory_cut.h"
 #include "theory/arith/theory_arith.h"
+#include "theory/arith/theory_arith_private.h"
 #include "theory/quantifiers_engine.h"
 #include "theory/theory.h"
 #include "theory/theory_engine.h"
@@ -317,4 +319,49 @@ public:
     TS_ASSERT_EQUALS(Rewriter::rewrite(leq0), Rewriter::rewrite(geq1.notNode()));
     TS_ASSERT_EQUALS(Rewriter::rewrite(leq1), Rewriter::rewrite(geq2.notNode()));
   }
+
+  void testGomoryCutFromRow() {
+    // y first, so that it leads the normal form of the sum
+    Node y = d_nm->mkVar(*d_intType);
+    Node x = d_nm->mkVar(*d_intType);
+    Node c0 = d_nm->mkConst<Rational>(d_zero);
+    Node c2 = d_nm->mkConst<Rational>(Rational(2));
+    Node c3 = d_nm->mkConst<Rational>(Rational(3));
+
+    // x >= 0 and 2y - x >= 3: the relaxation can only pivot y in for the
+    // slack s of 2y - x, giving the row y = s/2 + x/2 with y = 3/2
+    Node xGeq0 = Rewriter::rewrite(d_nm->mkNode(GEQ, x, c0));
+    Node sGeq3 = Rewriter::rewrite(d_nm->mkNode(
+        GEQ, d_nm->mkNode(MINUS, d_nm->mkNode(MULT, c2, y), x), c3));
+    fakeTheoryEnginePreprocess(xGeq0);
+    fakeTheoryEnginePreprocess(sGeq3);
+
+    d_arith->presolve();
+    d_arith->assertFact(xGeq0, true);
+    d_arith->assertFact(sGeq3, true);
+    d_arith->check(Theory::EFFORT_STANDARD);
+
+    TheoryArithPrivate* internal = d_arith->d_internal;
+    const ArithVariables& vars = internal->d_partialModel;
+    const Tableau& tableau = internal->d_tableau;
+    TS_ASSERT(sGeq3.getKind() == GEQ && vars.hasArithVar(sGeq3[0]));
+    ArithVar xv = vars.asArithVar(x);
+    ArithVar yv = vars.asArithVar(y);
+    ArithVar sv = vars.asArithVar(sGeq3[0]);
+    TS_ASSERT(tableau.isBasic(yv));
+    TS_ASSERT_EQUALS(vars.getAssignment(yv), DeltaRational(Rational(3, 2)));
+
+    // Both non-basic variables are integral at integral lower bounds with
+    // alpha = -1/2, so both get pi = 1: s + x >= 3 + 1, which the
+    // assignment violates, and which is y >= 2 over x and y
+    GomoryCutGenerator generator(vars, tableau);
+    DenseVector cut;
+    ConstraintCPVec exp;
+    TS_ASSERT(generator.cutFromRow(yv, cut, exp));
+    TS_ASSERT_EQUALS(cut.lhs.size(), 2u);
+    TS_ASSERT_EQUALS(cut.lhs[sv], Rational(1));
+    TS_ASSERT_EQUALS(cut.lhs[xv], Rational(1));
+    TS_ASSERT_EQUALS(cut.rhs, Rational(4));
+    TS_ASSERT_EQUALS(exp.size(), 2u);
+  }
 };
@@ -556,4 +556,29 @@ public:
       }
     }
   }
+
+  void testSmallBoundary()
+  {
+    /* Values around 2^63 cross between the inline and the GMP form */
+    Integer max("9223372036854775807");
+    Integer min("-9223372036854775808");
+    Integer one(1);
+    TS_ASSERT_EQUALS((max + one).toString(), "9223372036854775808");
+    TS_ASSERT_EQUALS(max + one - one, max);
+    TS_ASSERT_EQUALS((min - one).toString(), "-9223372036854775809");
+    TS_ASSERT_EQUALS(-min, max + one);
+    TS_ASSERT_EQUALS(-(-min), min);
+    TS_ASSERT_EQUALS((max * max).toString(),
+                     "85070591730234615847396907784232501249");
+    TS_ASSERT_EQUALS((max * max).exactQuotient(max), max);
+    TS_ASSERT_EQUALS(min.abs().toString(), "9223372036854775808");
+    TS_ASSERT_EQUALS(min.floorDivideQuotient(Integer(-1)), max + one);
+    TS_ASSERT_EQUALS(min.gcd(max + one), max + one);
+    TS_ASSERT_EQUALS(one.multiplyByPow2(63), max + one);
+    TS_ASSERT_EQUALS(one.multiplyByPow2(63).hash(), (max + one).hash());
+    TS_ASSERT(max < max + one);
+    TS_ASSERT(min - one < min);
+    TS_ASSERT(!(max + one).fitsSignedLong());
+    TS_ASSERT(min.fitsSignedLong());
+  }
 };
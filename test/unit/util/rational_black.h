@@ -44,4 +44,23 @@ public:
     TS_ASSERT_THROWS( Rational::fromDecimal("Hello, world!");, const std::invalid_argument& );
   }
 
+  void testSmallBoundary() {
+    /* Numerators and denominators around 2^63 cross between the inline
+     * and the GMP form */
+    Rational max(Integer("9223372036854775807"));
+    Rational big(Integer("9223372036854775808"));
+    Rational half(1, 2);
+    TS_ASSERT_EQUALS( max + Rational(1), big );
+    TS_ASSERT_EQUALS( (big - Rational(1)).toString(), "9223372036854775807" );
+    TS_ASSERT_EQUALS( (half / big).toString(), "1/18446744073709551616" );
+    TS_ASSERT_EQUALS( (half / big) * big, half );
+    TS_ASSERT_EQUALS( (max / big).getDenominator(), big.getNumerator() );
+    TS_ASSERT_EQUALS( (max / big).inverse() * (max / big), Rational(1) );
+    TS_ASSERT_EQUALS( (max * max / max).hash(), max.hash() );
+    TS_ASSERT( max / big < Rational(1) );
+    TS_ASSERT( max.isIntegral() && !(max / big).isIntegral() );
+    TS_ASSERT_EQUALS( (big + half).floor(), big.getNumerator() );
+    TS_ASSERT_EQUALS( (-big - half).ceiling(), -big.getNumerator() );
+  }
+
 };
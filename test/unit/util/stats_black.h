@@ -21,6 +21,7 @@
 #include <string>
 
 #include "lib/clock_gettime.h"
+#include "util/statistics_export.h"
 #include "util/statistics_registry.h"
 
 using namespace CVC4;
@@ -180,4 +181,44 @@ public:
 #endif /* CVC4_STATISTICS_ON */
   }
 
+  void testExport() {
+    StatisticsExporter exporter;
+    exporter.add("count", SExpr(Integer(42)));
+    exporter.add("neg", SExpr(Integer(-3)));
+    exporter.add("ratio", SExpr(Rational(1, 2)));
+    exporter.add("flag", SExpr(SExpr::Keyword("true")));
+    exporter.add("say \"hi\"", SExpr(std::string("a\nb")));
+
+    stringstream json;
+    exporter.writeJson(json);
+    TS_ASSERT_EQUALS(json.str(),
+                     "{\"count\": 42, \"neg\": -3, \"ratio\": 0.5, "
+                     "\"flag\": true, \"say \\\"hi\\\"\": \"a\\nb\"}");
+
+    stringstream binary;
+    exporter.clear();
+    exporter.add("x", SExpr(Integer(300)));
+    exporter.add("y", SExpr(Integer(-1)));
+    exporter.write(binary, STATS_EXPORT_BINARY);
+    const char expected[] = "CVC4STB1\x02\x01x" "i\xac\x02\x01y" "n\x01";
+    TS_ASSERT_EQUALS(binary.str(), string(expected, sizeof(expected) - 1));
+  }
+
+  void testExportOutOfDoubleRange() {
+    // 10^400 and -10^400/3 overflow a double
+    string big = "1" + string(400, '0');
+    StatisticsExporter exporter;
+    exporter.add("big", SExpr(Rational(Integer(big))));
+    exporter.add("small", SExpr(Rational(Integer("-" + big), Integer(3))));
+    exporter.add("ratio", SExpr(Rational(-1, 4)));
+
+    stringstream json;
+    exporter.writeJson(json);
+    TS_ASSERT_EQUALS(json.str(),
+                     "{\"big\": \"" + big + "\", \"small\": \"-" + big
+                         + "/3\", \"ratio\": -0.25}");
+    TS_ASSERT(json.str().find("inf") == string::npos);
+    TS_ASSERT(json.str().find("nan") == string::npos);
+  }
+
 };